@@ -94,8 +94,6 @@ killTrj=$trjDir/"kill.trj"
 # We need to append to these trj
 if [ -e $searchTrj ]; then rm $searchTrj; echo "rm $searchTrj"; fi
 if [ -e $killTrj ]; then rm $killTrj; echo "rm $killTrj"; fi
-if [ -e $searchTrj.weight ]; then rm $searchTrj.weight; fi
-if [ -e $killTrj.weight ]; then rm $killTrj.weight; fi
 
 if ! [ -d $resultDir/$data/$experiment ]; 
   then mkdir -p $resultDir/$data/$experiment
@@ -140,7 +138,7 @@ for prob in `ls $datDir | sort -R`; do
       echo "    ---->" done $base $nlines_sol "continue"
     # 当前例子预求解未找到最优可行解，用oracle策略收集trjs
     else
-      $executable -t $timelimit -s $set -f $prob -o $sol --nodesel oracle --nodeseltrj $searchTrjIter > $resultDir/$data/$experiment/$base.log
+      $executable -t $timelimit -s $set -f $prob -o $sol --nodesel oracle --nodeseltrj $searchTrjIter --aio --evtlog $resultDir/$data/$experiment/$base.evt > $resultDir/$data/$experiment/$base.log
       echo "    ---->" done $base
     fi
 
@@ -23,6 +23,7 @@ from xml.dom.minicompat import NodeList
 from grpc import insecure_channel
 from xgboost import train
 from utils import *
+from trj_store import ShardWriter
 from get_scip_node import InstanceFile
 from get_scip_node import Node
 
@@ -31,6 +32,7 @@ class TrjDataMulti():
     def __init__(self, trj_file_path, instance_file_obj, topk=100):
         self.lines = open("%s" % trj_file_path).readlines()
         self.instance_file_obj = instance_file_obj
+        self.node_labels = {}
         # self.instance_serial_number = trj_file_path.split("/")[-1].split("_")[1].split(".")[0]
     
     def cut(self, obj, sec):
@@ -105,6 +107,15 @@ class TrjDataMulti():
         # input()
         return node_label
 
+    def node_label(self, node_idx):
+        """
+        节点标签只与分支历史有关，同一节点只判断一次
+        :param node_idx
+        """
+        if node_idx not in self.node_labels:
+            self.node_labels[node_idx] = self.node_check_optimal(node_idx)
+        return self.node_labels[node_idx]
+
     def gen_pqlist(self, line, group_id=0, is_pure=True):
         """
         将trj文件中一行内容转为list，每FEATURE_SIZE个元素是一个节点的信息
@@ -113,8 +124,18 @@ class TrjDataMulti():
         """
         FEATURE_SIZE = 22
         line = line.strip(" \n").split(" ")
+        # 记录头：label w:<weight> d:<depth bucket> b:<boundtype>
+        if len(line) > 0 and ":" not in line[0]:
+            line = line[1:]
+        meta = {}
         try:
-            feats = [float(a.split(":")[1]) for a in line] # 22 * nnodes
+            feats = []
+            for a in line:
+                key, value = a.split(":")
+                if key.isdigit():
+                    feats.append(float(value)) # 22 * nnodes
+                else:
+                    meta[key] = float(value)
         except:
             logging.info("gen_pqlist %s: ", list_to_str(line))
             return -1
@@ -137,7 +158,8 @@ class TrjDataMulti():
                 record_node["idx"] = int(feat[0])
                 record_node["groupID"] = int(feat[1]) # 暂时不用，但先收�?
                 record_node["feats"] = feat[2:]
-                record_node["label"] = self.node_check_optimal(record_node["idx"])
+                record_node["weight"] = meta.get("w", 1.0)
+                record_node["label"] = self.node_label(record_node["idx"])
                 pqlist.append(record_node)
             except:
                 print("TrjDataMulti-gen_pqlist: wrong feats ")
@@ -147,6 +169,68 @@ class TrjDataMulti():
 
         return pqlist
     
+    def gen_dedup_pqlists(self):
+        """
+        解析节点去重格式的trj文件(见src/trjsink.c)：
+            h <size> <全局特征下标>
+            n <nodeID> <label> <weight> <depth bucket> <boundtype> <局部特征>
+                                        节点第一次出现或特征变化时写入
+            g <groupID> <全局特征> | <nodeID> ...
+        :return: pqlists，每个group一个list
+        """
+        pqlists = []
+        node_feats = {}
+        node_weights = {}
+        size = 0
+        global_idx = []
+        local_idx = []
+        for line in self.lines:
+            tokens = line.split()
+            if len(tokens) == 0:
+                continue
+            if tokens[0] == "h":
+                # 每次求解重新写header，节点编号从头开始
+                size = int(tokens[1])
+                global_idx = [int(a) for a in tokens[2:]]
+                local_idx = [i for i in range(size) if i not in global_idx]
+                node_feats = {}
+                node_weights = {}
+            elif tokens[0] == "n":
+                node_weights[int(tokens[1])] = float(tokens[3])
+                node_feats[int(tokens[1])] = [float(a) for a in tokens[6:]]
+            elif tokens[0] == "g":
+                group_id = int(tokens[1])
+                sep = tokens.index("|")
+                global_vals = [float(a) for a in tokens[2:sep]]
+                pqlist = []
+                for a in tokens[sep+1:]:
+                    node_idx = int(a)
+                    # TODO: 有些节点在log中没有，在trj中有，构造这类节点时暂时跳过
+                    if node_idx >= self.instance_file_obj.max_node_number:
+                        continue
+                    feats = [0.0] * size
+                    for i, v in zip(local_idx, node_feats[node_idx]):
+                        feats[i] = v
+                    for i, v in zip(global_idx, global_vals):
+                        feats[i] = v
+                    record_node = {}
+                    record_node["idx"] = node_idx
+                    record_node["groupID"] = group_id
+                    record_node["feats"] = feats
+                    record_node["weight"] = node_weights[node_idx]
+                    record_node["label"] = self.node_label(node_idx)
+                    pqlist.append(record_node)
+                pqlists.append(pqlist)
+        return pqlists
+
+    def gen_pqlists(self):
+        """
+        根据trj文件格式生成所有group
+        """
+        if len(self.lines) > 0 and self.lines[0].startswith("h "):
+            return self.gen_dedup_pqlists()
+        return [pqlist for pqlist in map(self.gen_pqlist, self.lines) if pqlist != -1] # 一行是一个pq_list，有多个节点
+
     def write_list_to_json(self, nodelist, json_file_name, json_file_save_path):
         """
         将list写入json
@@ -175,13 +259,17 @@ class TrjDataMulti():
             pickle.dump(nodelist, f)
             f.close()
     
-    def extract_trjs(self, files_dict, save_path):
-        pqlists = [self.gen_pqlist(line) for line in self.lines if self.gen_pqlist(line) != -1] # 一行是一个pq_list，有多个节点
+    def extract_trjs(self, shard_writer, instance_name):
+        """
+        将当前instance的所有节点记录写入分片存储
+        :param shard_writer: ShardWriter
+        :param instance_name
+        """
+        pqlists = self.gen_pqlists()
         records = list(itertools.chain.from_iterable(pqlists))
-        self.write_list_to_json(records, files_dict["json"], save_path)
-        self.write_list_to_pickle(records, files_dict["pickle"], save_path)
+        shard_writer.add_instance(instance_name, records)
         
-def get_all_trjs_to_json(dat_dir, trj_dir, log_dir, files_name, files_save_path, first_k = 5000):
+def get_all_trjs_to_json(dat_dir, trj_dir, log_dir, shard_writer, first_k = 5000):
 
     tmp_list = []
     tmp_list_gt1 = []
@@ -226,7 +314,7 @@ def get_all_trjs_to_json(dat_dir, trj_dir, log_dir, files_name, files_save_path,
         # 3-把有正样本的trj文件中所有节点属性存成json格式（根据Opt-primal Node标记节点标签�?
         if best_primalbound_nodelist_len > 0:
             trj_data_multi = TrjDataMulti(trj_path, instance_file_obj)
-            trj_data_multi.extract_trjs(files_name, files_save_path)
+            trj_data_multi.extract_trjs(shard_writer, base)
         
     try:
         logging.info("mean all sols length %d" % int(sum(tmp_list)/len(tmp_list)))
@@ -293,16 +381,9 @@ if __name__ == "__main__":
     trj_dir = os.path.join(trj_dir_base, dat_name, experiment)
     log_dir = os.path.join(log_dir_base, dat_name, experiment)
 
-    # TODO:每100个instance存一个文件，或者每个instance存一个数据文件
+    # 每100个instance存一个分片，分片末尾保存各instance的索引
     log_file_name = "./make_data_files/collect_trjs_logs/" + now_time + ".log"
-    train_file_save_path = os.path.join(trj_dir, "train_pickle_json")
-    os.makedirs(train_file_save_path, exist_ok=True)
-    
-    train_files_save_name = {}
-    json_file_name = now_time + "_nodelist.json"
-    pickle_file_name = now_time + "_nodelist.pickle"
-    train_files_save_name["json"] = json_file_name
-    train_files_save_name["pickle"] = pickle_file_name
+    train_file_save_path = os.path.join(trj_dir, "train_shards", now_time + "_nodelist")
     
     logging.basicConfig(
         filename=log_file_name,
@@ -311,7 +392,7 @@ if __name__ == "__main__":
         filemode="w",
         datefmt='%m/%d/%Y %I:%M:%S'
     )
-    print(train_files_save_name)
     print(train_file_save_path)
     
-    get_all_trjs_to_json(dat_dir, trj_dir, log_dir, train_files_save_name, train_file_save_path)
+    with ShardWriter(train_file_save_path, now_time + "_nodelist", instances_per_shard=100) as shard_writer:
+        get_all_trjs_to_json(dat_dir, trj_dir, log_dir, shard_writer)
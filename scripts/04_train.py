@@ -2,7 +2,7 @@
 # 读取整理好的trj文件并训练
 # =======================
 
-# 使用示例：(python ./scripts/04_train.py -t cauctions -d train2-0_200_1000 -e 0601_scip3_afsb_oracle_11_12 --train_file_path ~/daggerSpace/training_files/scip-dagger/clip-scratch/training/trj/cauctions/train2-0_200_1000/0601_scip3_afsb_oracle_11_12/train_pickle_json/2022-06-20-16-03_nodelist.pickle
+# 使用示例：(python ./scripts/04_train.py -t cauctions -d train2-0_200_1000 -e 0601_scip3_afsb_oracle_11_12 --train_file_path ~/daggerSpace/training_files/scip-dagger/clip-scratch/training/trj/cauctions/train2-0_200_1000/0601_scip3_afsb_oracle_11_12/train_shards/2022-06-20-16-03_nodelist
 
 
 import os
@@ -15,6 +15,7 @@ from matplotlib.pyplot import flag
 import numpy as np
 import xgboost as xgb
 from itertools import groupby
+from trj_store import TrjStore
 import pdb
 # ins 28
 def read_json(json_file):
@@ -87,13 +88,34 @@ def make_pairwise_data(trjs):
 
     return rank_feats, rank_label, rank_group
 
-def read_pickle_train(pickle_file, trained_models_path):
+def iter_instance_trjs(train_file):
     """
-    解析pickle文件，划分训练测试数据集
-    :param pickle_file
+    按instance依次返回trjs，支持分片存储目录和旧的pickle文件
+    :param train_file: 分片目录/分片文件 或 pickle文件
     """
-    # TODO: 还不会给pickle文件追加数据
-    print("read pickle")
+    if train_file.endswith(".pickle"):
+        with open(train_file, 'rb') as f:
+            while True:
+                try:
+                    yield pickle.load(f)
+                except EOFError:
+                    break
+        return
+
+    store = TrjStore(train_file)
+    for name in store.names:
+        # 根据索引跳过没有正样本的instance，无需读取数据
+        if store.instances[name]["npos"] == 0:
+            continue
+        yield store.read_instance(name)
+    store.close()
+
+def read_pickle_train(train_file, trained_models_path):
+    """
+    读取整理好的trj数据，按instance划分训练测试数据集
+    :param train_file: 分片目录/分片文件 或 pickle文件
+    """
+    print("read trjs")
 
     sum_ins = 0
     flag = True
@@ -131,10 +153,10 @@ def read_pickle_train(pickle_file, trained_models_path):
         verbosity=0
         )
     
-    pickle_file_name = pickle_file.split('/')[-1].split('.')[0]
+    train_file_name = os.path.basename(os.path.normpath(train_file)).split('.')[0]
     cur_model_dir = os.path.join(
         trained_models_path, 
-        pickle_file_name, 
+        train_file_name, 
         "insL"+str(train_ins_length)+\
         "_trjL"+str(train_trj_length)[0]+\
         'e'+str(int(math.log10(train_trj_length)))
@@ -143,89 +165,82 @@ def read_pickle_train(pickle_file, trained_models_path):
     if os.path.isdir(cur_model_dir) == False:
         os.makedirs(cur_model_dir, exist_ok=False)
     iter = 0
-    with open(pickle_file, 'rb') as f:
-        while True:
-            print("iter %d debug" % iter)
-            iter += 1
-            try:
-                instance_trjs = []
-                instance_trjs = pickle.load(f)
-                ins_feats, ins_label, ins_group = make_pairwise_data(instance_trjs)
-                
-                try:
-                    assert len(ins_feats) != 0
-                except:
-                    # 当前实例中未收集到trjs，跳过
-                    print("empty or negative trjs")
-                    continue
-            except EOFError:
-                break
+    for instance_trjs in iter_instance_trjs(train_file):
+        print("iter %d debug" % iter)
+        iter += 1
+        ins_feats, ins_label, ins_group = make_pairwise_data(instance_trjs)
+        
+        try:
+            assert len(ins_feats) != 0
+        except:
+            # 当前实例中未收集到trjs，跳过
+            print("empty or negative trjs")
+            continue
 
-            sum_ins += 1
-            # collect test data
-            if sum_ins < test_ins_length and len(test_rank_feats) < test_trj_length:
-                test_rank_feats.extend(ins_feats)
-                test_rank_label.extend(ins_label)
-                test_rank_group.extend(ins_group)
-                print("test: cur_ins(%d) total(%d) cur(%d)" % \
-                        (sum_ins, len(test_rank_feats), len(ins_feats) ))
-            # collect train data
-            else:
-                # assignment test data
-                if flag == True:
-                    flag = False
+        sum_ins += 1
+        # collect test data
+        if sum_ins < test_ins_length and len(test_rank_feats) < test_trj_length:
+            test_rank_feats.extend(ins_feats)
+            test_rank_label.extend(ins_label)
+            test_rank_group.extend(ins_group)
+            print("test: cur_ins(%d) total(%d) cur(%d)" % \
+                    (sum_ins, len(test_rank_feats), len(ins_feats) ))
+        # collect train data
+        else:
+            # assignment test data
+            if flag == True:
+                flag = False
 
-                    test_X, test_Y, test_group =   \
-                        np.array(test_rank_feats), \
-                        np.array(test_rank_label), \
-                        test_rank_group
-                    
-                sum_train_ins += 1
-                batch_train_rank_feats.extend(ins_feats)
-                batch_train_rank_label.extend(ins_label)
-                batch_train_rank_group.extend(ins_group)
-                print("train: iter(%d) cur_ins(%d) cur_ins(%d) total(%d) cur(%d)" % \
-                        (train_iter, sum_ins, sum_train_ins, len(batch_train_rank_feats), len(ins_feats) ))
-            # train data
-            if sum_train_ins == train_ins_length or len(batch_train_rank_feats) > train_trj_length:
-                model_name = "searchPolicy."+str(train_iter) + ".bin"
-                cur_model_path = os.path.join(cur_model_dir, model_name)
+                test_X, test_Y, test_group =   \
+                    np.array(test_rank_feats), \
+                    np.array(test_rank_label), \
+                    test_rank_group
                 
-                train_X, train_Y, train_group =         \
-                    np.array(batch_train_rank_feats),   \
-                    np.array(batch_train_rank_label),   \
-                    batch_train_rank_group
+            sum_train_ins += 1
+            batch_train_rank_feats.extend(ins_feats)
+            batch_train_rank_label.extend(ins_label)
+            batch_train_rank_group.extend(ins_group)
+            print("train: iter(%d) cur_ins(%d) cur_ins(%d) total(%d) cur(%d)" % \
+                    (train_iter, sum_ins, sum_train_ins, len(batch_train_rank_feats), len(ins_feats) ))
+        # train data
+        if sum_train_ins == train_ins_length or len(batch_train_rank_feats) > train_trj_length:
+            model_name = "searchPolicy."+str(train_iter) + ".bin"
+            cur_model_path = os.path.join(cur_model_dir, model_name)
+            
+            train_X, train_Y, train_group =         \
+                np.array(batch_train_rank_feats),   \
+                np.array(batch_train_rank_label),   \
+                batch_train_rank_group
     
-                try:
-                    if pre_model_path == "":
-                        model.fit(
-                            train_X, 
-                            train_Y, 
-                            group=train_group, 
-                            verbose=True, 
-                            eval_set=[(train_X, train_Y),(test_X, test_Y)], 
-                            eval_group=[train_group,test_group]
+            try:
+                if pre_model_path == "":
+                    model.fit(
+                        train_X, 
+                        train_Y, 
+                        group=train_group, 
+                        verbose=True, 
+                        eval_set=[(train_X, train_Y),(test_X, test_Y)], 
+                        eval_group=[train_group,test_group]
+                    )
+                else:
+                    model.fit(
+                        train_X, train_Y, 
+                        group=train_group, 
+                        verbose=True, 
+                        eval_set=[(train_X, train_Y),(test_X, test_Y)], 
+                        eval_group=[train_group,test_group], 
+                        xgb_model=pre_model_path
                         )
-                    else:
-                        model.fit(
-                            train_X, train_Y, 
-                            group=train_group, 
-                            verbose=True, 
-                            eval_set=[(train_X, train_Y),(test_X, test_Y)], 
-                            eval_group=[train_group,test_group], 
-                            xgb_model=pre_model_path
-                            )
-                except:
-                    print("mode.fit error")
-                model.save_model(cur_model_path)
+            except:
+                print("mode.fit error")
+            model.save_model(cur_model_path)
 
-                train_iter += 1
-                sum_train_ins = 0
-                pre_model_path = cur_model_path
-                batch_train_rank_feats = []
-                batch_train_rank_label = []
-                batch_train_rank_group = []
-        f.close()
+            train_iter += 1
+            sum_train_ins = 0
+            pre_model_path = cur_model_path
+            batch_train_rank_feats = []
+            batch_train_rank_label = []
+            batch_train_rank_group = []
     
 if __name__ == "__main__":
     parser = argparse.ArgumentParser()
@@ -249,7 +264,7 @@ if __name__ == "__main__":
     )
     parser.add_argument(
        '--train_file_path',
-       help='train_file_path (pickle path)',
+       help='train_file_path (trj shards dir or pickle path)',
        type=str,
        default='',
     )
@@ -287,7 +302,7 @@ if __name__ == "__main__":
     dat_type = args.dat_type
     experiment = args.experiment
     train_file_path = args.train_file_path  # 训练所需的整理好的trj文件所在位置（注意，是经过make_data脚本处理过的trj文件）
-                                            # 例：~/daggerSpace/training_files/scip-dagger/clip-scratch/training/trj/cauctions/train2-0_200_1000/0601_scip3_afsb_oracle_11_12/train_pickle_json/2022-06-20-16-03_nodelist.pickle
+                                            # 例：~/daggerSpace/training_files/scip-dagger/clip-scratch/training/trj/cauctions/train2-0_200_1000/0601_scip3_afsb_oracle_11_12/train_shards/2022-06-20-16-03_nodelist
 
     trained_model_path = os.path.join(
         training_base,
@@ -47,6 +47,9 @@ def run_diff_policy(dat_dir, sol_dir, policy_dir, result_dir, set_path, exe="bin
             s_path = os.path.join(sol_dir, f'{base}.sol')                   # SOL文件位置
             r_policy_dir = os.path.join(result_dir, f'policy.{numPolicy}')  # LOG日志文件夹
             r_path = os.path.join(r_policy_dir, f'{base}.log')              # 当前实例的日志文件位置
+            e_path = os.path.join(r_policy_dir, f'{base}.evt')              # 当前实例的二进制事件日志位置
+            t_path = os.path.join(r_policy_dir, f'{base}.stats')            # 当前实例的分阶段耗时统计位置
+            q_path = os.path.join(r_policy_dir, f'{base}.tsmp')             # 当前实例的开放节点队列采样位置
             
             # 判断日志路径是否存在，若不存在创建新的文件夹
             if os.path.isdir(r_policy_dir) == False:
@@ -54,7 +57,7 @@ def run_diff_policy(dat_dir, sol_dir, policy_dir, result_dir, set_path, exe="bin
             
             # run scipdagger
             try:
-                os.system("bin/scipdagger-0622 -t %d -f %s -s %s -o %s --nodesel dagger %s > %s" % (timelimit, f_path, set_path, s_path, p_path, r_path))
+                os.system("bin/scipdagger-0622 -t %d -f %s -s %s -o %s --nodesel dagger %s --evtlog %s --stats %s --treesample %s > %s" % (timelimit, f_path, set_path, s_path, p_path, e_path, t_path, q_path, r_path))
             except KeyboardInterrupt:
                 print("numpolicy %d %d %s stopped" % (numPolicy, j, ins_file))
                 continue
@@ -80,12 +83,13 @@ def run_scip(dat_dir, sol_dir, policy_dir, result_dir, set_path, exe="collect_mu
             f_path = os.path.join(dat_dir, ins_file)
             s_path = os.path.join(sol_dir, f'{base}.sol')
             r_path = os.path.join(result_dir, f'{base}.log')
+            e_path = os.path.join(result_dir, f'{base}.evt')
 
             if dagger == "scip":
                 os.system("bin/scipdagger-0622 -t %d -f %s -s %s > %s" % (timelimit, f_path, set_path, r_path))
             # 策略Oracle
             else:
-                os.system("bin/scipdagger-0622 -t %d -f %s -s %s -o %s --nodesel oracle > %s" % (timelimit, f_path, set_path, s_path, r_path))              
+                os.system("bin/scipdagger-0622 -t %d -f %s -s %s -o %s --nodesel oracle --evtlog %s > %s" % (timelimit, f_path, set_path, s_path, e_path, r_path))              
         except KeyboardInterrupt:
             sys.exit()
 
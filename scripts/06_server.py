@@ -23,6 +23,7 @@ from type_definitions import *
 # 每隔一段时间更新模型参�?
 
 FEATURE_SIZE = 20
+PRUNE_FEATURE_SIZE = 16
 
 def receive_from_c(client):
     message, mtype = client["receiver"].receive()
@@ -30,25 +31,34 @@ def receive_from_c(client):
     # print(numpy_message)
     # input()
 
+    # 一条消息为n个节点的特征(每个FEATURE_SIZE维)加policy编号，n=1时与原来相同
+    # 异步请求(TYPE_ASYNCARRAY)在policy编号前多一个请求序号，回复时放在分数前面
+    # 剪枝请求(TYPE_PRUNEARRAY)每行PRUNE_FEATURE_SIZE维，用killPolicy打分
+    seq = None
+    kind = "kill" if mtype == TYPE_PRUNEARRAY else "search"
+    feature_size = PRUNE_FEATURE_SIZE if kind == "kill" else FEATURE_SIZE
     length = len(numpy_message) - 1
+    if mtype == TYPE_ASYNCARRAY:
+        length -= 1
+        seq = numpy_message[length]
     try:
-        assert length == FEATURE_SIZE
+        assert length % feature_size == 0 and length > 0
     except:
-        print(FEATURE_SIZE, length)
+        print(feature_size, length)
 
-    message = numpy_message[0:length]
-    numPolicy = numpy_message[length]
+    message = numpy_message[0:length].reshape(-1, feature_size)
+    numPolicy = numpy_message[-1]
     
-    return message, numPolicy
+    return message, numPolicy, seq, kind
 
 
-def send_to_c(data, client):
-    client["sender"].send(data.tobytes(), block=True, type=TYPE_ARRAY)
+def send_to_c(data, client, mtype=TYPE_ARRAY):
+    client["sender"].send(data.tobytes(), block=True, type=mtype)
 
 
-def load_model(policy_id, policy_dir):
+def load_model(policy_id, policy_dir, kind="search"):
     
-    policy_path = os.path.join(policy_dir, f'searchPolicy.{policy_id}.bin')
+    policy_path = os.path.join(policy_dir, f'{kind}Policy.{policy_id}.bin')
     model = xgb.Booster(model_file=policy_path)
     
     return model
@@ -58,18 +68,14 @@ def calc_score(input_trj, model):
 
     # model = xgb.Booster(model_file='searchPolicy.1.bin')
     # predict
+    # input_trj为n行特征，一次预测，返回[0, 第1个节点分数, ..., 第n个节点分数]
 
-    test_list = []
-    test_list.append(input_trj)
-
-    test_data = np.asarray(test_list)
-    test_data = xgb.DMatrix(test_data)
+    test_data = xgb.DMatrix(np.asarray(input_trj))
     rank_score = model.predict(test_data)
-    res = []
-    res.append(0)
-    res.append(rank_score[0])
+    res = [0]
+    res.extend(rank_score)
 
-    return np.array(res)
+    return np.array(res, dtype=np.double)
 
 def get_experiment(experiment):
 
@@ -109,21 +115,27 @@ if __name__ == '__main__':
     
     training_files_base = "/home/xuliming/daggerSpace/training_files/scip-dagger"
     
-    numPolicy = -1
+    # 节点选择和剪枝的模型分别缓存
+    numPolicy = {"search": -1, "kill": -1}
+    models = {}
    
     while True:
 
-        receive_feat, new_numPolicy = receive_from_c(c_client)
+        receive_feat, new_numPolicy, seq, kind = receive_from_c(c_client)
         print(receive_feat)
-        print("policy ", int(numPolicy), int(new_numPolicy))
+        print("policy ", kind, int(numPolicy[kind]), int(new_numPolicy))
 
-        if numPolicy != int(new_numPolicy):
+        if numPolicy[kind] != int(new_numPolicy):
             
-            numPolicy = new_numPolicy
-            model = load_model(int(new_numPolicy), policy_dir)
-            print(f'Get a new policy: {policy_dir}searchPolicy.{int(numPolicy)}.bin')
+            numPolicy[kind] = new_numPolicy
+            models[kind] = load_model(int(new_numPolicy), policy_dir, kind)
+            print(f'Get a new policy: {policy_dir}{kind}Policy.{int(new_numPolicy)}.bin')
 
-        out = calc_score(receive_feat, model)
+        out = calc_score(receive_feat, models[kind])
 
         print("NN result:", out)
-        send_to_c(out, c_client)
+        if seq is None:
+            send_to_c(out, c_client)
+        else:
+            out[0] = seq
+            send_to_c(out, c_client, TYPE_ASYNCARRAY)
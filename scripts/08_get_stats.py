@@ -10,11 +10,13 @@ import argparse
 import datetime
 
 from functools import reduce
+from multiprocessing import Pool
 from utils import is_file_over
 from get_scip_node import Node
-from subprocess import check_output
 from get_scip_node import InstanceFile
 from get_branch import get_branching
+from logparse import parse_log
+from hist import Hist, read_hists
 
 def get_column(matrix, i):
     return [row[i] for row in matrix]
@@ -71,6 +73,22 @@ def write_to_file(filebase, ins_stat, result_dir):
         fout.write("%s\n" % (str_to_write))
     fout.close()
     
+def write_latency(latency_rows, total_hists, result_dir):
+    """
+    将各instance及合并后的延迟分位数写入result_dir中的latency
+    :param latency_rows：[(instance, component, name, Hist)]
+    :param total_hists：{(component, name): 所有instance合并后的Hist}
+    :param result_dir：输出文件的路径
+    """
+    output_latency = os.path.join(result_dir, "latency")
+    with open(output_latency, 'w') as fout:
+        fout.write("%-10s %-16s %-8s %8s %10s %10s %10s %10s %10s\n" %
+                   ("problem", "component", "name", "count", "p50(us)", "p90(us)", "p99(us)", "p99.9(us)", "max(us)"))
+        rows = latency_rows + [("all", c, n, h) for (c, n), h in sorted(total_hists.items())]
+        for base, component, name, h in rows:
+            fout.write("%-10s %-16s %-8s %8d %10.2f %10.2f %10.2f %10.2f %10.2f\n" %
+                       tuple([base, component, name] + h.summary_us()))
+
 def get_log_stat(log_path, sol_path):
     """
     从一个instance的log和sol中提取该instance的节点数，求解时间等信息
@@ -81,39 +99,32 @@ def get_log_stat(log_path, sol_path):
         # print("ins not over")
         return [0]*10
     
-    igap_line = check_output("grep \"^Gap\" %s | tail -n 1" % log_path, shell=True, encoding="utf-8")
-    try:
-        # igap = float(igap_line.strip('\n').split()[2])
-        igap = float(float(igap_line.strip('\n').split()[2]))
-    except:
-        print("no igap")
-        print(igap_line)
-        assert igap_line.strip('\n').split()[2] == "infinite"
-
-    time_line = check_output("grep \"Solving Time\" %s | tail -n 1" % log_path, shell=True, encoding="utf-8")
-    nnodes_line = check_output("grep \"Solving Nodes\" %s | tail -n 1" % log_path, shell=True, encoding="utf-8")
-    dualbound_line = check_output("grep \"Dual Bound\" %s | tail -n 1" % log_path, shell=True, encoding="utf-8")
-    primalbound_line = check_output("grep \"Primal Bound\" %s | tail -n 1" % log_path, shell=True, encoding="utf-8")
-    
-    time = float(time_line.strip('\n').split()[4])
-    nnodes = int(nnodes_line.strip('\n').split()[3])
-    db = float(dualbound_line.strip('\n').split()[3])
-    pb = float(primalbound_line.strip('\n').split()[3])
+    # 日志只读一遍，统计信息、节点选择记录和分支耗时都从同一个record中取
+    record = parse_log(log_path)
 
-    try:
-        # opt_line = check_output("grep \"objective value\" %s" % sol_path, shell=True, encoding="utf-8")
-        opt_line = check_output("grep \"objective value\" %s | head -n 2 | tail -n 1" % log_path, shell=True, encoding="utf-8")
-        opt = float(opt_line.strip('\n').split()[2])
+    # gap为infinite时igap为inf
+    igap = record.gap
+    assert igap is not None, "no igap in %s" % log_path
+
+    time = record.time
+    nnodes = record.nnodes
+    db = record.dualbound
+    pb = record.primalbound
+    assert None not in (time, nnodes, db, pb), "incomplete statistics in %s" % log_path
+
+    if record.opt is not None:
+        # 日志中第二个"objective value"(没有则第一个)
+        opt = record.opt
         ogap = abs(opt-pb)
-    except:
+    else:
         opt = -1.0
         ogap = -1.0
     
-    ins_file_obj = InstanceFile(log_path)
+    ins_file_obj = InstanceFile(log_path, record)
     bPB_time = ins_file_obj.bPB_time
     presolving_time = ins_file_obj.presolving_time
 
-    branching_time, nvars = get_branching(log_path)
+    branching_time, nvars = get_branching(log_path, record)
     
     # try:
     #     error_line = check_output("grep \" comp error rate\" %s" %log_path, shell=True, encoding="utf-8")
@@ -124,18 +135,34 @@ def get_log_stat(log_path, sol_path):
     #     return nnodes, time, db, pb, opt, ogap, igap, bPB_time, presolving_time
     return nnodes, time, db, pb, opt, ogap, igap, bPB_time, presolving_time, branching_time, nvars
     
-def get_dir_stats(data_path, solution_dir, result_dir, first_k=20):
-    filelist = sorted(os.listdir(data_path), key=lambda x:int(x.split('.')[0].split('_')[1]))
+def _get_log_stat(paths):
+    return get_log_stat(*paths)
+
+def get_dir_stats(data_path, solution_dir, result_dir, first_k=20, jobs=None):
+    filelist = sorted(os.listdir(data_path), key=lambda x:int(x.split('.')[0].split('_')[1]))[:first_k]
     ins_stat_list = []
+    latency_rows = []
+    total_hists = {}
     write_to_file("", [], result_dir)
+
+    # 各instance的日志并行解析，jobs为进程数(None为CPU核数)
+    bases = [ins_file.split('.')[0] for ins_file in filelist]
+    paths = [(os.path.join(result_dir, f'{base}.log'), os.path.join(solution_dir, f'{base}.sol')) for base in bases]
+    if jobs == 1:
+        stats = [get_log_stat(*p) for p in paths]
+    else:
+        with Pool(jobs) as pool:
+            stats = pool.map(_get_log_stat, paths)
+
     for i, ins_file in enumerate(filelist):
-        insnum = int(ins_file.split('.')[0].split('_')[1])
-        if i >= first_k:
-            continue
-        base = ins_file.split('.')[0]
-        l_path = os.path.join(result_dir, f'{base}.log')
-        s_path = os.path.join(solution_dir, f'{base}.sol')
-        i_stat = get_log_stat(l_path, s_path)
+        base = bases[i]
+        i_stat = stats[i]
+        # --stats写出的延迟直方图，按桶合并后计算整个数据集的分位数
+        t_path = os.path.join(result_dir, f'{base}.stats')
+        if os.path.exists(t_path):
+            for (component, name), h in sorted(read_hists(t_path).items()):
+                latency_rows.append((base, component, name, h))
+                total_hists.setdefault((component, name), Hist()).merge(h)
         # write to file
         if True:
             write_to_file(base, i_stat, result_dir)
@@ -151,6 +178,9 @@ def get_dir_stats(data_path, solution_dir, result_dir, first_k=20):
     except:
         print("continue")
 
+    if latency_rows:
+        write_latency(latency_rows, total_hists, result_dir)
+
 if __name__ == "__main__":
 
     now_time = datetime.datetime.now().strftime('%Y-%m-%d-%H-%M')
@@ -180,6 +210,12 @@ if __name__ == "__main__":
        type=int,
        default=20,
     )
+    parser.add_argument(
+       '-j', '--jobs',
+       help='number of processes parsing logs (default: number of cpus)',
+       type=int,
+       default=None,
+    )
     
     args = parser.parse_args()
 
@@ -195,4 +231,4 @@ if __name__ == "__main__":
     s_dir = os.path.join(training_files_base, "bfs_solution", dat_type, d_name)
     r_dir=os.path.join(training_files_base, "clip-scratch", "result", dat_type, d_name, experiment)
     
-    get_dir_stats(d_path, s_dir, r_dir, fk)
+    get_dir_stats(d_path, s_dir, r_dir, fk, args.jobs)
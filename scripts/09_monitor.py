@@ -0,0 +1,153 @@
+# ==========================
+# 汇总本机上所有正在运行的求解进程的实时统计(求解时加--live，见src/livestat.c)
+# ==========================
+
+# 使用示例：python ./scripts/09_monitor.py -i 5
+#     每个进程在/dev/shm/scipdagger.<pid>.live中维护一页实时计数，本脚本无锁读取(seqlock)，不影响求解进程
+
+import os
+import sys
+import glob
+import mmap
+import time
+import struct
+import argparse
+
+MAGIC = b"LIVE"
+VERSION = 1
+
+# 与src/struct_livestat.h中SCIP_LiveStatPage的布局一致(本机字节序，无填充)
+_PAGE = struct.Struct("=4sIQqqdddqqdddqqqq32s128s")
+_SEQ = struct.Struct("=Q")
+_SEQ_OFFSET = 8
+
+_FIELDS = ("magic", "version", "seq", "pid", "finished", "starttime", "updatetime", "solvingtime", "nnodes", "nopen",
+           "primalbound", "dualbound", "gap", "nmodelcalls", "modelns", "modelmaxns", "trjbytes", "nodesel", "name")
+
+
+def read_page(path, retries=100):
+    """
+    无锁读取一个进程的统计页：seq为奇数表示正在更新，前后两次读到的seq相同才接受
+    :return: dict，页无效或一直在更新时返回None
+    """
+    try:
+        with open(path, "rb") as f:
+            mm = mmap.mmap(f.fileno(), _PAGE.size, prot=mmap.PROT_READ)
+    except (OSError, ValueError):
+        return None
+    try:
+        for _ in range(retries):
+            seq1, = _SEQ.unpack_from(mm, _SEQ_OFFSET)
+            if seq1 & 1:
+                continue
+            data = mm[:_PAGE.size]
+            seq2, = _SEQ.unpack_from(mm, _SEQ_OFFSET)
+            if seq1 != seq2:
+                continue
+            rec = dict(zip(_FIELDS, _PAGE.unpack(data)))
+            if rec["magic"] != MAGIC or rec["version"] > VERSION:
+                return None
+            rec["nodesel"] = rec["nodesel"].split(b"\0", 1)[0].decode("utf-8", "replace")
+            rec["name"] = rec["name"].split(b"\0", 1)[0].decode("utf-8", "replace")
+            return rec
+        return None
+    finally:
+        mm.close()
+
+
+def is_alive(pid):
+    """
+    进程是否还在运行
+    """
+    try:
+        os.kill(pid, 0)
+    except ProcessLookupError:
+        return False
+    except PermissionError:
+        return True
+    return True
+
+
+def scan(live_dir, clean):
+    """
+    读取live_dir中所有进程的统计页
+    :param clean: 删除已退出进程(被kill等)留下的页
+    :return: {pid: dict}
+    """
+    pages = {}
+    for path in glob.glob(os.path.join(live_dir, "scipdagger.*.live")):
+        rec = read_page(path)
+        if rec is None:
+            continue
+        if not is_alive(rec["pid"]):
+            if clean:
+                try:
+                    os.remove(path)
+                except OSError:
+                    pass
+            continue
+        pages[rec["pid"]] = rec
+    return pages
+
+
+def print_table(pages, prev, now):
+    """
+    每个进程一行，最后一行为汇总；节点速率按两次刷新之间的节点数计算
+    """
+    print("%7s %-20s %-7s %8s %10s %9s %8s %12s %12s %8s %9s %9s %8s %6s" %
+          ("pid", "problem", "nodesel", "time", "nodes", "nodes/s", "open", "primal", "dual", "gap(%)",
+           "model", "mdl(us)", "trj(MB)", "age"))
+    tot_nodes = tot_rate = tot_open = tot_calls = tot_trj = 0
+    for pid in sorted(pages):
+        rec = pages[pid]
+        rate = 0.0
+        if pid in prev and rec["updatetime"] > prev[pid]["updatetime"]:
+            rate = (rec["nnodes"] - prev[pid]["nnodes"]) / (rec["updatetime"] - prev[pid]["updatetime"])
+        mean_us = rec["modelns"] / rec["nmodelcalls"] / 1e3 if rec["nmodelcalls"] > 0 else 0.0
+        trj_mb = rec["trjbytes"] / 1048576.0 if rec["trjbytes"] >= 0 else float("nan")
+        print("%7d %-20s %-7s %8.1f %10d %9.1f %8d %12.4g %12.4g %8.2f %9d %9.1f %8.1f %6.1f" %
+              (pid, rec["name"][:20], rec["nodesel"][:7], rec["solvingtime"], rec["nnodes"], rate, rec["nopen"],
+               rec["primalbound"], rec["dualbound"], 100.0 * rec["gap"], rec["nmodelcalls"], mean_us, trj_mb,
+               now - rec["updatetime"]))
+        tot_nodes += rec["nnodes"]
+        tot_rate += rate
+        tot_open += rec["nopen"]
+        tot_calls += rec["nmodelcalls"]
+        tot_trj += max(rec["trjbytes"], 0)
+    print("%7s %-20s %-7s %8s %10d %9.1f %8d %12s %12s %8s %9d %9s %8.1f" %
+          ("all", "%d solves" % len(pages), "", "", tot_nodes, tot_rate, tot_open, "", "", "", tot_calls, "",
+           tot_trj / 1048576.0))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+       '-d', '--live_dir',
+       help='directory of the live statistics pages',
+       type=str,
+       default='/dev/shm',
+    )
+    parser.add_argument(
+       '-i', '--interval',
+       help='refresh interval in seconds (0: print once)',
+       type=float,
+       default=0,
+    )
+    parser.add_argument(
+       '--clean',
+       help='remove pages left by processes that were killed',
+       action='store_true',
+    )
+    args = parser.parse_args()
+
+    prev = {}
+    while True:
+        pages = scan(args.live_dir, args.clean)
+        if args.interval > 0:
+            sys.stdout.write("\033[H\033[J")
+        print_table(pages, prev, time.time())
+        sys.stdout.flush()
+        if args.interval <= 0:
+            break
+        prev = pages
+        time.sleep(args.interval)
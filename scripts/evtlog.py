@@ -0,0 +1,103 @@
+# =====================================================
+# 读取节点选择器写出的二进制事件日志(--evtlog，见src/evtlog.c)
+# =====================================================
+
+# 文件布局(小端，无对齐)：
+#   "SEVT" version(u32)
+#   'V' probindex(i32) namelen(u16) name                      变量名，第一次使用前写入
+#   'I' time(f64) obj(f64) solnode(i64) nsols(i32) nbestsolsfound(i64)
+#                                                             上次节点选择后找到的更优可行解
+#   'S' node(i64) parent(i64) depth(i32) var(i32) boundtype(u8) bound(f64) primalbound(f64) dualbound(f64)
+#       lowerbound(f64) score(f64) time(f64) totaltime(f64) nopen(i32) isopt(u8)
+#                                                             节点选择
+# 节点的分支路径由parent链上每个节点自身的分支(var/boundtype/bound)组成
+
+import struct
+
+MAGIC = b"SEVT"
+VERSION = 1
+
+BOUNDTYPE_LOWER = 0
+BOUNDTYPE_UPPER = 1
+BOUNDTYPE_NONE = 255
+
+_HEADER = struct.Struct("<4sI")
+_VAR = struct.Struct("<iH")
+_INCUMBENT = struct.Struct("<ddqiq")
+_SELECT = struct.Struct("<qqiiBdddddddiB")
+
+_SELECT_FIELDS = ("node", "parent", "depth", "var", "boundtype", "bound", "primalbound", "dualbound",
+                  "lowerbound", "score", "time", "totaltime", "nopen", "isopt")
+_INCUMBENT_FIELDS = ("time", "obj", "solnode", "nsols", "nbestsolsfound")
+
+
+class EvtLog():
+    """
+    读取整个事件日志
+    :param path: .evt文件路径
+    vars: probindex -> 变量名
+    selects: 节点选择记录列表(dict)，按选择顺序
+    incumbents: 更优可行解记录列表(dict)，每条记录的"select"为其后第一条节点选择记录的下标
+    """
+    def __init__(self, path):
+        self.vars = {}
+        self.selects = []
+        self.incumbents = []
+        self.by_node = {}
+
+        with open(path, "rb") as f:
+            buf = f.read()
+
+        magic, version = _HEADER.unpack_from(buf, 0)
+        assert magic == MAGIC, "not an event log: %s" % path
+        assert version <= VERSION
+        pos = _HEADER.size
+
+        while pos < len(buf):
+            rtype = buf[pos:pos + 1]
+            pos += 1
+            if rtype == b"V":
+                if pos + _VAR.size > len(buf):
+                    break
+                probindex, namelen = _VAR.unpack_from(buf, pos)
+                pos += _VAR.size
+                self.vars[probindex] = buf[pos:pos + namelen].decode("utf-8", "replace")
+                pos += namelen
+            elif rtype == b"I":
+                if pos + _INCUMBENT.size > len(buf):
+                    break
+                rec = dict(zip(_INCUMBENT_FIELDS, _INCUMBENT.unpack_from(buf, pos)))
+                pos += _INCUMBENT.size
+                rec["select"] = len(self.selects)
+                self.incumbents.append(rec)
+            elif rtype == b"S":
+                if pos + _SELECT.size > len(buf):
+                    break
+                rec = dict(zip(_SELECT_FIELDS, _SELECT.unpack_from(buf, pos)))
+                pos += _SELECT.size
+                self.by_node[rec["node"]] = rec
+                self.selects.append(rec)
+            else:
+                # 进程被中断时最后一条记录可能不完整
+                raise ValueError("bad record type %r at offset %d in %s" % (rtype, pos - 1, path))
+
+    def branching(self, rec):
+        """
+        节点自身的分支，返回(变量名, boundtype, bound)，根节点返回None
+        """
+        if rec["var"] < 0 or rec["boundtype"] == BOUNDTYPE_NONE:
+            return None
+        return self.vars.get(rec["var"], "?%d" % rec["var"]), rec["boundtype"], rec["bound"]
+
+    def root_path(self, node):
+        """
+        从节点到根节点的分支列表(离节点最近的在前)，与SCIPprintNodeRootPath的输出内容一致
+        """
+        path = []
+        rec = self.by_node.get(node)
+        while rec is not None:
+            b = self.branching(rec)
+            if b is not None:
+                path.append(b)
+            rec = self.by_node.get(rec["parent"])
+        return path
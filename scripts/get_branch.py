@@ -1,19 +1,16 @@
-import os
+from logparse import parse_log
 
 class Branching():
     def __init__(self, time = 0.0, nvars = 0):
         self.time = time
         self.nvars = nvars
 
-def get_branching(log_file_path):
-    os.system("grep -rEn 'final branching' %s > %s_tmp" % (log_file_path, log_file_path))
-    branching_lines = [n.strip('\n') for n in open("%s_tmp" % log_file_path, "r").readlines()] 
-    os.system("rm %s_tmp" % log_file_path)
-    
-    time, nvars = 0.0, 0.0
+def get_branching(log_file_path, record=None):
+    """
+    所有"final branching"行的分支耗时和变量个数之和
+    :param record: 已经用logparse.parse_log解析过的日志，避免重复读取
+    """
+    if record is None:
+        record = parse_log(log_file_path)
 
-    for line in branching_lines:
-        nvars += int(line.split(' ')[5])
-        time += float(line.split(' ')[7])
-        
-    return time, nvars
\ No newline at end of file
+    return record.branching_time, record.branching_nvars
\ No newline at end of file
@@ -1,4 +1,6 @@
 import os
+from evtlog import EvtLog, BOUNDTYPE_LOWER, BOUNDTYPE_UPPER
+from logparse import parse_log, process_t_var
 
 class Node():
     def __init__(self, idx=-2, lowerbound=-1.00, primalbound=10000.00, dualbound=-1.00, branchvars=[], left=0, time=0.0, depth=0, obj_list=[10000]):
@@ -18,14 +20,16 @@ class Node():
 
 class InstanceFile():
     # TODO: 周末重新整理
-    def __init__(self, log_file_path=""):
+    def __init__(self, log_file_path="", record=None):
+        """
+        :param record: 已经用logparse.parse_log解析过的日志，避免重复读取
+        """
         self.bPB_time = 0.0
-        self.log_file_lines = []
         self.max_node_number = 0
         self.presolving_time = 0
         self.best_primalbound = -1000000.0
 
-        self.nodelist = self.get_all_nodes_from_log(log_file_path)
+        self.nodelist = self.get_all_nodes_from_log(log_file_path, record)
 
         self.bPB_time = self.get_bPB_time()
         self.sorted_nodelist = self.build_sorted_nodelist()
@@ -61,24 +65,84 @@ class InstanceFile():
             print("empty bPB")
         return b_time
         
-    def get_all_nodes_from_log(self, log_file_path): 
-        os.system("grep -rEn 'final selecting' %s | cut -f1 -d':' > %s_tmp" % (log_file_path, log_file_path))
-        line_no = [int(n.strip("\n")) for n in open("%s_tmp" % log_file_path, "r").readlines()] # 1,2,...
-        os.system("rm %s_tmp" % log_file_path)
-        self.log_file_lines = open("%s" % log_file_path, "r").readlines()
+    def get_all_nodes_from_log(self, log_file_path, record=None): 
+        # 有二进制事件日志(与日志同名的.evt文件)时直接读取，不再解析文本
+        evt_path = os.path.splitext(log_file_path)[0] + ".evt"
+        if os.path.exists(evt_path):
+            return self.get_all_nodes_from_evtlog(evt_path)
+
+        # 单遍解析日志，每条"final selecting"记录对应一个node对象
+        if record is None:
+            record = parse_log(log_file_path)
+
+        # 没有.evt文件且日志中没有打印分支路径时，所有节点都会被标为最优，不能用于生成标签
+        branched = [ev for ev in record.selects if ev.depth > 0]
+        if branched and not any(ev.branchvars for ev in branched):
+            raise ValueError("%s: selections without branching paths and no event log %s; run with --tracelevel 1 "
+                             "or --evtlog" % (log_file_path, evt_path))
 
         cur_nodelist = []
-        for i in range(len(line_no)):
-            # 每读一行，就定义一个node对象，并append到cur_nodelist            
-            # examine line_no[i-1]+1 --- line_no[i]
-            cur_node = self.get_scip_node(line_no[i-1], line_no[i])
-            if cur_node != Node() or cur_node.primalbound != 10000.00 or cur_node.time == 0.0:
-                cur_nodelist.append(cur_node)
-                self.best_primalbound = max(cur_node.primalbound, self.best_primalbound)
-                self.max_node_number = max(cur_node.idx, self.max_node_number)
+        for ev in record.selects:
+            cur_node = Node(ev.idx, ev.lowerbound, ev.primalbound, ev.dualbound, ev.branchvars, ev.left, ev.time,
+                            ev.depth, ev.obj_list)
+            cur_node.bPB_time = ev.bPB_time
+            cur_nodelist.append(cur_node)
+            self.best_primalbound = max(cur_node.primalbound, self.best_primalbound)
+            self.max_node_number = max(cur_node.idx, self.max_node_number)
                 
         return cur_nodelist
     
+    def get_all_nodes_from_evtlog(self, evt_path):
+        """
+        从二进制事件日志得到节点列表，分支变量由parent链重建
+        """
+        evt = EvtLog(evt_path)
+        cur_nodelist = []
+        obj_list = []
+        bPB_time = 0.0
+        inc = 0
+        for k, rec in enumerate(evt.selects):
+            # 在本次节点选择之前找到的更优可行解
+            while inc < len(evt.incumbents) and evt.incumbents[inc]["select"] <= k:
+                obj_list.insert(0, evt.incumbents[inc]["obj"])
+                bPB_time = evt.incumbents[inc]["time"]
+                inc += 1
+
+            cur_node = Node()
+            cur_node.idx = rec["node"]
+            cur_node.primalbound = rec["primalbound"]
+            cur_node.lowerbound = rec["lowerbound"]
+            cur_node.dualbound = rec["dualbound"]
+            cur_node.time = rec["time"]
+            cur_node.depth = rec["depth"]
+            cur_node.left = rec["nopen"]
+            cur_node.bPB_time = bPB_time
+            cur_node.obj_list = obj_list[:5]
+            cur_node.branchvars = self.evt_branchvars(evt, rec["node"])
+
+            cur_nodelist.append(cur_node)
+            self.best_primalbound = max(cur_node.primalbound, self.best_primalbound)
+            self.max_node_number = max(cur_node.idx, self.max_node_number)
+
+        return cur_nodelist
+
+    def evt_branchvars(self, evt, node_idx):
+        """
+        与文本日志中的根路径相同：只保留 x <= 0 和 x >= 1 的分支，离节点最近的在前
+        """
+        node_branchvars = []
+        for name, boundtype, bound in evt.root_path(node_idx):
+            var = {}
+            if boundtype == BOUNDTYPE_UPPER and bound == 0.0:
+                var["name"] = self.process_t_var("<%s>" % name)
+                var["value"] = int(0)
+            elif boundtype == BOUNDTYPE_LOWER and bound == 1.0:
+                var["name"] = self.process_t_var("<%s>" % name)
+                var["value"] = int(1)
+            if var:
+                node_branchvars.append(var)
+        return node_branchvars
+
     def get_new_sols(self, node1, node2):
         # node1 - node2
         obj_list_1 = node1.obj_list
@@ -135,75 +199,6 @@ class InstanceFile():
         
         return improvment_nodelist
 
-    def get_scip_node(self, st, ed):
-        # st, start line number
-        # ed, end line number.   [st, ed]
-
-        # if self.log_file_lines[ed-1].startswith("[src/scip/nodesel_estimate.c:") == True:
-        #     return Node()
-        
-        node = Node()
-        _splitted = self.log_file_lines[ed-1].strip().rstrip("\n").split()
-
-        if _splitted[0] == "1:":
-            splitted = _splitted[1:]
-        else:
-            splitted = _splitted
-        idx = splitted[6]
-
-        # ？？？？ why idx == 1
-        if idx == -1 or idx == 1:
-            return node
-       
-        node.idx = int(idx)
-        node.primalbound = float(splitted[8])
-        node.lowerbound = float(splitted[10])
-        node.dualbound = float(splitted[12])
-
-        if len(splitted) > 13:
-            node.time = float(splitted[14])
-            node.depth = int(splitted[16])
-            node.left = int(splitted[18])
-            try:
-                node.bPB_time = float(splitted[20])
-            except:
-                node.bPB_time = 0
-        if len(splitted) > 20:
-            # nsols = int(splitted[20])
-            node_obj_list = []
-            for i in range(25, len(splitted), 1):
-                if "obj" in splitted[i-1]:
-                    node_obj_list.append(float(splitted[i]))
-            node.obj_list = node_obj_list
-            
-        node_branchvars = []
-        for i in range(ed-2, st-2, -1):
-            f_l = self.log_file_lines[i].strip("\n")
-            if f_l.startswith("<"):
-                try:
-                    t_var, rel, value = f_l.split(" ")
-                except:
-                    print("[bad t_var], %s" % f_l)
-                var = {}
-                if rel == "<=" and value == "0.0":
-                    var["name"] = self.process_t_var(t_var)
-                    var["value"] = int(0)
-                elif rel == ">=" and value == "1.0":
-                    var["name"] = self.process_t_var(t_var)
-                    var["value"] = int(1)
-                if var:
-                    node_branchvars.append(var)
-            elif f_l.startswith("[src/scip/nodesel"):
-                break
-            else:
-                continue
-            
-        node.branchvars = node_branchvars
-        # print(splitted)
-        # print(node.idx, node.branchvars, node.bPB_time, node.time, node.primalbound)
-        # input()
-        return node
-    
     # by node number
     def build_sorted_nodelist(self):
         """
@@ -219,12 +214,7 @@ class InstanceFile():
         return sorted_nodelist
 
     def process_t_var(self, t_var):
-        assert t_var[0] == "<"
-        assert t_var[-1]== ">"
-        tv = t_var[1:-1]
-        while tv.startswith("t_"):
-            tv = tv.replace("t_", "")
-        return tv
+        return process_t_var(t_var)
 
 class InstanceFileOld():
     # TODO: 周末重新整理�?
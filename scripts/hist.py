@@ -0,0 +1,82 @@
+# =====================================================
+# 读取--stats文件中的延迟直方图(见src/hist.c)，可跨instance合并后计算分位数
+# =====================================================
+
+# 直方图行格式：<component> hist <name> count <n> sum <ns> max <ns> <bucket>:<count> ...
+# 小于2^SUBBITS的值精确计数，其余每个2的幂区间等分为2^SUBBITS个桶，相对误差不超过2^-SUBBITS
+
+SUBBITS = 4
+NSUB = 1 << SUBBITS
+
+QUANTILES = (0.5, 0.9, 0.99, 0.999)
+
+
+def bucket_upper(idx):
+    """
+    桶内最大值(ns)
+    """
+    if idx < NSUB:
+        return idx
+    shift = idx // NSUB - 1
+    return ((NSUB + idx % NSUB) << shift) + (1 << shift) - 1
+
+
+class Hist():
+    def __init__(self):
+        self.count = 0
+        self.sum = 0
+        self.max = 0
+        self.buckets = {}
+
+    def merge(self, other):
+        self.count += other.count
+        self.sum += other.sum
+        self.max = max(self.max, other.max)
+        for idx, c in other.buckets.items():
+            self.buckets[idx] = self.buckets.get(idx, 0) + c
+
+    def quantile(self, q):
+        """
+        分位数(ns)，取所在桶的上界且不超过最大值，与SCIPhistGetQuantile一致
+        """
+        if self.count == 0:
+            return 0
+        rank = max(1, int(q * self.count + 0.5))
+        seen = 0
+        for idx in sorted(self.buckets):
+            seen += self.buckets[idx]
+            if seen >= rank:
+                return min(bucket_upper(idx), self.max)
+        return self.max
+
+    def summary_us(self):
+        """
+        [count, p50, p90, p99, p99.9, max]，时间单位us
+        """
+        return [self.count] + [self.quantile(q) / 1e3 for q in QUANTILES] + [self.max / 1e3]
+
+
+def read_hists(path):
+    """
+    读取一个stats文件中的全部直方图
+    :return: {(component, name): Hist}
+    """
+    hists = {}
+    with open(path) as f:
+        for line in f:
+            tokens = line.split()
+            if len(tokens) < 9 or tokens[1] != "hist":
+                continue
+            h = Hist()
+            h.count = int(tokens[4])
+            h.sum = int(tokens[6])
+            h.max = int(tokens[8])
+            for tok in tokens[9:]:
+                idx, c = tok.split(":")
+                h.buckets[int(idx)] = int(c)
+            key = (tokens[0], tokens[2])
+            if key in hists:
+                hists[key].merge(h)
+            else:
+                hists[key] = h
+    return hists
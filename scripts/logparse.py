@@ -0,0 +1,200 @@
+# =====================================================
+# 单遍解析求解日志：SCIP统计信息、节点选择记录和分支耗时，代替每个日志多次grep
+# =====================================================
+
+# 一次顺序读完日志，得到LogRecord：
+#   fields: 统计信息中所有顶格的"名字 : 值"行(同名取最后一次，能转成数字的转成float)
+#   gap/time/nnodes/dualbound/primalbound/opt: 与原来grep | tail取的行相同
+#   selects: 每条"final selecting"行对应一个NodeEvent，branchvars为上一次节点选择之后、该行之前的分支变量行(离节点最近的在前)
+#   branching_time/branching_nvars: 所有"final branching"行的耗时和变量个数之和
+# parse_logs用进程池并行解析多个日志，结果顺序与输入相同
+
+# 使用示例：python ./scripts/logparse.py result/policy.1/instance_1.log [-j 8]
+
+import argparse
+import os
+from collections import namedtuple
+from multiprocessing import Pool
+
+NodeEvent = namedtuple("NodeEvent", ["idx", "primalbound", "lowerbound", "dualbound", "time", "depth", "left",
+                                     "bPB_time", "obj_list", "branchvars"])
+
+
+class LogRecord():
+    """
+    一个日志的解析结果，日志中没有的字段为None
+    """
+    __slots__ = ("path", "fields", "gap", "time", "nnodes", "dualbound", "primalbound", "opt",
+                 "branching_time", "branching_nvars", "selects")
+
+    def __init__(self, path):
+        self.path = path
+        self.fields = {}
+        self.gap = None
+        self.time = None
+        self.nnodes = None
+        self.dualbound = None
+        self.primalbound = None
+        self.opt = None
+        self.branching_time = 0.0
+        self.branching_nvars = 0.0
+        self.selects = []
+
+
+def process_t_var(t_var):
+    """
+    "<t_t_x3>" -> "x3"
+    """
+    assert t_var[0] == "<"
+    assert t_var[-1] == ">"
+    tv = t_var[1:-1]
+    while tv.startswith("t_"):
+        tv = tv.replace("t_", "")
+    return tv
+
+
+def _to_number(token, value):
+    try:
+        return float(token)
+    except ValueError:
+        return value
+
+
+def _field_at(tokens, i, conv):
+    try:
+        return conv(tokens[i])
+    except (TypeError, IndexError, ValueError):
+        return None
+
+
+def _parse_select(line, branch_lines):
+    """
+    解析一条"final selecting"行，格式见src/nodesel_*.c
+    """
+    _splitted = line.strip().split()
+    splitted = _splitted[1:] if _splitted[0] == "1:" else _splitted
+
+    idx = int(splitted[6])
+    primalbound = float(splitted[8])
+    lowerbound = float(splitted[10])
+    dualbound = float(splitted[12])
+    time, depth, left, bPB_time = 0.0, 0, 0, 0.00
+    obj_list = [10000]
+
+    if len(splitted) > 13:
+        time = float(splitted[14])
+        depth = int(splitted[16])
+        left = int(splitted[18])
+        try:
+            bPB_time = float(splitted[20])
+        except (IndexError, ValueError):
+            bPB_time = 0
+    if len(splitted) > 20:
+        obj_list = [float(splitted[i]) for i in range(25, len(splitted)) if "obj" in splitted[i - 1]]
+
+    branchvars = []
+    for f_l in reversed(branch_lines):
+        try:
+            t_var, rel, value = f_l.split(" ")
+        except ValueError:
+            print("[bad t_var], %s" % f_l)
+            continue
+        if rel == "<=" and value == "0.0":
+            branchvars.append({"name": process_t_var(t_var), "value": 0})
+        elif rel == ">=" and value == "1.0":
+            branchvars.append({"name": process_t_var(t_var), "value": 1})
+
+    return NodeEvent(idx, primalbound, lowerbound, dualbound, time, depth, left, bPB_time, obj_list, branchvars)
+
+
+def parse_log(path):
+    """
+    单遍解析一个日志
+    :param path: 日志路径
+    :return: LogRecord
+    """
+    rec = LogRecord(path)
+    gap_tokens = time_tokens = nnodes_tokens = db_tokens = pb_tokens = None
+    objective_lines = []
+    branch_lines = []
+    first_select = True
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+
+            # 分支变量行只属于下一条节点选择记录
+            if line.startswith("<"):
+                if not first_select:
+                    branch_lines.append(line)
+                continue
+            if "final selecting" in line:
+                rec.selects.append(_parse_select(line, branch_lines))
+                branch_lines = []
+                first_select = False
+                continue
+            if line.startswith("[src/scip/nodesel"):
+                branch_lines = []
+            if "final branching" in line:
+                tokens = line.split(" ")
+                rec.branching_nvars += int(tokens[5])
+                rec.branching_time += float(tokens[7])
+                continue
+
+            if line.startswith("Gap"):
+                gap_tokens = line.split()
+            if "Solving Time" in line:
+                time_tokens = line.split()
+            if "Solving Nodes" in line:
+                nnodes_tokens = line.split()
+            if "Dual Bound" in line:
+                db_tokens = line.split()
+            if "Primal Bound" in line:
+                pb_tokens = line.split()
+            if "objective value" in line and len(objective_lines) < 2:
+                objective_lines.append(line.split())
+
+            # 统计信息的顶格字段，如"Solving Time (sec) : 12.30"；数值字段只取第一个数，其余保留整个字符串
+            if line and not line[0].isspace() and " : " in line:
+                name, _, value = line.partition(" : ")
+                value = value.strip()
+                if value:
+                    rec.fields[name.strip()] = _to_number(value.split()[0], value)
+
+    rec.gap = _field_at(gap_tokens, 2, float)
+    if rec.gap is None and gap_tokens is not None and len(gap_tokens) > 2 and gap_tokens[2] == "infinite":
+        rec.gap = float("inf")
+    rec.time = _field_at(time_tokens, 4, float)
+    rec.nnodes = _field_at(nnodes_tokens, 3, int)
+    rec.dualbound = _field_at(db_tokens, 3, float)
+    rec.primalbound = _field_at(pb_tokens, 3, float)
+    if objective_lines:
+        rec.opt = _field_at(objective_lines[-1], 2, float)
+
+    return rec
+
+
+def parse_logs(paths, jobs=None):
+    """
+    并行解析多个日志
+    :param paths: 日志路径列表
+    :param jobs: 进程数，None为CPU核数
+    :return: 与paths顺序相同的LogRecord列表
+    """
+    paths = list(paths)
+    if jobs == 1 or len(paths) <= 1:
+        return [parse_log(p) for p in paths]
+    with Pool(jobs) as pool:
+        return pool.map(parse_log, paths, chunksize=max(1, len(paths) // (4 * (jobs or os.cpu_count() or 1))))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("logs", nargs="+", help="log files")
+    parser.add_argument("-j", "--jobs", type=int, default=None, help="number of processes")
+    args = parser.parse_args()
+
+    for rec in parse_logs(args.logs, args.jobs):
+        print("%s nnodes %s time %s pb %s db %s gap %s opt %s selects %d branching %.2f/%d" %
+              (rec.path, rec.nnodes, rec.time, rec.primalbound, rec.dualbound, rec.gap, rec.opt,
+               len(rec.selects), rec.branching_time, rec.branching_nvars))
@@ -0,0 +1,74 @@
+# =====================================================
+# 读取节点选择器写出的开放节点队列采样(--treesample，见src/treesampler.c)
+# =====================================================
+
+# 文件布局(小端，无对齐)：
+#   "TSMP" version(u32) nbins(u32) binwidth(u32)
+#   'T' time(f64) nselects(i64) nnodes(i64) nleaves(i32) nchildren(i32) nsiblings(i32) plungedepth(i32)
+#       maxdepth(i32) minlb(f64) meanlb(f64) maxlb(f64) primalbound(f64) dualbound(f64) memused(i64)
+#       depthhist[nbins](i32)
+# 深度直方图第i个桶统计深度在[i*binwidth, (i+1)*binwidth)的开放节点，最后一个桶包含所有更深的节点
+
+# 使用示例：python ./scripts/treesampler.py result/policy.1/instance_1.tsmp
+
+import struct
+import sys
+
+MAGIC = b"TSMP"
+VERSION = 1
+
+_HEADER = struct.Struct("<4sIII")
+_SAMPLE = struct.Struct("<dqqiiiiidddddq")
+
+_SAMPLE_FIELDS = ("time", "nselects", "nnodes", "nleaves", "nchildren", "nsiblings", "plungedepth", "maxdepth",
+                  "minlb", "meanlb", "maxlb", "primalbound", "dualbound", "memused")
+
+
+class TreeSamples():
+    """
+    读取整个采样文件
+    :param path: .tsmp文件路径
+    binwidth: 深度直方图每个桶的深度范围
+    samples: 采样记录列表(dict)，按时间顺序，"depthhist"为各桶的开放节点数
+    """
+    def __init__(self, path):
+        self.samples = []
+
+        with open(path, "rb") as f:
+            buf = f.read()
+
+        magic, version, nbins, self.binwidth = _HEADER.unpack_from(buf, 0)
+        assert magic == MAGIC, "not a tree sample file: %s" % path
+        assert version <= VERSION
+        pos = _HEADER.size
+        hist = struct.Struct("<%di" % nbins)
+
+        while pos < len(buf):
+            rtype = buf[pos:pos + 1]
+            pos += 1
+            if rtype != b"T":
+                raise ValueError("bad record type %r at offset %d in %s" % (rtype, pos - 1, path))
+            # 进程被中断时最后一条记录可能不完整
+            if pos + _SAMPLE.size + hist.size > len(buf):
+                break
+            rec = dict(zip(_SAMPLE_FIELDS, _SAMPLE.unpack_from(buf, pos)))
+            pos += _SAMPLE.size
+            rec["depthhist"] = list(hist.unpack_from(buf, pos))
+            pos += hist.size
+            rec["nopen"] = rec["nleaves"] + rec["nchildren"] + rec["nsiblings"]
+            self.samples.append(rec)
+
+    def series(self, field):
+        """
+        某个字段的时间序列，返回[(time, value)]
+        """
+        return [(rec["time"], rec[field]) for rec in self.samples]
+
+
+if __name__ == "__main__":
+    ts = TreeSamples(sys.argv[1])
+    print("time nselects nopen nleaves nchildren nsiblings plunge maxdepth minlb maxlb memMB")
+    for rec in ts.samples:
+        print("%.2f %d %d %d %d %d %d %d %.3f %.3f %.1f" % (rec["time"], rec["nselects"], rec["nopen"], rec["nleaves"],
+              rec["nchildren"], rec["nsiblings"], rec["plungedepth"], rec["maxdepth"], rec["minlb"], rec["maxlb"],
+              rec["memused"] / 1048576.0))
@@ -0,0 +1,255 @@
+# =====================================================
+# 分片trj存储：多个instance写入同一分片，分片末尾保存索引(footer)
+# =====================================================
+
+# 分片文件布局：
+#   MAGIC(4) VERSION(u32)
+#   group 0 | group 1 | ...                  每个group连续存放
+#   footer (json)                            instance名、group偏移、记录数
+#   footer_offset(u64) footer_len(u32) FOOTER_MAGIC(4)
+#
+# group布局：
+#   groupID(i32) nnodes(u32) npos(u32) nfeats(u32)
+#   idx(i64 * nnodes) value(i8 * nnodes) optID(i32 * nnodes) weight(f64 * nnodes) feats(f64 * nnodes * nfeats)
+#   (VERSION 1的分片没有weight，读取时weight为1.0)
+
+import os
+import json
+import random
+import struct
+from array import array
+from itertools import groupby
+
+MAGIC = b"TRJS"
+FOOTER_MAGIC = b"TRJI"
+VERSION = 2
+SHARD_SUFFIX = ".trjs"
+
+_HEADER = struct.Struct("<4sI")
+_TRAILER = struct.Struct("<QI4s")
+_GROUP = struct.Struct("<iIII")
+
+
+def _encode_group(group_id, records):
+    """
+    将同一个group的节点记录编码为二进制
+    :param group_id
+    :param records: [{"idx", "groupID", "feats", "weight", "label": {"value", "optID"}}]
+    """
+    nnodes = len(records)
+    nfeats = len(records[0]["feats"]) if nnodes > 0 else 0
+    idx = array("q", [r["idx"] for r in records])
+    value = array("b", [r["label"]["value"] for r in records])
+    optid = array("i", [r["label"]["optID"] for r in records])
+    weight = array("d", [r.get("weight", 1.0) for r in records])
+    feats = array("d")
+    for r in records:
+        assert len(r["feats"]) == nfeats
+        feats.extend(r["feats"])
+    npos = sum(value)
+    return b"".join([
+        _GROUP.pack(group_id, nnodes, npos, nfeats),
+        idx.tobytes(), value.tobytes(), optid.tobytes(), weight.tobytes(), feats.tobytes()
+    ])
+
+
+def _decode_group(buf, version=VERSION):
+    """
+    解码一个group，返回与03_make_data.py相同格式的记录列表
+    """
+    group_id, nnodes, _, nfeats = _GROUP.unpack_from(buf, 0)
+    pos = _GROUP.size
+
+    def take(typecode, n):
+        nonlocal pos
+        arr = array(typecode)
+        nbytes = arr.itemsize * n
+        arr.frombytes(buf[pos:pos + nbytes])
+        pos += nbytes
+        return arr
+
+    idx = take("q", nnodes)
+    value = take("b", nnodes)
+    optid = take("i", nnodes)
+    weight = take("d", nnodes) if version >= 2 else [1.0] * nnodes
+    feats = take("d", nnodes * nfeats)
+
+    records = []
+    for i in range(nnodes):
+        records.append({
+            "idx": idx[i],
+            "groupID": group_id,
+            "feats": list(feats[i * nfeats:(i + 1) * nfeats]),
+            "weight": weight[i],
+            "label": {"value": value[i], "optID": optid[i]},
+        })
+    return records
+
+
+class ShardWriter():
+    """
+    按instance顺序写分片，每个分片最多instances_per_shard个instance
+    """
+    def __init__(self, save_dir, prefix, instances_per_shard=100):
+        self.save_dir = save_dir
+        self.prefix = prefix
+        self.instances_per_shard = instances_per_shard
+        self.nshards = 0
+        self.f = None
+        self.index = []
+        os.makedirs(save_dir, exist_ok=True)
+
+    def _open_shard(self):
+        path = os.path.join(self.save_dir, "%s.%05d%s" % (self.prefix, self.nshards, SHARD_SUFFIX))
+        self.f = open(path, "wb")
+        self.f.write(_HEADER.pack(MAGIC, VERSION))
+        self.index = []
+        self.nshards += 1
+
+    def _close_shard(self):
+        if self.f is None:
+            return
+        footer = json.dumps({"version": VERSION, "instances": self.index}).encode("utf-8")
+        footer_offset = self.f.tell()
+        self.f.write(footer)
+        self.f.write(_TRAILER.pack(footer_offset, len(footer), FOOTER_MAGIC))
+        self.f.close()
+        self.f = None
+
+    def add_instance(self, name, records):
+        """
+        写入一个instance的所有记录（记录按groupID连续排列）
+        :param name: instance名
+        :param records: 03_make_data.py生成的节点记录列表
+        """
+        if self.f is None or len(self.index) >= self.instances_per_shard:
+            self._close_shard()
+            self._open_shard()
+
+        groups = []
+        nrecords = 0
+        npos = 0
+        for group_id, group_records in groupby(records, lambda x: x["groupID"]):
+            group_records = list(group_records)
+            offset = self.f.tell()
+            data = _encode_group(group_id, group_records)
+            self.f.write(data)
+            group_npos = sum(r["label"]["value"] for r in group_records)
+            groups.append([offset, len(data), len(group_records), group_npos])
+            nrecords += len(group_records)
+            npos += group_npos
+
+        self.index.append({
+            "name": name,
+            "nrecords": nrecords,
+            "npos": npos,
+            "groups": groups,
+        })
+
+    def close(self):
+        self._close_shard()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+
+def read_footer(shard_path):
+    """
+    只读取分片末尾的索引
+    :param shard_path
+    :return: 分片版本, instance索引列表
+    """
+    with open(shard_path, "rb") as f:
+        magic, version = _HEADER.unpack(f.read(_HEADER.size))
+        assert magic == MAGIC, "not a trj shard: %s" % shard_path
+        assert version <= VERSION
+        f.seek(-_TRAILER.size, os.SEEK_END)
+        footer_offset, footer_len, footer_magic = _TRAILER.unpack(f.read(_TRAILER.size))
+        assert footer_magic == FOOTER_MAGIC, "truncated trj shard: %s" % shard_path
+        f.seek(footer_offset)
+        footer = json.loads(f.read(footer_len).decode("utf-8"))
+    return version, footer["instances"]
+
+
+class TrjStore():
+    """
+    分片trj存储的随机访问读取器
+    """
+    def __init__(self, path):
+        if os.path.isdir(path):
+            self.shards = sorted(os.path.join(path, p) for p in os.listdir(path) if p.endswith(SHARD_SUFFIX))
+        else:
+            self.shards = [path]
+        self.instances = {}
+        self.names = []
+        self.versions = {}
+        for shard in self.shards:
+            version, entries = read_footer(shard)
+            self.versions[shard] = version
+            for entry in entries:
+                entry["shard"] = shard
+                self.instances[entry["name"]] = entry
+                self.names.append(entry["name"])
+        self._files = {}
+
+    def _file(self, shard):
+        if shard not in self._files:
+            self._files[shard] = open(shard, "rb")
+        return self._files[shard]
+
+    def close(self):
+        for f in self._files.values():
+            f.close()
+        self._files = {}
+
+    def num_groups(self, name):
+        return len(self.instances[name]["groups"])
+
+    def read_group(self, name, group_no):
+        """
+        随机读取某个instance的第group_no个group
+        """
+        entry = self.instances[name]
+        offset, nbytes, _, _ = entry["groups"][group_no]
+        f = self._file(entry["shard"])
+        f.seek(offset)
+        return _decode_group(f.read(nbytes), self.versions[entry["shard"]])
+
+    def read_instance(self, name):
+        """
+        读取某个instance的所有记录，格式与旧pickle中的一项相同
+        """
+        entry = self.instances[name]
+        if len(entry["groups"]) == 0:
+            return []
+        first = entry["groups"][0][0]
+        last = entry["groups"][-1]
+        f = self._file(entry["shard"])
+        f.seek(first)
+        buf = f.read(last[0] + last[1] - first)
+        records = []
+        for offset, nbytes, _, _ in entry["groups"]:
+            records.extend(_decode_group(buf[offset - first:offset - first + nbytes], self.versions[entry["shard"]]))
+        return records
+
+    def split(self, test_ins_length, shuffle=False, seed=0):
+        """
+        按instance划分测试集和训练集
+        :param test_ins_length: 测试集instance个数
+        :return: test_names, train_names
+        """
+        names = list(self.names)
+        if shuffle:
+            random.Random(seed).shuffle(names)
+        return names[:test_ins_length], names[test_ins_length:]
+
+    def shard_slice(self, worker_id, num_workers):
+        """
+        并行读取时每个worker负责互不相交的分片
+        :return: 该worker负责的instance名
+        """
+        my_shards = set(self.shards[worker_id::num_workers])
+        return [n for n in self.names if self.instances[n]["shard"] in my_shards]
@@ -3,3 +3,5 @@ TYPE_STRING = 1
 TYPE_TWODOUBLES = 2
 TYPE_ARRAY = 3
 TYPE_DOUBLEANDNUMPY = 4
+TYPE_ASYNCARRAY = 6
+TYPE_PRUNEARRAY = 7
@@ -0,0 +1,720 @@
+/**@file   aiowriter.c
+ * @brief  methods for asynchronous file writers
+ *
+ * Text is formatted directly into one of a few fixed buffers. When a buffer is full it is handed to the kernel and the
+ * next free buffer is filled, so formatting and disk I/O overlap and each system call writes a whole buffer.
+ *
+ * On Linux, io_uring is set up with raw system calls (no liburing needed): the buffers are registered once, full
+ * buffers are queued as fixed-buffer writes at explicit file offsets, and queued writes are entered in batches. If
+ * io_uring is not available (old kernel, seccomp, locked memory limit) or the output cannot be written at explicit
+ * offsets (pipe, terminal, O_APPEND), full buffers are written synchronously with pwrite (or write). Compile with
+ * -DNO_IOURING to always use the fallback.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "scip/def.h"
+#include "aiowriter.h"
+
+#if defined(__linux__) && !defined(NO_IOURING)
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup)
+#define AIO_URING
+#include <sys/mman.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#define AIO_NBUFFERS       8                 /**< number of buffers of a writer */
+#define AIO_BUFFERSIZE     (1 << 16)         /**< size of each buffer in bytes */
+#define AIO_BATCHSIZE      4                 /**< queued writes entered with one system call */
+
+#define bufferMem(writer, b)   (&(writer)->mem[(size_t)(b) * (size_t)(writer)->buffersize])
+
+/** write a buffer synchronously, retrying short writes */
+static
+void syncWrite(
+   SCIP_AIOWRITER*    writer,
+   const char*        data,
+   size_t             len,
+   int64_t            offset              /**< file offset (ignored if fd is not seekable) */
+   )
+{
+   ssize_t ret;
+
+   while( len > 0 )
+   {
+      if( writer->seekable )
+         ret = pwrite(writer->fd, data, len, (off_t)offset);
+      else
+         ret = write(writer->fd, data, len);
+      writer->nsyscalls++;
+
+      if( ret < 0 )
+      {
+         if( errno == EINTR )
+            continue;
+         writer->error = TRUE;
+         return;
+      }
+      data += ret;
+      len -= (size_t)ret;
+      offset += ret;
+   }
+}
+
+#ifdef AIO_URING
+
+/** set up io_uring with one submission entry per buffer and register the buffers */
+static
+SCIP_Bool ringSetup(
+   SCIP_AIOWRITER*    writer
+   )
+{
+   SCIP_AIORING* ring = &writer->ring;
+   struct io_uring_params params;
+   struct iovec* iovs;
+   int b;
+
+   memset(&params, 0, sizeof(params));
+   ring->fd = (int)syscall(__NR_io_uring_setup, (unsigned)writer->nbuffers, &params);
+   if( ring->fd < 0 )
+      return FALSE;
+
+   ring->sqsize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+   ring->cqsize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+   if( params.features & IORING_FEAT_SINGLE_MMAP )
+   {
+      ring->sqsize = MAX(ring->sqsize, ring->cqsize);
+      ring->cqsize = ring->sqsize;
+   }
+
+   ring->sqptr = mmap(NULL, ring->sqsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+      IORING_OFF_SQ_RING);
+   if( ring->sqptr == MAP_FAILED )
+   {
+      ring->sqptr = NULL;
+      return FALSE;
+   }
+
+   if( params.features & IORING_FEAT_SINGLE_MMAP )
+      ring->cqptr = ring->sqptr;
+   else
+   {
+      ring->cqptr = mmap(NULL, ring->cqsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+         IORING_OFF_CQ_RING);
+      if( ring->cqptr == MAP_FAILED )
+      {
+         ring->cqptr = NULL;
+         return FALSE;
+      }
+   }
+
+   ring->sqessize = params.sq_entries * sizeof(struct io_uring_sqe);
+   ring->sqes = mmap(NULL, ring->sqessize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+      IORING_OFF_SQES);
+   if( ring->sqes == MAP_FAILED )
+   {
+      ring->sqes = NULL;
+      return FALSE;
+   }
+
+   ring->sqhead = (unsigned*)((char*)ring->sqptr + params.sq_off.head);
+   ring->sqtail = (unsigned*)((char*)ring->sqptr + params.sq_off.tail);
+   ring->sqmask = (unsigned*)((char*)ring->sqptr + params.sq_off.ring_mask);
+   ring->sqarray = (unsigned*)((char*)ring->sqptr + params.sq_off.array);
+   ring->cqhead = (unsigned*)((char*)ring->cqptr + params.cq_off.head);
+   ring->cqtail = (unsigned*)((char*)ring->cqptr + params.cq_off.tail);
+   ring->cqmask = (unsigned*)((char*)ring->cqptr + params.cq_off.ring_mask);
+   ring->cqes = (char*)ring->cqptr + params.cq_off.cqes;
+
+   /* registered buffers are pinned once instead of being mapped for every write */
+   if( BMSallocMemoryArray(&iovs, writer->nbuffers) == NULL )
+      return FALSE;
+   for( b = 0; b < writer->nbuffers; b++ )
+   {
+      iovs[b].iov_base = bufferMem(writer, b);
+      iovs[b].iov_len = (size_t)writer->buffersize;
+   }
+   if( syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iovs, (unsigned)writer->nbuffers) < 0 )
+   {
+      BMSfreeMemoryArray(&iovs);
+      return FALSE;
+   }
+   BMSfreeMemoryArray(&iovs);
+
+   return TRUE;
+}
+
+/** unmap and close the ring */
+static
+void ringFree(
+   SCIP_AIOWRITER*    writer
+   )
+{
+   SCIP_AIORING* ring = &writer->ring;
+
+   if( ring->sqes != NULL )
+      munmap(ring->sqes, ring->sqessize);
+   if( ring->cqptr != NULL && ring->cqptr != ring->sqptr )
+      munmap(ring->cqptr, ring->cqsize);
+   if( ring->sqptr != NULL )
+      munmap(ring->sqptr, ring->sqsize);
+   if( ring->fd >= 0 )
+      close(ring->fd);
+
+   memset(ring, 0, sizeof(*ring));
+   ring->fd = -1;
+}
+
+/** enter queued submissions and optionally wait for at least one completion */
+static
+void ringEnter(
+   SCIP_AIOWRITER*    writer,
+   SCIP_Bool          wait
+   )
+{
+   long ret;
+
+   do
+   {
+      ret = syscall(__NR_io_uring_enter, writer->ring.fd, (unsigned)writer->nqueued, wait ? 1U : 0U,
+         wait ? IORING_ENTER_GETEVENTS : 0U, NULL, 0);
+      writer->nsyscalls++;
+   }
+   while( ret < 0 && errno == EINTR );
+
+   if( ret < 0 )
+   {
+      writer->error = TRUE;
+      return;
+   }
+   writer->nqueued -= (int)ret;
+}
+
+/** process completed writes and release their buffers */
+static
+void ringReap(
+   SCIP_AIOWRITER*    writer
+   )
+{
+   SCIP_AIORING* ring = &writer->ring;
+   struct io_uring_cqe* cqe;
+   unsigned head;
+   unsigned tail;
+   int b;
+
+   head = *ring->cqhead;
+   tail = __atomic_load_n(ring->cqtail, __ATOMIC_ACQUIRE);
+
+   while( head != tail )
+   {
+      cqe = &((struct io_uring_cqe*)ring->cqes)[head & *ring->cqmask];
+      b = (int)cqe->user_data;
+      assert(b >= 0 && b < writer->nbuffers);
+      assert(writer->inflight[b]);
+
+      if( cqe->res < 0 )
+         writer->error = TRUE;
+      else if( cqe->res < writer->fill[b] )
+      {
+         /* finish short writes synchronously */
+         syncWrite(writer, bufferMem(writer, b) + cqe->res, (size_t)(writer->fill[b] - cqe->res),
+            writer->bufoffset[b] + cqe->res);
+      }
+
+      writer->inflight[b] = FALSE;
+      writer->fill[b] = 0;
+      writer->ninflight--;
+      head++;
+   }
+
+   __atomic_store_n(ring->cqhead, head, __ATOMIC_RELEASE);
+}
+
+/** queue a fixed-buffer write of buffer b */
+static
+void ringSubmit(
+   SCIP_AIOWRITER*    writer,
+   int                b
+   )
+{
+   SCIP_AIORING* ring = &writer->ring;
+   struct io_uring_sqe* sqe;
+   unsigned tail;
+   unsigned idx;
+
+   tail = *ring->sqtail;
+   idx = tail & *ring->sqmask;
+   sqe = &((struct io_uring_sqe*)ring->sqes)[idx];
+
+   memset(sqe, 0, sizeof(*sqe));
+   sqe->opcode = IORING_OP_WRITE_FIXED;
+   sqe->fd = writer->fd;
+   sqe->addr = (uint64_t)(uintptr_t)bufferMem(writer, b);
+   sqe->len = (unsigned)writer->fill[b];
+   sqe->off = (uint64_t)writer->bufoffset[b];
+   sqe->buf_index = (uint16_t)b;
+   sqe->user_data = (uint64_t)b;
+
+   ring->sqarray[idx] = idx;
+   __atomic_store_n(ring->sqtail, tail + 1, __ATOMIC_RELEASE);
+
+   writer->nqueued++;
+   if( writer->nqueued >= writer->batchsize )
+      ringEnter(writer, FALSE);
+}
+
+#else
+
+static
+SCIP_Bool ringSetup(
+   SCIP_AIOWRITER*    writer
+   )
+{
+   return FALSE;
+}
+
+static
+void ringFree(
+   SCIP_AIOWRITER*    writer
+   )
+{
+}
+
+static
+void ringEnter(
+   SCIP_AIOWRITER*    writer,
+   SCIP_Bool          wait
+   )
+{
+}
+
+static
+void ringReap(
+   SCIP_AIOWRITER*    writer
+   )
+{
+}
+
+static
+void ringSubmit(
+   SCIP_AIOWRITER*    writer,
+   int                b
+   )
+{
+}
+
+#endif
+
+/** hand the current buffer to the kernel (or write it) and switch to a free buffer */
+static
+void nextBuffer(
+   SCIP_AIOWRITER*    writer
+   )
+{
+   int cur = writer->cur;
+   int b;
+
+   if( writer->fill[cur] == 0 )
+      return;
+
+   writer->bufoffset[cur] = writer->offset;
+   writer->offset += writer->fill[cur];
+   writer->nbytes += writer->fill[cur];
+   writer->nwrites++;
+
+   if( !writer->useuring )
+   {
+      syncWrite(writer, bufferMem(writer, cur), (size_t)writer->fill[cur], writer->bufoffset[cur]);
+      writer->fill[cur] = 0;
+      return;
+   }
+
+   writer->inflight[cur] = TRUE;
+   writer->ninflight++;
+   ringSubmit(writer, cur);
+
+   for( ;; )
+   {
+      ringReap(writer);
+      for( b = 0; b < writer->nbuffers; b++ )
+      {
+         if( !writer->inflight[b] )
+         {
+            writer->cur = b;
+            return;
+         }
+      }
+
+      /* all buffers are in flight: wait for one of them */
+      ringEnter(writer, TRUE);
+      if( writer->error )
+         return;
+   }
+}
+
+/** allocate the buffers and set up the backend for an open file descriptor */
+static
+SCIP_RETCODE writerCreate(
+   SCIP_AIOWRITER**   writer,
+   int                fd,
+   SCIP_Bool          ownsfd,
+   SCIP_Bool          useuring
+   )
+{
+   struct stat st;
+   off_t offset;
+   int flags;
+
+   SCIP_ALLOC( BMSallocMemory(writer) );
+   BMSclearMemory(*writer);
+
+   (*writer)->fd = fd;
+   (*writer)->ownsfd = ownsfd;
+   (*writer)->nbuffers = AIO_NBUFFERS;
+   (*writer)->buffersize = AIO_BUFFERSIZE;
+   (*writer)->batchsize = AIO_BATCHSIZE;
+   (*writer)->ring.fd = -1;
+
+   /* explicit offsets are only safe for regular files that are not opened for appending */
+   flags = fcntl(fd, F_GETFL);
+   offset = lseek(fd, 0, SEEK_CUR);
+   (*writer)->seekable = (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && flags >= 0 && !(flags & O_APPEND)
+      && offset >= 0);
+   (*writer)->offset = (*writer)->seekable ? (int64_t)offset : 0;
+
+   SCIP_ALLOC( BMSallocMemoryArray(&(*writer)->mem, (size_t)(*writer)->nbuffers * (size_t)(*writer)->buffersize) );
+   SCIP_ALLOC( BMSallocMemoryArray(&(*writer)->fill, (*writer)->nbuffers) );
+   SCIP_ALLOC( BMSallocMemoryArray(&(*writer)->bufoffset, (*writer)->nbuffers) );
+   SCIP_ALLOC( BMSallocMemoryArray(&(*writer)->inflight, (*writer)->nbuffers) );
+   BMSclearMemoryArray((*writer)->fill, (*writer)->nbuffers);
+   BMSclearMemoryArray((*writer)->bufoffset, (*writer)->nbuffers);
+   BMSclearMemoryArray((*writer)->inflight, (*writer)->nbuffers);
+
+   if( useuring && (*writer)->seekable )
+   {
+      (*writer)->useuring = ringSetup(*writer);
+      if( !(*writer)->useuring )
+         ringFree(*writer);
+   }
+
+   return SCIP_OKAY;
+}
+
+/** open a writer on the given file */
+SCIP_RETCODE SCIPaiowriterCreate(
+   SCIP_AIOWRITER**   writer,
+   const char*        fname,
+   SCIP_Bool          append,
+   SCIP_Bool          useuring
+   )
+{
+   int fd;
+
+   assert(writer != NULL);
+   assert(fname != NULL);
+
+   /* not O_APPEND: appending is done by starting at the end of the file and writing at explicit offsets */
+   fd = open(fname, O_WRONLY | O_CREAT | (append ? 0 : O_TRUNC), 0644);
+   if( fd < 0 || lseek(fd, 0, SEEK_END) < 0 )
+   {
+      SCIPerrorMessage("cannot open file <%s> for writing\n", fname);
+      SCIPprintSysError(fname);
+      if( fd >= 0 )
+         close(fd);
+      return SCIP_NOFILE;
+   }
+
+   SCIP_CALL( writerCreate(writer, fd, TRUE, useuring) );
+
+   return SCIP_OKAY;
+}
+
+/** create a writer on an open file descriptor (e.g. standard output); fd is not closed by the writer */
+SCIP_RETCODE SCIPaiowriterCreateFd(
+   SCIP_AIOWRITER**   writer,
+   int                fd,
+   SCIP_Bool          useuring
+   )
+{
+   assert(writer != NULL);
+   assert(fd >= 0);
+
+   SCIP_CALL( writerCreate(writer, fd, FALSE, useuring) );
+
+   return SCIP_OKAY;
+}
+
+/** write all buffered data and wait for outstanding writes */
+SCIP_RETCODE SCIPaiowriterFlush(
+   SCIP_AIOWRITER*    writer
+   )
+{
+   assert(writer != NULL);
+
+   nextBuffer(writer);
+
+   while( writer->useuring && writer->ninflight > 0 && !writer->error )
+   {
+      ringEnter(writer, TRUE);
+      ringReap(writer);
+   }
+
+   if( writer->error )
+   {
+      SCIPerrorMessage("asynchronous write failed\n");
+      return SCIP_WRITEERROR;
+   }
+
+   return SCIP_OKAY;
+}
+
+/** write all buffered data, wait for outstanding writes and free the writer */
+SCIP_RETCODE SCIPaiowriterFree(
+   SCIP_AIOWRITER**   writer
+   )
+{
+   SCIP_RETCODE retcode;
+
+   assert(writer != NULL);
+   assert(*writer != NULL);
+
+   retcode = SCIPaiowriterFlush(*writer);
+
+   SCIPdebugMessage("aiowriter: %"SCIP_LONGINT_FORMAT" bytes in %"SCIP_LONGINT_FORMAT" writes, "
+      "%"SCIP_LONGINT_FORMAT" system calls (%s)\n", (*writer)->nbytes, (*writer)->nwrites, (*writer)->nsyscalls,
+      (*writer)->useuring ? "io_uring" : "pwrite");
+
+   if( (*writer)->useuring )
+      ringFree(*writer);
+
+   /* leave the file position behind the written data for whoever writes to fd next */
+   if( (*writer)->seekable )
+      (void)lseek((*writer)->fd, (off_t)(*writer)->offset, SEEK_SET);
+   if( (*writer)->ownsfd )
+      close((*writer)->fd);
+
+   BMSfreeMemoryArray(&(*writer)->mem);
+   BMSfreeMemoryArray(&(*writer)->fill);
+   BMSfreeMemoryArray(&(*writer)->bufoffset);
+   BMSfreeMemoryArray(&(*writer)->inflight);
+   BMSfreeMemory(writer);
+
+   return retcode;
+}
+
+/** append data; errors are kept and reported by the next flush */
+void SCIPaiowriterWrite(
+   SCIP_AIOWRITER*    writer,
+   const char*        data,
+   int                len
+   )
+{
+   int n;
+
+   assert(writer != NULL);
+   assert(data != NULL || len == 0);
+
+   /* after a failed write the output is incomplete anyway; the buffers may still be owned by the kernel */
+   if( writer->error )
+      return;
+
+   while( len > 0 )
+   {
+      n = MIN(len, writer->buffersize - writer->fill[writer->cur]);
+      memcpy(bufferMem(writer, writer->cur) + writer->fill[writer->cur], data, (size_t)n);
+      writer->fill[writer->cur] += n;
+      data += n;
+      len -= n;
+
+      if( writer->fill[writer->cur] == writer->buffersize )
+         nextBuffer(writer);
+   }
+}
+
+/** append formatted text from a variable argument list */
+void SCIPaiowriterVPrintf(
+   SCIP_AIOWRITER*    writer,
+   const char*        formatstr,
+   va_list            ap
+   )
+{
+   va_list aq;
+   char* buf;
+   int space;
+   int n;
+
+   assert(writer != NULL);
+
+   if( writer->error )
+      return;
+
+   /* format in place; if the text does not fit, move to the next buffer and format again */
+   space = writer->buffersize - writer->fill[writer->cur];
+   va_copy(aq, ap);
+   n = vsnprintf(bufferMem(writer, writer->cur) + writer->fill[writer->cur], (size_t)space, formatstr, aq);
+   va_end(aq);
+
+   if( n < 0 )
+   {
+      writer->error = TRUE;
+      return;
+   }
+   if( n < space )
+   {
+      writer->fill[writer->cur] += n;
+      return;
+   }
+
+   if( n < writer->buffersize )
+   {
+      nextBuffer(writer);
+      va_copy(aq, ap);
+      n = vsnprintf(bufferMem(writer, writer->cur), (size_t)writer->buffersize, formatstr, aq);
+      va_end(aq);
+      writer->fill[writer->cur] = n;
+      return;
+   }
+
+   /* longer than a buffer */
+   if( BMSallocMemoryArray(&buf, n + 1) == NULL )
+   {
+      writer->error = TRUE;
+      return;
+   }
+   va_copy(aq, ap);
+   (void)vsnprintf(buf, (size_t)n + 1, formatstr, aq);
+   va_end(aq);
+   SCIPaiowriterWrite(writer, buf, n);
+   BMSfreeMemoryArray(&buf);
+}
+
+/** append formatted text; errors are kept and reported by the next flush */
+void SCIPaiowriterPrintf(
+   SCIP_AIOWRITER*    writer,
+   const char*        formatstr,
+   ...
+   )
+{
+   va_list ap;
+
+   va_start(ap, formatstr);
+   SCIPaiowriterVPrintf(writer, formatstr, ap);
+   va_end(ap);
+}
+
+/** print writer statistics */
+void SCIPaiowriterPrintStatistics(
+   SCIP*              scip,
+   SCIP_AIOWRITER*    writer,
+   const char*        name,
+   FILE*              file
+   )
+{
+   assert(scip != NULL);
+   assert(writer != NULL);
+
+   SCIPinfoMessage(scip, file, "Async writer <%s> : %s, %"SCIP_LONGINT_FORMAT" bytes, %"SCIP_LONGINT_FORMAT" writes, "
+      "%"SCIP_LONGINT_FORMAT" system calls\n", name, writer->useuring ? "io_uring" : "pwrite", writer->nbytes,
+      writer->nwrites, writer->nsyscalls);
+}
+
+/*
+ * standard output
+ */
+
+#ifdef __GLIBC__
+
+static SCIP_AIOWRITER* stdoutwriter = NULL;   /**< writer behind the captured stdout */
+static FILE* savedstdout = NULL;              /**< stdout before it was captured */
+
+/** write function of the stdout cookie stream */
+static
+ssize_t stdoutWrite(
+   void*              cookie,
+   const char*        buf,
+   size_t             size
+   )
+{
+   SCIPaiowriterWrite((SCIP_AIOWRITER*)cookie, buf, (int)size);
+   return (ssize_t)size;
+}
+
+/** route standard output (and with it the solver log) through an asynchronous writer */
+SCIP_RETCODE SCIPaiowriterCaptureStdout(
+   SCIP_Bool          useuring
+   )
+{
+   cookie_io_functions_t funcs;
+   FILE* stream;
+
+   if( stdoutwriter != NULL )
+      return SCIP_OKAY;
+
+   fflush(stdout);
+   SCIP_CALL( SCIPaiowriterCreateFd(&stdoutwriter, STDOUT_FILENO, useuring) );
+
+   memset(&funcs, 0, sizeof(funcs));
+   funcs.write = stdoutWrite;
+   stream = fopencookie(stdoutwriter, "w", funcs);
+   if( stream == NULL )
+   {
+      SCIP_CALL( SCIPaiowriterFree(&stdoutwriter) );
+      return SCIP_OKAY;
+   }
+
+   /* fflush() after each message (as done by the message handler) now only copies into the writer's buffer */
+   savedstdout = stdout;
+   stdout = stream;
+
+   return SCIP_OKAY;
+}
+
+/** write the remaining output and restore standard output */
+SCIP_RETCODE SCIPaiowriterReleaseStdout(
+   void
+   )
+{
+   if( stdoutwriter == NULL )
+      return SCIP_OKAY;
+
+   fclose(stdout);
+   stdout = savedstdout;
+   savedstdout = NULL;
+
+   SCIP_CALL( SCIPaiowriterFree(&stdoutwriter) );
+
+   return SCIP_OKAY;
+}
+
+#else
+
+/** route standard output (and with it the solver log) through an asynchronous writer */
+SCIP_RETCODE SCIPaiowriterCaptureStdout(
+   SCIP_Bool          useuring
+   )
+{
+   /* stdout cannot be replaced by a custom stream without glibc */
+   return SCIP_OKAY;
+}
+
+/** write the remaining output and restore standard output */
+SCIP_RETCODE SCIPaiowriterReleaseStdout(
+   void
+   )
+{
+   return SCIP_OKAY;
+}
+
+#endif
@@ -0,0 +1,101 @@
+/**@file   aiowriter.h
+ * @brief  internal methods for asynchronous file writers
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_AIOWRITER_H__
+#define __SCIP_AIOWRITER_H__
+
+#include <stdarg.h>
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_aiowriter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** open a writer on the given file */
+extern
+SCIP_RETCODE SCIPaiowriterCreate(
+   SCIP_AIOWRITER**   writer,
+   const char*        fname,
+   SCIP_Bool          append,             /**< append to the file instead of truncating it? */
+   SCIP_Bool          useuring            /**< try io_uring before falling back to pwrite? */
+   );
+
+/** create a writer on an open file descriptor (e.g. standard output); fd is not closed by the writer */
+extern
+SCIP_RETCODE SCIPaiowriterCreateFd(
+   SCIP_AIOWRITER**   writer,
+   int                fd,
+   SCIP_Bool          useuring            /**< try io_uring before falling back to pwrite? */
+   );
+
+/** write all buffered data, wait for outstanding writes and free the writer */
+extern
+SCIP_RETCODE SCIPaiowriterFree(
+   SCIP_AIOWRITER**   writer
+   );
+
+/** write all buffered data and wait for outstanding writes */
+extern
+SCIP_RETCODE SCIPaiowriterFlush(
+   SCIP_AIOWRITER*    writer
+   );
+
+/** append data; errors are kept and reported by the next flush */
+extern
+void SCIPaiowriterWrite(
+   SCIP_AIOWRITER*    writer,
+   const char*        data,
+   int                len
+   );
+
+/** append formatted text; errors are kept and reported by the next flush */
+extern
+void SCIPaiowriterPrintf(
+   SCIP_AIOWRITER*    writer,
+   const char*        formatstr,
+   ...
+   );
+
+/** append formatted text from a variable argument list */
+extern
+void SCIPaiowriterVPrintf(
+   SCIP_AIOWRITER*    writer,
+   const char*        formatstr,
+   va_list            ap
+   );
+
+/** print writer statistics */
+extern
+void SCIPaiowriterPrintStatistics(
+   SCIP*              scip,
+   SCIP_AIOWRITER*    writer,
+   const char*        name,
+   FILE*              file
+   );
+
+/** route standard output (and with it the solver log) through an asynchronous writer
+ *
+ *  All output to stdout, including messages printed by SCIP and printf, is collected in the writer's buffers; the
+ *  writer is the only one writing to the file descriptor.
+ */
+extern
+SCIP_RETCODE SCIPaiowriterCaptureStdout(
+   SCIP_Bool          useuring            /**< try io_uring before falling back to pwrite? */
+   );
+
+/** write the remaining output and restore standard output */
+extern
+SCIP_RETCODE SCIPaiowriterReleaseStdout(
+   void
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
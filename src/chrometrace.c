@@ -0,0 +1,276 @@
+/**@file   chrometrace.c
+ * @brief  methods for the Chrome trace-event export of the solve timeline
+ *
+ * The file uses the JSON array format of the trace-event specification ("[" followed by comma-separated events);
+ * the closing bracket is written at exit but viewers also accept a file cut short by a crash. Spans are complete
+ * events ("ph":"X"), counters are "ph":"C" events, times are in microseconds since the trace was opened.
+ *
+ * LP solves have no start event in SCIP, so an LP span ends at the LP solved event and lasts as long as the LP clocks
+ * advanced since the previous one.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <unistd.h>
+#include "scip/def.h"
+#include "scip/clock.h"
+#include "scip/struct_scip.h"
+#include "scip/struct_stat.h"
+#include "profile.h"
+#include "chrometrace.h"
+
+#define EVENTHDLR_NAME     "chrometrace"
+#define EVENTHDLR_DESC     "event handler adding LP solves and counter tracks to the Chrome trace"
+
+#define CHROMETRACE_INFINITY   1e+20    /**< counter values at least this large are left out */
+
+static SCIP_CHROMETRACE* ctrace = NULL;   /**< timeline of this process, or NULL */
+
+/** write one event */
+static
+void writeEvent(
+   SCIP_CTEVENT*      event
+   )
+{
+   int pid = (int)getpid();
+   int nargs = 0;
+   int a;
+
+   if( ctrace->nwritten > 0 )
+      fputs(",\n", ctrace->file);
+
+   if( event->dur >= 0 )
+   {
+      fprintf(ctrace->file, "{\"name\":\"%s\",\"cat\":\"scipdagger\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+         "\"pid\":%d,\"tid\":1}", event->name, event->ts / 1e3, event->dur / 1e3, pid);
+   }
+   else
+   {
+      fprintf(ctrace->file, "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{", event->name,
+         event->ts / 1e3, pid);
+      for( a = 0; a < 2; a++ )
+      {
+         if( event->argname[a] == NULL || REALABS(event->val[a]) >= CHROMETRACE_INFINITY )
+            continue;
+         fprintf(ctrace->file, "%s\"%s\":%.15g", nargs > 0 ? "," : "", event->argname[a], event->val[a]);
+         nargs++;
+      }
+      fputs("}}", ctrace->file);
+   }
+
+   ctrace->nwritten++;
+}
+
+/** write and empty the event buffer */
+static
+void flushEvents(
+   void
+   )
+{
+   int e;
+
+   for( e = 0; e < ctrace->nevents; e++ )
+      writeEvent(&ctrace->events[e]);
+   ctrace->nevents = 0;
+}
+
+/** get a free slot in the event buffer, writing the buffer if it is full */
+static
+SCIP_CTEVENT* nextEvent(
+   void
+   )
+{
+   if( ctrace->nevents == ctrace->size )
+      flushEvents();
+
+   return &ctrace->events[ctrace->nevents++];
+}
+
+/** open the timeline, overwriting the given file */
+SCIP_RETCODE SCIPchrometraceOpen(
+   const char*        fname,
+   int                bufsize
+   )
+{
+   assert(fname != NULL);
+   assert(bufsize > 0);
+
+   if( ctrace != NULL )
+      return SCIP_OKAY;
+
+   SCIP_ALLOC( BMSallocMemory(&ctrace) );
+   ctrace->file = fopen(fname, "w");
+   if( ctrace->file == NULL )
+   {
+      SCIPerrorMessage("cannot open trace file <%s> for writing\n", fname);
+      SCIPprintSysError(fname);
+      BMSfreeMemory(&ctrace);
+      return SCIP_NOFILE;
+   }
+   SCIP_ALLOC( BMSallocMemoryArray(&ctrace->events, bufsize) );
+   ctrace->nevents = 0;
+   ctrace->size = bufsize;
+   ctrace->origin = SCIPprofileStart();
+   ctrace->nwritten = 0;
+   ctrace->lplast = 0.0;
+
+   fprintf(ctrace->file, "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"scipdagger\"}}",
+      (int)getpid());
+   ctrace->nwritten++;
+
+   return SCIP_OKAY;
+}
+
+/** write the remaining events and close the timeline */
+void SCIPchrometraceClose(
+   void
+   )
+{
+   if( ctrace == NULL )
+      return;
+
+   flushEvents();
+   fputs("\n]\n", ctrace->file);
+   fclose(ctrace->file);
+
+   BMSfreeMemoryArray(&ctrace->events);
+   BMSfreeMemory(&ctrace);
+}
+
+/** is the timeline open? */
+SCIP_Bool SCIPchrometraceIsOn(
+   void
+   )
+{
+   return ctrace != NULL;
+}
+
+/** add a span */
+void SCIPchrometraceSpan(
+   const char*        name,
+   SCIP_Longint       start,
+   SCIP_Longint       end
+   )
+{
+   SCIP_CTEVENT* event;
+
+   assert(name != NULL);
+
+   if( ctrace == NULL )
+      return;
+
+   event = nextEvent();
+   event->name = name;
+   event->ts = start - ctrace->origin;
+   event->dur = MAX(end - start, 0);
+}
+
+/** add a sample of a counter track with up to two series */
+void SCIPchrometraceCounter(
+   const char*        name,
+   const char*        argname0,
+   SCIP_Real          val0,
+   const char*        argname1,
+   SCIP_Real          val1
+   )
+{
+   SCIP_CTEVENT* event;
+
+   assert(name != NULL);
+   assert(argname0 != NULL);
+
+   if( ctrace == NULL )
+      return;
+
+   event = nextEvent();
+   event->name = name;
+   event->argname[0] = argname0;
+   event->val[0] = val0;
+   event->argname[1] = argname1;
+   event->val[1] = val1;
+   event->ts = SCIPprofileStart() - ctrace->origin;
+   event->dur = -1;
+}
+
+/** total time spent in LP solves */
+static
+SCIP_Real getLPTime(
+   SCIP*              scip
+   )
+{
+   return SCIPclockGetTime(scip->stat->primallptime) + SCIPclockGetTime(scip->stat->duallptime)
+      + SCIPclockGetTime(scip->stat->lexduallptime) + SCIPclockGetTime(scip->stat->barrierlptime);
+}
+
+/** initialization method of event handler (called after problem was transformed) */
+static
+SCIP_DECL_EVENTINITSOL(eventInitsolChrometrace)
+{
+   assert(scip != NULL);
+   assert(eventhdlr != NULL);
+
+   if( ctrace != NULL )
+      ctrace->lplast = getLPTime(scip);
+
+   SCIP_CALL( SCIPcatchEvent(scip, SCIP_EVENTTYPE_LPSOLVED | SCIP_EVENTTYPE_NODESOLVED, eventhdlr, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
+
+/** solving process deinitialization method of event handler (called before branch and bound process data is freed) */
+static
+SCIP_DECL_EVENTEXITSOL(eventExitsolChrometrace)
+{
+   assert(scip != NULL);
+   assert(eventhdlr != NULL);
+
+   SCIP_CALL( SCIPdropEvent(scip, SCIP_EVENTTYPE_LPSOLVED | SCIP_EVENTTYPE_NODESOLVED, eventhdlr, NULL, -1) );
+
+   return SCIP_OKAY;
+}
+
+/** execution method of event handler */
+static
+SCIP_DECL_EVENTEXEC(eventExecChrometrace)
+{
+   SCIP_Longint now;
+   SCIP_Real lptime;
+
+   assert(scip != NULL);
+   assert(eventhdlr != NULL);
+
+   if( ctrace == NULL )
+      return SCIP_OKAY;
+
+   if( SCIPeventGetType(event) & SCIP_EVENTTYPE_LPSOLVED )
+   {
+      now = SCIPprofileStart();
+      lptime = getLPTime(scip);
+      SCIPchrometraceSpan("lp", now - (SCIP_Longint)((lptime - ctrace->lplast) * 1e9), now);
+      ctrace->lplast = lptime;
+   }
+   else
+   {
+      SCIPchrometraceCounter("bounds", "primal", SCIPgetPrimalbound(scip), "dual", SCIPgetDualbound(scip));
+      SCIPchrometraceCounter("open nodes", "open", (SCIP_Real)SCIPgetNNodesLeft(scip), NULL, 0.0);
+   }
+
+   return SCIP_OKAY;
+}
+
+/** creates the event handler that adds LP solves and counter tracks and includes it in SCIP */
+SCIP_RETCODE SCIPincludeEventhdlrChrometrace(
+   SCIP*              scip
+   )
+{
+   SCIP_EVENTHDLR* eventhdlr = NULL;
+
+   SCIP_CALL( SCIPincludeEventhdlrBasic(scip, &eventhdlr, EVENTHDLR_NAME, EVENTHDLR_DESC, eventExecChrometrace,
+         NULL) );
+   assert(eventhdlr != NULL);
+
+   SCIP_CALL( SCIPsetEventhdlrInitsol(scip, eventhdlr, eventInitsolChrometrace) );
+   SCIP_CALL( SCIPsetEventhdlrExitsol(scip, eventhdlr, eventExitsolChrometrace) );
+
+   return SCIP_OKAY;
+}
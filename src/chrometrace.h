@@ -0,0 +1,69 @@
+/**@file   chrometrace.h
+ * @brief  internal methods for the Chrome trace-event export of the solve timeline
+ *
+ * There is one timeline per process; it is opened by the shell, the profiled phases of the plugins and the select
+ * callbacks add spans, and an event handler adds LP solves and the bound and open-node counter tracks. The file can
+ * be opened in chrome://tracing or ui.perfetto.dev.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_CHROMETRACE_H__
+#define __SCIP_CHROMETRACE_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_chrometrace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** open the timeline, overwriting the given file */
+extern
+SCIP_RETCODE SCIPchrometraceOpen(
+   const char*        fname,
+   int                bufsize             /**< number of events buffered between two writes */
+   );
+
+/** write the remaining events and close the timeline */
+extern
+void SCIPchrometraceClose(
+   void
+   );
+
+/** is the timeline open? */
+extern
+SCIP_Bool SCIPchrometraceIsOn(
+   void
+   );
+
+/** add a span; start and end are monotonic clock times as returned by SCIPprofileStart() */
+extern
+void SCIPchrometraceSpan(
+   const char*        name,               /**< string literal */
+   SCIP_Longint       start,
+   SCIP_Longint       end
+   );
+
+/** add a sample of a counter track with up to two series */
+extern
+void SCIPchrometraceCounter(
+   const char*        name,               /**< string literal */
+   const char*        argname0,           /**< string literal */
+   SCIP_Real          val0,
+   const char*        argname1,           /**< string literal, or NULL */
+   SCIP_Real          val1
+   );
+
+/** creates the event handler that adds LP solves and counter tracks and includes it in SCIP */
+extern
+SCIP_RETCODE SCIPincludeEventhdlrChrometrace(
+   SCIP*              scip
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,6 +15,11 @@
 #include "nodepru_oracle.h"
 #include "nodepru_dagger.h"
 #include "nodepru_policy.h"
+#include "aiowriter.h"
+#include "trace.h"
+#include "livestat.h"
+#include "chrometrace.h"
+#include "memacct.h"
 
 /* disable heuristics */
 static
@@ -143,6 +148,9 @@ SCIP_RETCODE fromCommandLine(
          SCIPnodeprudaggerPrintStatistics(scip, nodepru, NULL);
    }
 
+   /* memory of the plugins */
+   SCIPmemacctPrint(scip, NULL);
+
    return SCIP_OKAY;
 }
 
@@ -164,11 +172,19 @@ SCIP_RETCODE processShellArguments(
    char* nodeselname = NULL;
    char* nodeseltrj = NULL;
    char* nodeselpol= NULL;
+   char* evtfname = NULL;                    /**< binary solve-event log of the node selector */
+   char* samplefname = NULL;                 /**< open-node queue samples of the node selector */
+   char* chromefname = NULL;                 /**< solve timeline in Chrome trace-event format */
+   char* statsfname = NULL;                  /**< per-phase timing statistics of the node selector and pruner */
+   int tracelevel = -1;                      /**< trace level of the node selector's text log (-1: parameter default) */
    char* nodepruname = NULL;
    char* nodeprutrj = NULL;
    char* nodeprupol= NULL;
    SCIP_Bool solrequired = FALSE;
    SCIP_Bool quiet;
+   SCIP_Bool aio = FALSE;                    /**< write log and trajectories asynchronously */
+   SCIP_Bool perfcounters = FALSE;           /**< count hardware events in the node selector and pruner */
+   SCIP_Bool live = FALSE;                   /**< publish live metrics in shared memory */
    int freq = 1;                             /**< frequency of heuristics and separators */ 
    SCIP_Longint nodelimit = -1;              /**< maximum number of nodes to process */
    SCIP_Real timelimit = -1;                 /**< maximum number of nodes to process */
@@ -207,6 +223,12 @@ SCIP_RETCODE processShellArguments(
       }
       else if( strcmp(argv[i], "-q") == 0 )
          quiet = TRUE;
+      else if( strcmp(argv[i], "--aio") == 0 )
+         aio = TRUE;
+      else if( strcmp(argv[i], "--perf") == 0 )
+         perfcounters = TRUE;
+      else if( strcmp(argv[i], "--live") == 0 )
+         live = TRUE;
       else if( strcmp(argv[i], "-r") == 0 )
       {
          i++;
@@ -351,6 +373,72 @@ SCIP_RETCODE processShellArguments(
             paramerror = TRUE;
          }
       }
+      else if( strcmp(argv[i], "--treesample") == 0 )
+      {
+         i++;
+         if( i < argc )
+            samplefname = argv[i];
+         else
+         {
+            printf("missing sample filename after parameter '--treesample'\n");
+            paramerror = TRUE;
+         }
+      }
+      else if( strcmp(argv[i], "--chrometrace") == 0 )
+      {
+         i++;
+         if( i < argc )
+            chromefname = argv[i];
+         else
+         {
+            printf("missing trace filename after parameter '--chrometrace'\n");
+            paramerror = TRUE;
+         }
+      }
+      else if( strcmp(argv[i], "--evtlog") == 0 )
+      {
+         i++;
+         if( i < argc )
+            evtfname = argv[i];
+         else
+         {
+            printf("missing event log filename after parameter '--evtlog'\n");
+            paramerror = TRUE;
+         }
+      }
+      else if( strcmp(argv[i], "--tracelevel") == 0 )
+      {
+         i++;
+         if( i < argc )
+            tracelevel = atoi(argv[i]);
+         else
+         {
+            printf("missing trace level after parameter '--tracelevel'\n");
+            paramerror = TRUE;
+         }
+      }
+      else if( strcmp(argv[i], "--memcap") == 0 )
+      {
+         i++;
+         if( i < argc )
+            SCIPmemacctSetSoftCap((SCIP_Longint)(atof(argv[i]) * 1048576.0));
+         else
+         {
+            printf("missing soft memory cap after parameter '--memcap'\n");
+            paramerror = TRUE;
+         }
+      }
+      else if( strcmp(argv[i], "--stats") == 0 )
+      {
+         i++;
+         if( i < argc )
+            statsfname = argv[i];
+         else
+         {
+            printf("missing statistics filename after parameter '--stats'\n");
+            paramerror = TRUE;
+         }
+      }
       else if( strcmp(argv[i], "--nodeseltrj") == 0 )
       {
          i++;
@@ -386,6 +474,23 @@ SCIP_RETCODE processShellArguments(
          SCIPsetMessagehdlrQuiet(scip, quiet);
       }
 
+      if( aio )
+      {
+         SCIP_CALL( SCIPaiowriterCaptureStdout(TRUE) );
+      }
+
+      if( live )
+      {
+         SCIP_CALL( SCIPlivestatOpen(NULL) );
+         SCIP_CALL( SCIPincludeEventhdlrLivestat(scip) );
+      }
+
+      if( chromefname != NULL )
+      {
+         SCIP_CALL( SCIPchrometraceOpen(chromefname, 65536) );
+         SCIP_CALL( SCIPincludeEventhdlrChrometrace(scip) );
+      }
+
       if( freq < 1 )
       {
          /* use most infeasible branching */
@@ -463,6 +568,7 @@ SCIP_RETCODE processShellArguments(
             SCIP_CALL( SCIPsetStringParam(scip, "nodeselection/oracle/solfname", solfname) );
             if( nodeseltrj != NULL )
                SCIP_CALL( SCIPsetStringParam(scip, "nodeselection/oracle/trjfname", nodeseltrj) );
+            SCIP_CALL( SCIPsetBoolParam(scip, "nodeselection/oracle/trjaio", aio) );
          }
          else if( strcmp(nodeselname, "dagger") == 0 )
          {
@@ -487,6 +593,67 @@ SCIP_RETCODE processShellArguments(
             /* use specified node selector */
             SCIP_NODESEL* nodesel = SCIPfindNodesel( scip, nodeselname );
             SCIP_CALL( SCIPsetNodeselStdPriority( scip, nodesel, 9999999 ) );
+
+            if( evtfname != NULL )
+            {
+               char paramname[SCIP_MAXSTRLEN];
+               (void) SCIPsnprintf(paramname, SCIP_MAXSTRLEN, "nodeselection/%s/evtfname", nodeselname);
+               SCIP_CALL( SCIPsetStringParam(scip, paramname, evtfname) );
+            }
+
+            if( samplefname != NULL )
+            {
+               char paramname[SCIP_MAXSTRLEN];
+               (void) SCIPsnprintf(paramname, SCIP_MAXSTRLEN, "nodeselection/%s/samplefname", nodeselname);
+               if( SCIPgetParam(scip, paramname) != NULL )
+                  SCIP_CALL( SCIPsetStringParam(scip, paramname, samplefname) );
+            }
+
+            if( tracelevel >= 0 )
+            {
+               char paramname[SCIP_MAXSTRLEN];
+               (void) SCIPsnprintf(paramname, SCIP_MAXSTRLEN, "nodeselection/%s/tracelevel", nodeselname);
+               if( SCIPgetParam(scip, paramname) != NULL )
+                  SCIP_CALL( SCIPsetIntParam(scip, paramname, tracelevel) );
+            }
+         }
+      }
+
+      /* only the policy and dagger plugins time their phases */
+      if( statsfname != NULL )
+      {
+         char paramname[SCIP_MAXSTRLEN];
+
+         if( nodeselname != NULL )
+         {
+            (void) SCIPsnprintf(paramname, SCIP_MAXSTRLEN, "nodeselection/%s/statsfname", nodeselname);
+            if( SCIPgetParam(scip, paramname) != NULL )
+               SCIP_CALL( SCIPsetStringParam(scip, paramname, statsfname) );
+         }
+         if( nodepruname != NULL )
+         {
+            (void) SCIPsnprintf(paramname, SCIP_MAXSTRLEN, "nodepruning/%s/statsfname", nodepruname);
+            if( SCIPgetParam(scip, paramname) != NULL )
+               SCIP_CALL( SCIPsetStringParam(scip, paramname, statsfname) );
+         }
+      }
+
+      /* likewise only they count hardware events */
+      if( perfcounters )
+      {
+         char paramname[SCIP_MAXSTRLEN];
+
+         if( nodeselname != NULL )
+         {
+            (void) SCIPsnprintf(paramname, SCIP_MAXSTRLEN, "nodeselection/%s/perfcounters", nodeselname);
+            if( SCIPgetParam(scip, paramname) != NULL )
+               SCIP_CALL( SCIPsetBoolParam(scip, paramname, TRUE) );
+         }
+         if( nodepruname != NULL )
+         {
+            (void) SCIPsnprintf(paramname, SCIP_MAXSTRLEN, "nodepruning/%s/perfcounters", nodepruname);
+            if( SCIPgetParam(scip, paramname) != NULL )
+               SCIP_CALL( SCIPsetBoolParam(scip, paramname, TRUE) );
          }
       }
 
@@ -535,6 +702,15 @@ SCIP_RETCODE processShellArguments(
       printf("\nsyntax: %s [-l <logfile>] [-q] [-s <settings>] [-f <problem>] [-o <solution>]\n"
          "  -l <logfile>  : copy output into log file\n"
          "  -q            : suppress screen messages\n"
+         "  --aio         : write log and trajectories asynchronously (io_uring on Linux)\n"
+         "  --evtlog <file> : write a binary solve-event log of the node selector\n"
+         "  --treesample <file> : write periodic samples of the open-node queue of the node selector\n"
+         "  --stats <file> : append per-phase timing of the node selector and pruner to file\n"
+         "  --chrometrace <file> : write the solve timeline for chrome://tracing or ui.perfetto.dev\n"
+         "  --live        : publish live metrics in /dev/shm for scripts/09_monitor.py\n"
+         "  --memcap <MB> : soft cap on plugin memory; above it trajectory sampling and dedup tables stop growing\n"
+         "  --perf        : count cycles, instructions, cache and branch misses in the node selector and pruner\n"
+         "  --tracelevel <n> : text log of the node selector (0: final solutions, 1: selections, 2: nodes)\n"
          "  -s <settings> : load parameter settings (.set) file\n"
          "  -f <problem>  : load and solve problem file\n"
          "  -o <solution> : load optimal solution file\n",
@@ -577,6 +753,11 @@ SCIP_RETCODE runShell(
 
    SCIP_CALL( SCIPfree(&scip) );
 
+   SCIPlivestatClose();
+   SCIPchrometraceClose();
+
+   SCIP_CALL( SCIPaiowriterReleaseStdout() );
+
    BMScheckEmptyMemory();
 
    return SCIP_OKAY;
@@ -594,6 +775,10 @@ main(
    if( retcode != SCIP_OKAY )
    {
       SCIPprintError(retcode);
+      SCIPtraceDumpAll(stderr);
+      SCIPlivestatClose();
+      SCIPchrometraceClose();
+      (void)SCIPaiowriterReleaseStdout();
       return -1;
    }
 
@@ -0,0 +1,206 @@
+/**@file   evtlog.c
+ * @brief  methods for solve-event logs
+ *
+ * Binary format (little-endian, no padding), read by scripts/evtlog.py:
+ *
+ *   "SEVT" version(u32)                                               file header
+ *   'V' probindex(i32) namelen(u16) name                              variable name, written before its first use
+ *   'I' time(f64) obj(f64) solnode(i64) nsols(i32) nbestsolsfound(i64)
+ *                                                                     improving solution found since the last selection
+ *   'S' node(i64) parent(i64) depth(i32) var(i32) boundtype(u8) bound(f64) primalbound(f64) dualbound(f64)
+ *       lowerbound(f64) score(f64) time(f64) totaltime(f64) nopen(i32) isopt(u8)
+ *                                                                     node selection
+ *
+ * var/boundtype/bound describe the branching bound change that created the node (var -1 and boundtype 255 for the
+ * root); the branching path of a node is the chain of these bound changes along its parents. time is the solving
+ * time, obj is in the original objective space.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <stdint.h>
+#include <string.h>
+#include "scip/def.h"
+#include "aiowriter.h"
+#include "evtlog.h"
+
+#define EVTLOG_MAGIC      "SEVT"
+#define EVTLOG_VERSION    1
+
+#define EVTLOG_VAR        'V'
+#define EVTLOG_INCUMBENT  'I'
+#define EVTLOG_SELECT     'S'
+
+#define EVTLOG_MAXRECORD  128           /**< upper bound on the size of a fixed-size record */
+
+/** append a value to a record buffer */
+#define putValue(buf, pos, type, val)  do { type putval_ = (val); memcpy(&(buf)[pos], &putval_, sizeof(type)); \
+      (pos) += (int)sizeof(type); } while( FALSE )
+
+/** make sure the name of the variable is in the log */
+static
+SCIP_RETCODE writeVar(
+   SCIP_EVTLOG*       evtlog,
+   SCIP_VAR*          var
+   )
+{
+   char buf[8];
+   const char* name;
+   int probindex;
+   int newsize;
+   int len;
+   int pos = 0;
+
+   probindex = SCIPvarGetProbindex(var);
+   if( probindex < 0 )
+      return SCIP_OKAY;
+
+   if( probindex >= evtlog->varwrittensize )
+   {
+      newsize = MAX(2 * evtlog->varwrittensize, probindex + 1);
+      SCIP_ALLOC( BMSreallocMemoryArray(&evtlog->varwritten, newsize) );
+      BMSclearMemoryArray(&evtlog->varwritten[evtlog->varwrittensize], newsize - evtlog->varwrittensize);
+      evtlog->varwrittensize = newsize;
+   }
+   if( evtlog->varwritten[probindex] )
+      return SCIP_OKAY;
+
+   name = SCIPvarGetName(var);
+   len = (int)MIN(strlen(name), UINT16_MAX);
+
+   buf[pos++] = EVTLOG_VAR;
+   putValue(buf, pos, int32_t, probindex);
+   putValue(buf, pos, uint16_t, (uint16_t)len);
+   SCIPaiowriterWrite(evtlog->writer, buf, pos);
+   SCIPaiowriterWrite(evtlog->writer, name, len);
+
+   evtlog->varwritten[probindex] = TRUE;
+   evtlog->nrecords++;
+
+   return SCIP_OKAY;
+}
+
+/** open an event log, overwriting the given file */
+SCIP_RETCODE SCIPevtlogCreate(
+   SCIP*              scip,
+   SCIP_EVTLOG**      evtlog,
+   const char*        fname
+   )
+{
+   char buf[8];
+   int pos = 0;
+
+   assert(scip != NULL);
+   assert(evtlog != NULL);
+   assert(fname != NULL);
+
+   SCIP_CALL( SCIPallocBlockMemory(scip, evtlog) );
+   (*evtlog)->varwritten = NULL;
+   (*evtlog)->varwrittensize = 0;
+   (*evtlog)->nbestsolsfound = 0;
+   (*evtlog)->nrecords = 0;
+
+   SCIP_CALL( SCIPaiowriterCreate(&(*evtlog)->writer, fname, FALSE, TRUE) );
+
+   memcpy(buf, EVTLOG_MAGIC, 4);
+   pos = 4;
+   putValue(buf, pos, uint32_t, EVTLOG_VERSION);
+   SCIPaiowriterWrite((*evtlog)->writer, buf, pos);
+
+   return SCIP_OKAY;
+}
+
+/** write the remaining records and close the event log */
+SCIP_RETCODE SCIPevtlogFree(
+   SCIP*              scip,
+   SCIP_EVTLOG**      evtlog
+   )
+{
+   assert(scip != NULL);
+   assert(evtlog != NULL);
+   assert(*evtlog != NULL);
+
+   SCIPdebugMessage("event log: %"SCIP_LONGINT_FORMAT" records\n", (*evtlog)->nrecords);
+
+   SCIP_CALL( SCIPaiowriterFree(&(*evtlog)->writer) );
+   BMSfreeMemoryArrayNull(&(*evtlog)->varwritten);
+   SCIPfreeBlockMemory(scip, evtlog);
+
+   return SCIP_OKAY;
+}
+
+/** record a node selection, preceded by an incumbent record if a better solution was found since the last call */
+SCIP_RETCODE SCIPevtlogSelect(
+   SCIP*              scip,
+   SCIP_EVTLOG*       evtlog,
+   SCIP_NODE*         node,
+   int                nopen,
+   SCIP_Bool          isopt
+   )
+{
+   char buf[EVTLOG_MAXRECORD];
+   SCIP_NODE* parent;
+   SCIP_VAR* branchvar = NULL;
+   SCIP_Real branchbound = 0.0;
+   SCIP_BOUNDTYPE boundtype = SCIP_BOUNDTYPE_LOWER;
+   SCIP_SOL* bestsol;
+   SCIP_Longint nbestsolsfound;
+   int nbranchvars = 0;
+   int pos = 0;
+
+   assert(scip != NULL);
+   assert(evtlog != NULL);
+
+   nbestsolsfound = SCIPgetNBestSolsFound(scip);
+   bestsol = SCIPgetBestSol(scip);
+   if( nbestsolsfound > evtlog->nbestsolsfound && bestsol != NULL )
+   {
+      buf[pos++] = EVTLOG_INCUMBENT;
+      putValue(buf, pos, double, SCIPgetSolTime(scip, bestsol));
+      putValue(buf, pos, double, SCIPgetSolOrigObj(scip, bestsol));
+      putValue(buf, pos, int64_t, SCIPgetSolNodenum(scip, bestsol));
+      putValue(buf, pos, int32_t, SCIPgetNSols(scip));
+      putValue(buf, pos, int64_t, nbestsolsfound);
+      SCIPaiowriterWrite(evtlog->writer, buf, pos);
+
+      evtlog->nbestsolsfound = nbestsolsfound;
+      evtlog->nrecords++;
+   }
+
+   if( node == NULL )
+      return SCIP_OKAY;
+
+   /* the node's own branching: the first bound change is enough for variable branching */
+   SCIPnodeGetParentBranchings(node, &branchvar, &branchbound, &boundtype, &nbranchvars, 1);
+   if( nbranchvars >= 1 )
+   {
+      SCIP_CALL( writeVar(evtlog, branchvar) );
+   }
+   else
+      branchvar = NULL;
+
+   parent = SCIPnodeGetParent(node);
+
+   pos = 0;
+   buf[pos++] = EVTLOG_SELECT;
+   putValue(buf, pos, int64_t, SCIPnodeGetNumber(node));
+   putValue(buf, pos, int64_t, parent != NULL ? SCIPnodeGetNumber(parent) : -1);
+   putValue(buf, pos, int32_t, SCIPnodeGetDepth(node));
+   putValue(buf, pos, int32_t, branchvar != NULL ? SCIPvarGetProbindex(branchvar) : -1);
+   putValue(buf, pos, uint8_t, branchvar != NULL ? (uint8_t)boundtype : UINT8_MAX);
+   putValue(buf, pos, double, branchbound);
+   putValue(buf, pos, double, SCIPgetPrimalbound(scip));
+   putValue(buf, pos, double, SCIPgetDualbound(scip));
+   putValue(buf, pos, double, SCIPnodeGetLowerbound(node));
+   putValue(buf, pos, double, SCIPnodeGetScore(node));
+   putValue(buf, pos, double, SCIPgetSolvingTime(scip));
+   putValue(buf, pos, double, SCIPgetTotalTime(scip));
+   putValue(buf, pos, int32_t, nopen);
+   putValue(buf, pos, uint8_t, isopt ? 1 : 0);
+   assert(pos <= EVTLOG_MAXRECORD);
+   SCIPaiowriterWrite(evtlog->writer, buf, pos);
+
+   evtlog->nrecords++;
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,47 @@
+/**@file   evtlog.h
+ * @brief  internal methods for solve-event logs
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_EVTLOG_H__
+#define __SCIP_EVTLOG_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_evtlog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** open an event log, overwriting the given file */
+extern
+SCIP_RETCODE SCIPevtlogCreate(
+   SCIP*              scip,
+   SCIP_EVTLOG**      evtlog,
+   const char*        fname
+   );
+
+/** write the remaining records and close the event log */
+extern
+SCIP_RETCODE SCIPevtlogFree(
+   SCIP*              scip,
+   SCIP_EVTLOG**      evtlog
+   );
+
+/** record a node selection, preceded by an incumbent record if a better solution was found since the last call */
+extern
+SCIP_RETCODE SCIPevtlogSelect(
+   SCIP*              scip,
+   SCIP_EVTLOG*       evtlog,
+   SCIP_NODE*         node,               /**< selected node, or NULL if there is none */
+   int                nopen,              /**< number of open nodes */
+   SCIP_Bool          isopt               /**< is the node on the path to the optimal solution? */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
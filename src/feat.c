@@ -8,6 +8,7 @@
 #include "scip/def.h"
 #include "feat.h"
 #include "struct_feat.h"
+#include "memacct.h"
 #include "scip/tree.h"
 #include "scip/var.h"
 #include "scip/stat.h"
@@ -57,6 +58,7 @@ SCIP_RETCODE SCIPfeatCreate(
    SCIP_CALL( SCIPallocBlockMemory(scip, feat) );
 
    SCIP_ALLOC( BMSallocMemoryArray(&(*feat)->vals, size) );
+   SCIPmemacctAlloc(SCIP_MEMCOMP_FEAT, sizeof(SCIP_FEAT) + (size_t)size * sizeof(SCIP_Real));
 
    for( i = 0; i < size; i++ )
       (*feat)->vals[i] = 0;
@@ -81,6 +83,7 @@ SCIP_RETCODE SCIPfeatFree(
    assert(scip != NULL);
    assert(feat != NULL);
    assert(*feat != NULL);
+   SCIPmemacctFree(SCIP_MEMCOMP_FEAT, sizeof(SCIP_FEAT) + (size_t)(*feat)->size * sizeof(SCIP_Real));
    BMSfreeMemoryArray(&(*feat)->vals);
    SCIPfreeBlockMemory(scip, feat);
 
@@ -309,6 +312,56 @@ void SCIPcalcNodeselFeat(
       feat->boundtype == SCIP_BOUNDTYPE_LOWER ? 0 : 1;
 }
 
+/** recompute the node selector features that depend on the global bounds in feature values calculated earlier for
+ *  this node; unlike SCIPcalcNodeselFeat(), the indicator features are reset first
+ */
+void SCIPupdateNodeselFeatBounds(
+   SCIP*             scip,
+   SCIP_NODE*        node,
+   SCIP_FEAT*        feat
+   )
+{
+   SCIP_Real rootlowerbound;
+   SCIP_Real lowerbound;
+   SCIP_Real upperbound;
+   SCIP_Bool upperboundinf;
+
+   assert(node != NULL);
+   assert(feat != NULL);
+
+   rootlowerbound = REALABS(scip->stat->rootlowerbound);
+   if( SCIPsetIsZero(scip->set, rootlowerbound) )
+      rootlowerbound = 0.0001;
+   lowerbound = SCIPgetLowerbound(scip);
+   upperbound = SCIPgetUpperbound(scip);
+   upperboundinf = SCIPsetIsInfinity(scip->set, upperbound) || SCIPsetIsInfinity(scip->set, -upperbound);
+
+   feat->vals[SCIP_FEATNODESEL_GAP] = 0;
+   feat->vals[SCIP_FEATNODESEL_GAPINF] = 0;
+   feat->vals[SCIP_FEATNODESEL_GLOBALUPPERBOUND] = 0;
+   feat->vals[SCIP_FEATNODESEL_GLOBALUPPERBOUNDINF] = 0;
+   feat->vals[SCIP_FEATNODESEL_RELATIVEBOUND] = 0;
+
+   if( SCIPsetIsEQ(scip->set, upperbound, lowerbound) )
+      feat->vals[SCIP_FEATNODESEL_GAP] = 0;
+   else if( SCIPsetIsZero(scip->set, lowerbound) || upperboundinf )
+      feat->vals[SCIP_FEATNODESEL_GAPINF] = 1;
+   else
+      feat->vals[SCIP_FEATNODESEL_GAP] = (upperbound - lowerbound)/REALABS(lowerbound);
+
+   if( upperboundinf )
+   {
+      feat->vals[SCIP_FEATNODESEL_GLOBALUPPERBOUNDINF] = 1;
+      /* use only 20% of the gap as upper bound */
+      upperbound = lowerbound + 0.2 * (upperbound - lowerbound);
+   }
+   else
+      feat->vals[SCIP_FEATNODESEL_GLOBALUPPERBOUND] = upperbound / rootlowerbound;
+
+   if( !SCIPsetIsEQ(scip->set, upperbound, lowerbound) )
+      feat->vals[SCIP_FEATNODESEL_RELATIVEBOUND] = (SCIPnodeGetLowerbound(node) - lowerbound) / (upperbound - lowerbound);
+}
+
 /*
  * Compute a bipartite graph representation of the solver 
  * calculate constraint_features, edge_features, variable_features
@@ -371,6 +424,7 @@ SCIP_RETCODE SCIPhgfeatCreate(
    SCIP_CALL( SCIPallocBlockMemory(scip, feat) );
 
    SCIP_ALLOC( BMSallocMemoryArray(&(*feat)->vals, size) );
+   SCIPmemacctAlloc(SCIP_MEMCOMP_FEAT, sizeof(SCIP_FEAT) + (size_t)size * sizeof(SCIP_Real));
 
    for( i = 0; i < size; i++ )
       (*feat)->vals[i] = 0;
@@ -395,6 +449,7 @@ SCIP_RETCODE SCIPhgfeatFree(
    assert(scip != NULL);
    assert(feat != NULL);
    assert(*feat != NULL);
+   SCIPmemacctFree(SCIP_MEMCOMP_FEAT, sizeof(SCIP_FEAT) + (size_t)(*feat)->size * sizeof(SCIP_Real));
    BMSfreeMemoryArray(&(*feat)->vals);
    SCIPfreeBlockMemory(scip, feat);
 
@@ -1053,10 +1108,22 @@ void SCIPcalcNodeGCNNFeat(
    SCIPdebugMessage("test getState: %d %.3f %.3f %.3f\n", col_i, lb, ub, solval);
 }
 
+/** write the record head: label, example weight, depth bucket and boundtype */
+static
+void printRecordHead(
+   SCIP*             scip,
+   FILE*             file,
+   SCIP_FEAT*        feat,
+   int               label
+   )
+{
+   SCIPinfoMessage(scip, file, "%d w:%f d:%d b:%d ", label, SCIPfeatGetWeight(feat), SCIPfeatGetDepthBucket(feat),
+      (int)feat->boundtype);
+}
+
 void SCIPfeatNNPrint(
    SCIP*             scip,
    FILE*             file,    /* trj file */
-   FILE*             wfile,   /* unknown */
    SCIP_FEAT*        feat,   /* not know feat type */
    int               label,
    SCIP_Bool         negate
@@ -1077,7 +1144,7 @@ void SCIPfeatNNPrint(
    //                  feat->size, feat->depth, (feat->maxdepth / 10), (int)(feat->boundtype), offset);*/
    
 
-   SCIPinfoMessage(scip, file, "%d ", label);  
+   printRecordHead(scip, file, feat, label);
 
    for( i = 0; i < size; i++ )
    {
@@ -1090,7 +1157,6 @@ void SCIPfeatNNPrint(
 void SCIPfeatDiffNNPrintConcat(
    SCIP*             scip,
    FILE*             file,
-   FILE*             wfile,
    SCIP_FEAT*        feat1,
    SCIP_FEAT*        feat2,
    SCIP_FEAT*        left_feat,
@@ -1113,7 +1179,7 @@ void SCIPfeatDiffNNPrintConcat(
 
    size = SCIPfeatGetSize(feat1);
 
-   SCIPinfoMessage(scip, file, "%d ", label);
+   printRecordHead(scip, file, feat1, label);
    
    /* left and right */
    for( i = 0; i < size; i++ )
@@ -1171,7 +1237,6 @@ void SCIPfeatSingleNNPrint(
 void SCIPfeatDiffNNPrint(
    SCIP*             scip,
    FILE*             file,
-   FILE*             wfile,
    SCIP_FEAT*        feat1,
    SCIP_FEAT*        feat2,
    int               label,
@@ -1198,7 +1263,7 @@ void SCIPfeatDiffNNPrint(
    //    label = -1 * label;
    // }
 
-   SCIPinfoMessage(scip, file, "%d ", label);
+   printRecordHead(scip, file, feat1, label);
    
    /* feat1 */
    for( i = 0; i < size; i++ )
@@ -1214,7 +1279,6 @@ void SCIPfeatDiffNNPrint(
 void SCIPfeatDiffLIBSVMPrint(
    SCIP*             scip,
    FILE*             file,
-   FILE*             wfile,
    SCIP_FEAT*        feat1,
    SCIP_FEAT*        feat2,
    int               label,
@@ -1225,7 +1289,7 @@ void SCIPfeatDiffLIBSVMPrint(
    int i;
    int offset1;
    int offset2;
-   SCIP_Real weight;
+   SCIP_FEAT* headfeat;
 
    assert(scip != NULL);
    assert(feat1 != NULL);
@@ -1234,8 +1298,8 @@ void SCIPfeatDiffLIBSVMPrint(
    assert(feat2->depth != 0);
    assert(feat1->size == feat2->size);
 
-   weight = SCIPfeatGetWeight(feat1);
-   SCIPinfoMessage(scip, wfile, "%f\n", weight);  
+   /* the example weight is the one of the first node */
+   headfeat = feat1;
 
    if( negate )
    {
@@ -1249,7 +1313,7 @@ void SCIPfeatDiffLIBSVMPrint(
    offset1 = SCIPfeatGetOffset(feat1);
    offset2 = SCIPfeatGetOffset(feat2);
 
-   SCIPinfoMessage(scip, file, "%d ", label);
+   printRecordHead(scip, file, headfeat, label);
 
    if( offset1 == offset2 )
    {
@@ -1286,7 +1350,6 @@ void SCIPfeatDiffLIBSVMPrint(
 void SCIPfeatLIBSVMPrint(
    SCIP*             scip,
    FILE*             file,
-   FILE*             wfile,
    SCIP_FEAT*        feat,
    int               label
    )
@@ -1294,19 +1357,15 @@ void SCIPfeatLIBSVMPrint(
    int size;
    int i;
    int offset;
-   SCIP_Real weight;
 
    assert(scip != NULL);
    assert(feat != NULL);
    assert(feat->depth != 0);
 
-   weight = SCIPfeatGetWeight(feat);
-   SCIPinfoMessage(scip, wfile, "%f\n", weight);  
-
    size = SCIPfeatGetSize(feat);
    offset = SCIPfeatGetOffset(feat);
 
-   SCIPinfoMessage(scip, file, "%d ", label);  
+   printRecordHead(scip, file, feat, label);
 
    for( i = 0; i < size; i++ )
       SCIPinfoMessage(scip, file, "%d:%f ", i + offset + 1, feat->vals[i]);
@@ -1401,6 +1460,15 @@ SCIP_Real SCIPfeatGetWeight(
    return 5 * exp(-(feat->depth-1) / (0.6*feat->maxdepth) * 1.61);
 }
 
+/** returns the depth bucket of the example (tenths of the maximum depth) */
+int SCIPfeatGetDepthBucket(
+   SCIP_FEAT* feat
+   )
+{
+   assert(feat != NULL);
+   return feat->maxdepth >= 10 ? feat->depth / (feat->maxdepth / 10) : feat->depth;
+}
+
 int SCIPfeatGetOffset(
    SCIP_FEAT* feat
    )
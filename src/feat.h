@@ -21,12 +21,13 @@
 extern "C" {
 #endif
 
+/* Example records start with the label followed by "w:<weight> d:<depth bucket> b:<boundtype>" and the features. */
+
 /** write feature vector in libsvm format */
 extern
 void SCIPfeatLIBSVMPrint(
    SCIP*             scip,
    FILE*             file,
-   FILE*             wfile,
    SCIP_FEAT*        feat,
    int               label
    );
@@ -35,7 +36,6 @@ void SCIPfeatLIBSVMPrint(
 void SCIPfeatNNPrint(
    SCIP*             scip,
    FILE*             file,    /* trj file */
-   FILE*             wfile,   /* unknown */
    SCIP_FEAT*        feat,   /* not know feat type */
    int               label,
    SCIP_Bool         negate
@@ -44,7 +44,6 @@ void SCIPfeatNNPrint(
 void SCIPfeatDiffNNPrintConcat(
    SCIP*             scip,
    FILE*             file,
-   FILE*             wfile,
    SCIP_FEAT*        feat1,
    SCIP_FEAT*        feat2,
    SCIP_FEAT*        left_feat,
@@ -66,7 +65,6 @@ void SCIPfeatSingleNNPrint(
 void SCIPfeatDiffNNPrint(
    SCIP*             scip,
    FILE*             file,
-   FILE*             wfile,
    SCIP_FEAT*        feat1,
    SCIP_FEAT*        feat2,
    int               label,
@@ -78,7 +76,6 @@ extern
 void SCIPfeatDiffLIBSVMPrint(
    SCIP*             scip,
    FILE*             file,
-   FILE*             wfile,
    SCIP_FEAT*        feat1,
    SCIP_FEAT*        feat2,
    int               label,
@@ -101,6 +98,16 @@ void SCIPcalcNodeselFeat(
    SCIP_FEAT*        feat
    );
 
+/** recompute the node selector features that depend on the global bounds (gap, global upper bound, relative bound)
+ *  in feature values calculated earlier for this node
+ */
+extern
+void SCIPupdateNodeselFeatBounds(
+   SCIP*             scip,
+   SCIP_NODE*        node,
+   SCIP_FEAT*        feat
+   );
+
 /** returns offset of the feature index */
 extern
 int SCIPfeatGetOffset(
@@ -113,6 +120,12 @@ SCIP_Real SCIPfeatGetWeight(
    SCIP_FEAT* feat
    );
 
+/** returns the depth bucket of the example (tenths of the maximum depth) */
+extern
+int SCIPfeatGetDepthBucket(
+   SCIP_FEAT* feat
+   );
+
 /** create feature vector and normalizers, initialized to zero */
 extern
 SCIP_RETCODE SCIPfeatCreate(
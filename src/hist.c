@@ -0,0 +1,167 @@
+/**@file   hist.c
+ * @brief  methods for latency histograms
+ *
+ * Log-bucketed in the style of HDR histograms: recording is a count-leading-zeros and an increment, the buckets are a
+ * fixed array and histograms of several runs can be merged by adding bucket counts (see scripts/hist.py).
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include "scip/def.h"
+#include "hist.h"
+
+/** bucket of a value */
+static
+int bucketIndex(
+   SCIP_Longint       value
+   )
+{
+   int shift;
+
+   if( value < SCIP_HIST_NSUB )
+      return value < 0 ? 0 : (int)value;
+
+   shift = 63 - __builtin_clzll((unsigned long long)value) - SCIP_HIST_SUBBITS;
+   if( shift >= SCIP_HIST_NMAGNITUDES )
+      return SCIP_HIST_NBUCKETS - 1;
+
+   return (shift + 1) * SCIP_HIST_NSUB + (int)((value >> shift) - SCIP_HIST_NSUB);
+}
+
+/** largest value of a bucket */
+static
+SCIP_Longint bucketUpper(
+   int                idx
+   )
+{
+   int shift;
+
+   if( idx < SCIP_HIST_NSUB )
+      return idx;
+
+   shift = idx / SCIP_HIST_NSUB - 1;
+
+   return ((SCIP_Longint)(SCIP_HIST_NSUB + idx % SCIP_HIST_NSUB) << shift) + ((SCIP_Longint)1 << shift) - 1;
+}
+
+/** reset the histogram */
+void SCIPhistReset(
+   SCIP_HIST*         hist
+   )
+{
+   assert(hist != NULL);
+
+   BMSclearMemory(hist);
+}
+
+/** record a latency in nanoseconds */
+void SCIPhistAdd(
+   SCIP_HIST*         hist,
+   SCIP_Longint       value
+   )
+{
+   assert(hist != NULL);
+
+   hist->buckets[bucketIndex(value)]++;
+   hist->count++;
+   hist->sum += value;
+   if( value > hist->max )
+      hist->max = value;
+}
+
+/** value at quantile q in [0,1] */
+SCIP_Longint SCIPhistGetQuantile(
+   SCIP_HIST*         hist,
+   SCIP_Real          q
+   )
+{
+   SCIP_Longint rank;
+   SCIP_Longint seen = 0;
+   int i;
+
+   assert(hist != NULL);
+   assert(q >= 0.0 && q <= 1.0);
+
+   if( hist->count == 0 )
+      return 0;
+
+   /* smallest value with at least q * count values at or below it */
+   rank = (SCIP_Longint)(q * hist->count + 0.5);
+   if( rank < 1 )
+      rank = 1;
+
+   for( i = 0; i < SCIP_HIST_NBUCKETS; i++ )
+   {
+      seen += hist->buckets[i];
+      if( seen >= rank )
+         return MIN(bucketUpper(i), hist->max);
+   }
+
+   return hist->max;
+}
+
+/** print the column header for SCIPhistPrint() */
+void SCIPhistPrintHeader(
+   SCIP*              scip,
+   FILE*              file
+   )
+{
+   SCIPinfoMessage(scip, file, "  latency(us)      :      count        p50        p90        p99      p99.9        max\n");
+}
+
+/** print p50/p90/p99/p99.9/max in microseconds as one line of a statistics block */
+void SCIPhistPrint(
+   SCIP*              scip,
+   SCIP_HIST*         hist,
+   const char*        name,
+   FILE*              file
+   )
+{
+   assert(scip != NULL);
+   assert(hist != NULL);
+   assert(name != NULL);
+
+   SCIPinfoMessage(scip, file, "    %-14s : %10"SCIP_LONGINT_FORMAT" %10.2f %10.2f %10.2f %10.2f %10.2f\n", name, hist->count,
+      SCIPhistGetQuantile(hist, 0.5) / 1e3, SCIPhistGetQuantile(hist, 0.9) / 1e3, SCIPhistGetQuantile(hist, 0.99) / 1e3,
+      SCIPhistGetQuantile(hist, 0.999) / 1e3, hist->max / 1e3);
+}
+
+/** append the histogram to a machine-readable stats file */
+SCIP_RETCODE SCIPhistWrite(
+   SCIP*              scip,
+   SCIP_HIST*         hist,
+   const char*        fname,
+   const char*        component,
+   const char*        name
+   )
+{
+   FILE* file;
+   int i;
+
+   assert(scip != NULL);
+   assert(hist != NULL);
+   assert(fname != NULL);
+   assert(component != NULL);
+   assert(name != NULL);
+
+   file = fopen(fname, "a");
+   if( file == NULL )
+   {
+      SCIPerrorMessage("cannot open stats file <%s> for writing\n", fname);
+      SCIPprintSysError(fname);
+      return SCIP_NOFILE;
+   }
+
+   fprintf(file, "%s hist %s count %"SCIP_LONGINT_FORMAT" sum %"SCIP_LONGINT_FORMAT" max %"SCIP_LONGINT_FORMAT, component,
+      name, hist->count, hist->sum, hist->max);
+   for( i = 0; i < SCIP_HIST_NBUCKETS; i++ )
+   {
+      if( hist->buckets[i] > 0 )
+         fprintf(file, " %d:%"SCIP_LONGINT_FORMAT, i, hist->buckets[i]);
+   }
+   fprintf(file, "\n");
+
+   fclose(file);
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,71 @@
+/**@file   hist.h
+ * @brief  internal methods for latency histograms
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_HIST_H__
+#define __SCIP_HIST_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_hist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** reset the histogram */
+extern
+void SCIPhistReset(
+   SCIP_HIST*         hist
+   );
+
+/** record a latency in nanoseconds */
+extern
+void SCIPhistAdd(
+   SCIP_HIST*         hist,
+   SCIP_Longint       value
+   );
+
+/** value at quantile q in [0,1], reported as the upper end of its bucket and capped by the maximum */
+extern
+SCIP_Longint SCIPhistGetQuantile(
+   SCIP_HIST*         hist,
+   SCIP_Real          q
+   );
+
+/** print the column header for SCIPhistPrint() */
+extern
+void SCIPhistPrintHeader(
+   SCIP*              scip,
+   FILE*              file
+   );
+
+/** print p50/p90/p99/p99.9/max in microseconds as one line of a statistics block */
+extern
+void SCIPhistPrint(
+   SCIP*              scip,
+   SCIP_HIST*         hist,
+   const char*        name,               /**< label of the line, at most 14 characters */
+   FILE*              file
+   );
+
+/** append the histogram to a machine-readable stats file, read by scripts/hist.py
+ *
+ *  One line: "<component> hist <name> count <n> sum <ns> max <ns> <bucket>:<count> ..." with the nonempty buckets.
+ */
+extern
+SCIP_RETCODE SCIPhistWrite(
+   SCIP*              scip,
+   SCIP_HIST*         hist,
+   const char*        fname,
+   const char*        component,          /**< e.g. "nodesel.policy" */
+   const char*        name                /**< e.g. "select" */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
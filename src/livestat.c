@@ -0,0 +1,255 @@
+/**@file   livestat.c
+ * @brief  methods for live solve metrics in shared memory
+ *
+ * The page is a file in /dev/shm mapped shared into the process, so a monitor on the same host can map or read it
+ * at any time without talking to the solver. Updates are rate-limited to one per LIVESTAT_PERIOD and are a handful of
+ * stores guarded by a sequence counter (seqlock), so they can be checked on every solved node and every selection.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "scip/def.h"
+#include "profile.h"
+#include "livestat.h"
+
+#define EVENTHDLR_NAME     "livestat"
+#define EVENTHDLR_DESC     "event handler publishing the solver progress in shared memory"
+
+#define LIVESTAT_MAGIC     "LIVE"
+#define LIVESTAT_VERSION   1
+#define LIVESTAT_DIR       "/dev/shm"
+#define LIVESTAT_PERIOD    100000000LL  /**< minimal time between two updates in nanoseconds */
+
+static SCIP_LIVESTATPAGE* livepage = NULL;           /**< page of this process, or NULL */
+static char livepath[SCIP_MAXSTRLEN];                /**< file backing the page */
+static SCIP_Longint lastprogress = 0;                /**< monotonic clock time of the last progress update */
+static SCIP_Longint lastnodesel = 0;                 /**< monotonic clock time of the last node selector update */
+
+/** wall clock time in seconds since the epoch */
+static
+double wallTime(
+   void
+   )
+{
+   struct timespec ts;
+
+   (void)clock_gettime(CLOCK_REALTIME, &ts);
+
+   return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+/** start an update: make seq odd */
+static
+void beginUpdate(
+   SCIP_LIVESTATPAGE* page
+   )
+{
+   __atomic_store_n(&page->seq, page->seq + 1, __ATOMIC_RELAXED);
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/** end an update: make seq even again */
+static
+void endUpdate(
+   SCIP_LIVESTATPAGE* page
+   )
+{
+   __atomic_store_n(&page->seq, page->seq + 1, __ATOMIC_RELEASE);
+}
+
+/** create the page of this process as <dir>/scipdagger.<pid>.live */
+SCIP_RETCODE SCIPlivestatOpen(
+   const char*        dir
+   )
+{
+   void* mem;
+   int fd;
+
+   if( livepage != NULL )
+      return SCIP_OKAY;
+
+   (void) SCIPsnprintf(livepath, SCIP_MAXSTRLEN, "%s/scipdagger.%d.live", dir != NULL ? dir : LIVESTAT_DIR,
+      (int)getpid());
+
+   fd = open(livepath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+   if( fd < 0 )
+   {
+      SCIPerrorMessage("cannot create live statistics page <%s>\n", livepath);
+      SCIPprintSysError(livepath);
+      return SCIP_NOFILE;
+   }
+   if( ftruncate(fd, (off_t)sizeof(SCIP_LIVESTATPAGE)) != 0 )
+   {
+      SCIPerrorMessage("cannot size live statistics page <%s>\n", livepath);
+      SCIPprintSysError(livepath);
+      (void)close(fd);
+      (void)unlink(livepath);
+      return SCIP_WRITEERROR;
+   }
+
+   mem = mmap(NULL, sizeof(SCIP_LIVESTATPAGE), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   (void)close(fd);
+   if( mem == MAP_FAILED )
+   {
+      SCIPerrorMessage("cannot map live statistics page <%s>\n", livepath);
+      SCIPprintSysError(livepath);
+      (void)unlink(livepath);
+      return SCIP_NOMEMORY;
+   }
+
+   /* the file is zero-filled by ftruncate(); the magic is written last so readers skip half-initialized pages */
+   livepage = (SCIP_LIVESTATPAGE*)mem;
+   beginUpdate(livepage);
+   livepage->version = LIVESTAT_VERSION;
+   livepage->pid = (int64_t)getpid();
+   livepage->starttime = wallTime();
+   livepage->updatetime = livepage->starttime;
+   livepage->trjbytes = -1;
+   endUpdate(livepage);
+   memcpy(livepage->magic, LIVESTAT_MAGIC, 4);
+
+   lastprogress = 0;
+   lastnodesel = 0;
+
+   return SCIP_OKAY;
+}
+
+/** mark the solve as finished and remove the page */
+void SCIPlivestatClose(
+   void
+   )
+{
+   if( livepage == NULL )
+      return;
+
+   beginUpdate(livepage);
+   livepage->finished = 1;
+   livepage->updatetime = wallTime();
+   endUpdate(livepage);
+
+   (void)munmap(livepage, sizeof(SCIP_LIVESTATPAGE));
+   (void)unlink(livepath);
+   livepage = NULL;
+}
+
+/** publish the progress of the solve */
+static
+void publishProgress(
+   SCIP*              scip
+   )
+{
+   assert(livepage != NULL);
+
+   lastprogress = SCIPprofileStart();
+
+   beginUpdate(livepage);
+   if( livepage->name[0] == '\0' )
+      (void) SCIPsnprintf(livepage->name, SCIP_LIVESTAT_NAMELEN, "%s", SCIPgetProbName(scip));
+   livepage->updatetime = wallTime();
+   livepage->solvingtime = SCIPgetSolvingTime(scip);
+   livepage->nnodes = SCIPgetNNodes(scip);
+   livepage->nopen = SCIPgetNNodesLeft(scip);
+   livepage->primalbound = SCIPgetPrimalbound(scip);
+   livepage->dualbound = SCIPgetDualbound(scip);
+   livepage->gap = SCIPgetGap(scip);
+   endUpdate(livepage);
+}
+
+/** initialization method of event handler (called after problem was transformed) */
+static
+SCIP_DECL_EVENTINITSOL(eventInitsolLivestat)
+{
+   assert(scip != NULL);
+   assert(eventhdlr != NULL);
+
+   SCIP_CALL( SCIPcatchEvent(scip, SCIP_EVENTTYPE_NODESOLVED, eventhdlr, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
+
+/** solving process deinitialization method of event handler (called before branch and bound process data is freed) */
+static
+SCIP_DECL_EVENTEXITSOL(eventExitsolLivestat)
+{
+   assert(scip != NULL);
+   assert(eventhdlr != NULL);
+
+   if( livepage != NULL )
+      publishProgress(scip);
+
+   SCIP_CALL( SCIPdropEvent(scip, SCIP_EVENTTYPE_NODESOLVED, eventhdlr, NULL, -1) );
+
+   return SCIP_OKAY;
+}
+
+/** execution method of event handler */
+static
+SCIP_DECL_EVENTEXEC(eventExecLivestat)
+{
+   assert(scip != NULL);
+   assert(eventhdlr != NULL);
+
+   if( livepage != NULL && SCIPprofileStart() - lastprogress >= LIVESTAT_PERIOD )
+      publishProgress(scip);
+
+   return SCIP_OKAY;
+}
+
+/** creates the event handler that publishes the solver progress and includes it in SCIP */
+SCIP_RETCODE SCIPincludeEventhdlrLivestat(
+   SCIP*              scip
+   )
+{
+   SCIP_EVENTHDLR* eventhdlr = NULL;
+
+   SCIP_CALL( SCIPincludeEventhdlrBasic(scip, &eventhdlr, EVENTHDLR_NAME, EVENTHDLR_DESC, eventExecLivestat, NULL) );
+   assert(eventhdlr != NULL);
+
+   SCIP_CALL( SCIPsetEventhdlrInitsol(scip, eventhdlr, eventInitsolLivestat) );
+   SCIP_CALL( SCIPsetEventhdlrExitsol(scip, eventhdlr, eventExitsolLivestat) );
+
+   return SCIP_OKAY;
+}
+
+/** is the page open and have the node selector counters aged enough to publish them again? */
+SCIP_Bool SCIPlivestatIsDue(
+   void
+   )
+{
+   if( livepage == NULL )
+      return FALSE;
+
+   return SCIPprofileStart() - lastnodesel >= LIVESTAT_PERIOD;
+}
+
+/** publish the counters of the node selector */
+void SCIPlivestatPublishNodesel(
+   const char*        nodesel,
+   SCIP_HIST*         modelhist,
+   SCIP_Longint       trjbytes
+   )
+{
+   assert(nodesel != NULL);
+
+   if( livepage == NULL )
+      return;
+
+   lastnodesel = SCIPprofileStart();
+
+   beginUpdate(livepage);
+   if( livepage->nodesel[0] == '\0' )
+      (void) SCIPsnprintf(livepage->nodesel, (int)sizeof(livepage->nodesel), "%s", nodesel);
+   if( modelhist != NULL )
+   {
+      livepage->nmodelcalls = modelhist->count;
+      livepage->modelns = modelhist->sum;
+      livepage->modelmaxns = modelhist->max;
+   }
+   livepage->trjbytes = trjbytes;
+   endUpdate(livepage);
+}
@@ -0,0 +1,58 @@
+/**@file   livestat.h
+ * @brief  internal methods for live solve metrics in shared memory
+ *
+ * There is one page per process; it is opened by the shell, solver progress is published by an event handler on node
+ * solved events and the node selectors add their scoring and trajectory counters.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_LIVESTAT_H__
+#define __SCIP_LIVESTAT_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_livestat.h"
+#include "struct_hist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** create the page of this process as <dir>/scipdagger.<pid>.live */
+extern
+SCIP_RETCODE SCIPlivestatOpen(
+   const char*        dir                 /**< directory, NULL for /dev/shm */
+   );
+
+/** mark the solve as finished and remove the page */
+extern
+void SCIPlivestatClose(
+   void
+   );
+
+/** creates the event handler that publishes the solver progress and includes it in SCIP */
+extern
+SCIP_RETCODE SCIPincludeEventhdlrLivestat(
+   SCIP*              scip
+   );
+
+/** is the page open and have the node selector counters aged enough to publish them again? */
+extern
+SCIP_Bool SCIPlivestatIsDue(
+   void
+   );
+
+/** publish the counters of the node selector */
+extern
+void SCIPlivestatPublishNodesel(
+   const char*        nodesel,            /**< name of the calling node selector */
+   SCIP_HIST*         modelhist,          /**< scoring round trip latencies, or NULL */
+   SCIP_Longint       trjbytes            /**< trajectory bytes written, or -1 */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,164 @@
+/**@file   memacct.c
+ * @brief  methods for per-component memory accounting of the plugins
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include "scip/def.h"
+#include "memacct.h"
+
+static const char* compnames[SCIP_MEMCOMP_N] = {
+   "feat",
+   "model",
+   "policy",
+   "trj",
+   "nodedata"
+};
+
+static SCIP_MEMACCT memacct;          /**< counters of this process, zero-initialized */
+
+/** add a signed number of bytes to a component */
+static
+void addBytes(
+   SCIP_MEMCOMP       comp,
+   SCIP_Longint       bytes
+   )
+{
+   SCIP_MEMSTAT* stat;
+
+   assert(comp >= 0 && comp < SCIP_MEMCOMP_N);
+
+   stat = &memacct.stats[comp];
+   stat->current += bytes;
+   if( stat->current > stat->peak )
+      stat->peak = stat->current;
+
+   memacct.current += bytes;
+   if( memacct.current > memacct.peak )
+      memacct.peak = memacct.current;
+}
+
+/** account an allocation */
+void SCIPmemacctAlloc(
+   SCIP_MEMCOMP       comp,
+   size_t             bytes
+   )
+{
+   addBytes(comp, (SCIP_Longint)bytes);
+   memacct.stats[comp].nallocs++;
+}
+
+/** account a free */
+void SCIPmemacctFree(
+   SCIP_MEMCOMP       comp,
+   size_t             bytes
+   )
+{
+   addBytes(comp, -(SCIP_Longint)bytes);
+   memacct.stats[comp].nfrees++;
+   assert(memacct.stats[comp].current >= 0);
+}
+
+/** account a reallocation */
+void SCIPmemacctRealloc(
+   SCIP_MEMCOMP       comp,
+   size_t             oldbytes,
+   size_t             newbytes
+   )
+{
+   addBytes(comp, (SCIP_Longint)newbytes - (SCIP_Longint)oldbytes);
+   memacct.stats[comp].nallocs++;
+}
+
+/** set the soft cap in bytes (0: no cap) */
+void SCIPmemacctSetSoftCap(
+   SCIP_Longint       softcap
+   )
+{
+   assert(softcap >= 0);
+
+   memacct.softcap = softcap;
+}
+
+/** is a soft cap set and are the plugins at or above it? */
+SCIP_Bool SCIPmemacctIsOverCap(
+   void
+   )
+{
+   return memacct.softcap > 0 && memacct.current >= memacct.softcap;
+}
+
+/** count that a component dropped work because of the soft cap */
+void SCIPmemacctShed(
+   SCIP_MEMCOMP       comp
+   )
+{
+   assert(comp >= 0 && comp < SCIP_MEMCOMP_N);
+
+   memacct.stats[comp].nshed++;
+}
+
+/** print the counters as part of the statistics */
+void SCIPmemacctPrint(
+   SCIP*              scip,
+   FILE*              file
+   )
+{
+   SCIP_MEMSTAT* stat;
+   int c;
+
+   assert(scip != NULL);
+
+   if( memacct.peak == 0 )
+      return;
+
+   SCIPinfoMessage(scip, file, "Plugin memory      :   curr(MB)   peak(MB)    nallocs     nfrees      nshed\n");
+   for( c = 0; c < SCIP_MEMCOMP_N; c++ )
+   {
+      stat = &memacct.stats[c];
+      if( stat->nallocs == 0 )
+         continue;
+      SCIPinfoMessage(scip, file, "  %-16s : %10.2f %10.2f %10"SCIP_LONGINT_FORMAT" %10"SCIP_LONGINT_FORMAT" %10"SCIP_LONGINT_FORMAT"\n",
+         compnames[c], stat->current / 1048576.0, stat->peak / 1048576.0, stat->nallocs, stat->nfrees, stat->nshed);
+   }
+   SCIPinfoMessage(scip, file, "  %-16s : %10.2f %10.2f\n", "total", memacct.current / 1048576.0,
+      memacct.peak / 1048576.0);
+   if( memacct.softcap > 0 )
+      SCIPinfoMessage(scip, file, "  %-16s : %10.2f\n", "soft cap", memacct.softcap / 1048576.0);
+}
+
+/** append the counters to a machine-readable stats file */
+SCIP_RETCODE SCIPmemacctWrite(
+   SCIP*              scip,
+   const char*        fname,
+   const char*        component
+   )
+{
+   SCIP_MEMSTAT* stat;
+   FILE* file;
+   int c;
+
+   assert(scip != NULL);
+   assert(fname != NULL);
+   assert(component != NULL);
+
+   file = fopen(fname, "a");
+   if( file == NULL )
+   {
+      SCIPerrorMessage("cannot open stats file <%s> for writing\n", fname);
+      SCIPprintSysError(fname);
+      return SCIP_NOFILE;
+   }
+
+   for( c = 0; c < SCIP_MEMCOMP_N; c++ )
+   {
+      stat = &memacct.stats[c];
+      fprintf(file, "%s mem %s current %"SCIP_LONGINT_FORMAT" peak %"SCIP_LONGINT_FORMAT" nallocs %"SCIP_LONGINT_FORMAT
+         " nfrees %"SCIP_LONGINT_FORMAT" nshed %"SCIP_LONGINT_FORMAT"\n", component, compnames[c], stat->current,
+         stat->peak, stat->nallocs, stat->nfrees, stat->nshed);
+   }
+
+   fclose(file);
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,87 @@
+/**@file   memacct.h
+ * @brief  internal methods for per-component memory accounting of the plugins
+ *
+ * The plugins report their own allocations here, by component; SCIP's memory is not included. The counters are
+ * process-wide, like the plugins' use of the block memory, and are only updated from the solving thread.
+ *
+ * With a soft cap set, components that hold optional data check SCIPmemacctIsOverCap() before growing and drop work
+ * instead: the reservoirs of the trajectory sink stop growing (new groups can still replace buffered ones), and the row
+ * hash table used for deduplication stops growing, so the rows of newer nodes are written every time they appear.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_MEMACCT_H__
+#define __SCIP_MEMACCT_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_memacct.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** account an allocation */
+extern
+void SCIPmemacctAlloc(
+   SCIP_MEMCOMP       comp,
+   size_t             bytes
+   );
+
+/** account a free */
+extern
+void SCIPmemacctFree(
+   SCIP_MEMCOMP       comp,
+   size_t             bytes
+   );
+
+/** account a reallocation */
+extern
+void SCIPmemacctRealloc(
+   SCIP_MEMCOMP       comp,
+   size_t             oldbytes,
+   size_t             newbytes
+   );
+
+/** set the soft cap in bytes (0: no cap) */
+extern
+void SCIPmemacctSetSoftCap(
+   SCIP_Longint       softcap
+   );
+
+/** is a soft cap set and are the plugins at or above it? */
+extern
+SCIP_Bool SCIPmemacctIsOverCap(
+   void
+   );
+
+/** count that a component dropped work because of the soft cap */
+extern
+void SCIPmemacctShed(
+   SCIP_MEMCOMP       comp
+   );
+
+/** print the counters as part of the statistics */
+extern
+void SCIPmemacctPrint(
+   SCIP*              scip,
+   FILE*              file
+   );
+
+/** append the counters to a machine-readable stats file
+ *
+ *  One line per component: "<component> mem <comp> current <n> peak <n> nallocs <n> nfrees <n> nshed <n>".
+ */
+extern
+SCIP_RETCODE SCIPmemacctWrite(
+   SCIP*              scip,
+   const char*        fname,
+   const char*        component           /**< e.g. "nodesel.policy" */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
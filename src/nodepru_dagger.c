@@ -27,6 +27,8 @@
 #include "scip/set.h"
 #include "scip/struct_set.h"
 #include "scip/struct_scip.h"
+#include "profile.h"
+#include "perfcnt.h"
 
 #define NODEPRU_NAME            "dagger"
 #define NODEPRU_DESC            "node pruner which pruects node according to a policy but writes exampels according to the oracle"
@@ -34,6 +36,9 @@
 #define NODEPRU_MEMSAVEPRIORITY 0
 
 #define DEFAULT_FILENAME        ""
+#define DEFAULT_PERFCOUNTERS    FALSE    /**< count hardware events around the prune callback? */
+#define DEFAULT_SAFETYEPS       0.0      /**< keep nodes within this relative distance of the dual bound (-1: off) */
+#define DEFAULT_THRESHOLD       0.0      /**< prune nodes whose pruning model output is above this */
 
 /*
  * Data structures
@@ -44,10 +49,10 @@ struct SCIP_NodepruData
 {
    char*              solfname;           /**< name of the solution file */
    SCIP_SOL*          optsol;             /**< optimal solution */
+   SCIP_OPTTABLE*     opttable;           /**< optimal values of the active variables */
    char*              polfname;           /**< name of the solution file */
    SCIP_POLICY*       policy;
    char*              trjfname;           /**< name of the trajectory file */
-   FILE*              wfile;
    FILE*              trjfile;
    SCIP_FEAT*         feat;
    SCIP_Bool          checkopt;           /**< need to check node optimality? (don't need to if node selector is oracle or dagger */
@@ -56,6 +61,14 @@ struct SCIP_NodepruData
    int                nfalsepos;           /**< number of optimal nodes pruned */
    int                nfalseneg;           /**< number of non-optimal nodes not pruned */
    unsigned int       randseed;
+   char*              statsfname;         /**< name of the file to append the phase statistics to */
+   SCIP_PROFILE       profile;            /**< per-phase timing */
+   SCIP_Bool          perfcounters;       /**< count hardware events around the prune callback? */
+   SCIP_PERFCNT       perfcnt;            /**< hardware event counts per region */
+   SCIP_Real          safetyeps;          /**< keep nodes within this relative distance of the dual bound (-1: off) */
+   SCIP_Real          threshold;          /**< prune nodes whose pruning model output is above this */
+   SCIP_PRUNEBATCH    batch;              /**< pruning scores of the last batch of nodes */
+   int                nsafe;              /**< number of nodes kept by the safety rule */
 
 };
 
@@ -66,6 +79,7 @@ void SCIPnodeprudaggerPrintStatistics(
    )
 {
    SCIP_NODEPRUDATA* nodeprudata;
+   SCIP_Longint nnodes;
 
    assert(scip != NULL);
    assert(nodepru != NULL);
@@ -83,6 +97,18 @@ void SCIPnodeprudaggerPrintStatistics(
          "  FN pruned        : %d/%d\n", nodeprudata->nfalseneg, nodeprudata->nnodes);
    SCIPmessageFPrintInfo(scip->messagehdlr, file,
          "  pruning time     : %10.2f\n", SCIPnodepruGetTime(nodepru));
+   SCIPmessageFPrintInfo(scip->messagehdlr, file,
+         "  kept by safety   : %10d\n", nodeprudata->nsafe);
+   SCIPmessageFPrintInfo(scip->messagehdlr, file,
+         "  model batches    : %10d\n", nodeprudata->batch.nbatches);
+   /* a pruned node's LP is never solved; estimated by the averages over the nodes solved below the root */
+   nnodes = MAX(SCIPgetNNodes(scip) - 1, 1);
+   SCIPmessageFPrintInfo(scip->messagehdlr, file,
+         "  LP solves saved  : %10.0f\n", (SCIP_Real)nodeprudata->nprunes * SCIPgetNNodeLPs(scip) / nnodes);
+   SCIPmessageFPrintInfo(scip->messagehdlr, file,
+         "  LP iters saved   : %10.0f\n", (SCIP_Real)nodeprudata->nprunes * SCIPgetNNodeLPIterations(scip) / nnodes);
+   SCIPprofilePrint(scip, &nodeprudata->profile, file);
+   SCIPperfcntPrint(scip, &nodeprudata->perfcnt, file);
 }
 
 /** solving process initialization method of node pruner (called when branch and bound process is about to begin) */
@@ -101,6 +127,7 @@ SCIP_DECL_NODEPRUINIT(nodepruInitDagger)
    nodeprudata->optsol = NULL;
    SCIP_CALL( SCIPreadOptSol(scip, nodeprudata->solfname, &nodeprudata->optsol) );
    assert(nodeprudata->optsol != NULL);
+   SCIP_CALL( SCIPopttableCreate(scip, &nodeprudata->opttable, nodeprudata->optsol) );
 #ifdef SCIP_DEBUG
    SCIP_CALL( SCIPprintSol(scip, nodeprudata->optsol, NULL, FALSE) );
 #endif
@@ -109,17 +136,12 @@ SCIP_DECL_NODEPRUINIT(nodepruInitDagger)
    SCIP_CALL( SCIPpolicyCreate(scip, &nodeprudata->policy) );
    assert(nodeprudata->polfname != NULL);
    SCIP_CALL( SCIPreadNNPolicy(scip, nodeprudata->polfname, &nodeprudata->policy) );
-   assert(nodeprudata->policy->weights != NULL);
 
    /* open trajectory file for writing */
    /* open in appending mode for writing training file from multiple problems */
    nodeprudata->trjfile = NULL;
    if( nodeprudata->trjfname != NULL )
    {
-      char wfname[SCIP_MAXSTRLEN];
-      strcpy(wfname, nodeprudata->trjfname);
-      strcat(wfname, ".weight");
-      nodeprudata->wfile = fopen(wfname, "a");
       nodeprudata->trjfile = fopen(nodeprudata->trjfname, "a");
    }
 
@@ -140,6 +162,13 @@ SCIP_DECL_NODEPRUINIT(nodepruInitDagger)
    nodeprudata->nfalsepos = 0;
    nodeprudata->nfalseneg = 0;
    nodeprudata->randseed = 0;
+   nodeprudata->nsafe = 0;
+   SCIP_CALL( SCIPpruneBatchInit(scip, &nodeprudata->batch) );
+   SCIPprofileReset(&nodeprudata->profile);
+   if( nodeprudata->perfcounters )
+   {
+      SCIP_CALL( SCIPperfcntOpen(scip, &nodeprudata->perfcnt) );
+   }
 
    return SCIP_OKAY;
 }
@@ -154,12 +183,19 @@ SCIP_DECL_NODEPRUEXIT(nodepruExitDagger)
 
    nodeprudata = SCIPnodepruGetData(nodepru);
 
+   if( nodeprudata->statsfname != NULL && nodeprudata->statsfname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPprofileWrite(scip, &nodeprudata->profile, nodeprudata->statsfname, "nodepru."NODEPRU_NAME) );
+      SCIP_CALL( SCIPperfcntWrite(scip, &nodeprudata->perfcnt, nodeprudata->statsfname, "nodepru."NODEPRU_NAME) );
+   }
+   SCIPperfcntClose(&nodeprudata->perfcnt);
+
    assert(nodeprudata->optsol != NULL);
+   SCIPopttableFree(scip, &nodeprudata->opttable);
    SCIP_CALL( SCIPfreeSolSelf(scip, &nodeprudata->optsol) );
 
    if( nodeprudata->trjfile != NULL)
    {
-      fclose(nodeprudata->wfile);
       fclose(nodeprudata->trjfile);
    }
 
@@ -169,6 +205,8 @@ SCIP_DECL_NODEPRUEXIT(nodepruExitDagger)
    assert(nodeprudata->policy != NULL);
    SCIP_CALL( SCIPpolicyFree(scip, &nodeprudata->policy) );
 
+   SCIPpruneBatchExit(scip, &nodeprudata->batch);
+
    return SCIP_OKAY;
 }
 
@@ -193,7 +231,12 @@ static
 SCIP_DECL_NODEPRUPRUNE(nodepruPruneDagger)
 {
    SCIP_NODEPRUDATA* nodeprudata;
+   SCIP_Bool prunable;
+   SCIP_Longint start;
+   SCIP_PERFSNAP prunesnap;
+   SCIP_PERFSNAP snap;
    SCIP_Bool isoptimal;
+   SCIP_Real score;
 
    assert(nodepru != NULL);
    assert(strcmp(SCIPnodepruGetName(nodepru), NODEPRU_NAME) == 0);
@@ -214,10 +257,30 @@ SCIP_DECL_NODEPRUPRUNE(nodepruPruneDagger)
       /*
       SCIP_Real rand; */
 
+      SCIPperfcntStart(&nodeprudata->perfcnt, &prunesnap);
+
+      start = SCIPprofileStart();
+      SCIPperfcntStart(&nodeprudata->perfcnt, &snap);
       SCIPcalcNodepruFeat(scip, node, nodeprudata->feat);
-      SCIPcalcNodeScore(node, nodeprudata->feat, nodeprudata->policy);
+      SCIPperfcntStop(&nodeprudata->perfcnt, SCIP_PERFREGION_FEAT, &snap);
+      SCIPprofileStop(&nodeprudata->profile, SCIP_PROFPHASE_FEAT, start);
+
+      /* the score is kept apart from the node score, which belongs to the node selector; a batch recomputes the
+       * features of the node last, so the feature buffer still holds them for the trajectory
+       */
+      prunable = SCIPpolicyIsPrunable(scip, node, nodeprudata->safetyeps);
+      if( !prunable )
+      {
+         score = 0.0;
+         nodeprudata->nsafe++;
+      }
+      else
+      {
+         SCIP_CALL( SCIPpolicyGetPruneScore(scip, nodeprudata->policy, nodeprudata->feat, &nodeprudata->batch,
+               nodeprudata->safetyeps, &nodeprudata->profile, &nodeprudata->perfcnt, node, &score) );
+      }
       if( nodeprudata->checkopt )
-         SCIPnodeCheckOptimal(scip, node, nodeprudata->optsol);
+         SCIP_CALL( SCIPnodeCheckOptimal(scip, node, nodeprudata->opttable) );
       isoptimal = SCIPnodeIsOptimal(node);
 
       /*
@@ -226,7 +289,7 @@ SCIP_DECL_NODEPRUPRUNE(nodepruPruneDagger)
          *prune = (isoptimal == FALSE);
       else
       { */
-         if( SCIPsetIsGT(scip->set, SCIPnodeGetScore(node), 0) )
+         if( prunable && SCIPsetIsGT(scip->set, score, nodeprudata->threshold) )
          {
             /* don't prune optimal */
             /*
@@ -256,11 +319,15 @@ SCIP_DECL_NODEPRUPRUNE(nodepruPruneDagger)
       if( nodeprudata->trjfile != NULL )
       {
 #endif
+         start = SCIPprofileStart();
          SCIPdebugMessage("node pruning feature of node #%"SCIP_LONGINT_FORMAT"\n", SCIPnodeGetNumber(node));
-         SCIPfeatLIBSVMPrint(scip, nodeprudata->trjfile, nodeprudata->wfile, nodeprudata->feat, isoptimal ? -1 : 1);
+         SCIPfeatLIBSVMPrint(scip, nodeprudata->trjfile, nodeprudata->feat, isoptimal ? -1 : 1);
+         SCIPprofileStop(&nodeprudata->profile, SCIP_PROFPHASE_TRJWRITE, start);
 #ifndef SCIP_DEBUG
       }
 #endif
+
+      SCIPperfcntStop(&nodeprudata->perfcnt, SCIP_PERFREGION_CALLBACK, &prunesnap);
    }
 
    return SCIP_OKAY;
@@ -284,9 +351,16 @@ SCIP_RETCODE SCIPincludeNodepruDagger(
 
    nodepru = NULL;
    nodeprudata->optsol = NULL;
+   nodeprudata->opttable = NULL;
    nodeprudata->solfname = NULL;
    nodeprudata->trjfname = NULL;
    nodeprudata->polfname = NULL;
+   nodeprudata->statsfname = NULL;
+   nodeprudata->batch.numbers = NULL;
+   nodeprudata->batch.scores = NULL;
+   nodeprudata->batch.vals = NULL;
+   SCIPprofileReset(&nodeprudata->profile);
+   SCIPperfcntInit(&nodeprudata->perfcnt);
 
    /* use SCIPincludeNodepruBasic() plus setter functions if you want to set callbacks one-by-one and your code should
     * compile independent of new callbacks being added in future SCIP versions
@@ -315,6 +389,23 @@ SCIP_RETCODE SCIPincludeNodepruDagger(
          "nodepruning/"NODEPRU_NAME"/polfname",
          "name of the policy model file",
          &nodeprudata->polfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodepruning/"NODEPRU_NAME"/statsfname",
+         "name of the file to append the per-phase timing statistics to (empty: none)",
+         &nodeprudata->statsfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodepruning/"NODEPRU_NAME"/perfcounters",
+         "count cycles, instructions, cache and branch misses around prune, feature extraction and scoring?",
+         &nodeprudata->perfcounters, FALSE, DEFAULT_PERFCOUNTERS, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodepruning/"NODEPRU_NAME"/safetyeps",
+         "never prune a node whose lower bound is within this relative distance of the dual bound (-1: off)",
+         &nodeprudata->safetyeps, FALSE, DEFAULT_SAFETYEPS, -1.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodepruning/"NODEPRU_NAME"/threshold",
+         "prune a node if the pruning model output is above this (0: sign of a margin such as a linear SVM or "
+         "binary:logitraw, 0.5: binary:logistic probability)",
+         &nodeprudata->threshold, FALSE, DEFAULT_THRESHOLD, -SCIP_REAL_MAX, SCIP_REAL_MAX, NULL, NULL) );
 
    return SCIP_OKAY;
 }
@@ -31,11 +31,11 @@
 struct SCIP_NodepruData
 {
    SCIP_SOL*          optsol;             /**< optimal solution */
+   SCIP_OPTTABLE*     opttable;           /**< optimal values of the active variables */
    SCIP_FEAT*         feat;               /**< optimal solution */
    char*              solfname;           /**< name of the solution file */
    char*              trjfname;           /**< name of the trajectory file */
    SCIP_Bool          checkopt;           /**< need to check node optimality? (don't need to if node selector is oracle or dagger */
-   FILE*              wfile;
    FILE*              trjfile;
 };
 
@@ -61,6 +61,7 @@ SCIP_DECL_NODEPRUINIT(nodepruInitOracle)
 
    SCIP_CALL( SCIPreadOptSol(scip, nodeprudata->solfname, &nodeprudata->optsol) );
    assert(nodeprudata->optsol != NULL);
+   SCIP_CALL( SCIPopttableCreate(scip, &nodeprudata->opttable, nodeprudata->optsol) );
 #ifdef SCIP_DEBUG
    SCIP_CALL( SCIPprintSol(scip, nodeprudata->optsol, NULL, FALSE) );
 #endif
@@ -74,10 +75,6 @@ SCIP_DECL_NODEPRUINIT(nodepruInitOracle)
    nodeprudata->trjfile = NULL;
    if( nodeprudata->trjfname != NULL )
    {
-      char wfname[SCIP_MAXSTRLEN];
-      strcpy(wfname, nodeprudata->trjfname);
-      strcat(wfname, ".weight");
-      nodeprudata->wfile = fopen(wfname, "a");
       nodeprudata->trjfile = fopen(nodeprudata->trjfname, "a");
    }
 
@@ -101,6 +98,7 @@ SCIP_DECL_NODEPRUEXIT(nodepruExitOracle)
    nodeprudata = SCIPnodepruGetData(nodepru);
 
    assert(nodeprudata->optsol != NULL);
+   SCIPopttableFree(scip, &nodeprudata->opttable);
    SCIP_CALL( SCIPfreeSolSelf(scip, &nodeprudata->optsol) );
    nodeprudata->optsol = NULL;
 
@@ -112,10 +110,8 @@ SCIP_DECL_NODEPRUEXIT(nodepruExitOracle)
 
    if( nodeprudata->trjfile != NULL)
    {
-      fclose(nodeprudata->wfile);
       fclose(nodeprudata->trjfile);
       nodeprudata->trjfile = NULL;
-      nodeprudata->wfile = NULL;
    }
 
    nodeprudata->checkopt = FALSE;
@@ -144,7 +140,6 @@ static
 SCIP_DECL_NODEPRUPRUNE(nodepruPruneOracle)
 {
    SCIP_NODEPRUDATA* nodeprudata;
-   SCIP_SOL* optsol;
    SCIP_Bool isoptimal;
 
    assert(nodepru != NULL);
@@ -154,8 +149,7 @@ SCIP_DECL_NODEPRUPRUNE(nodepruPruneOracle)
 
    nodeprudata = SCIPnodepruGetData(nodepru);
    assert(nodeprudata != NULL);
-   optsol = nodeprudata->optsol;
-   assert(optsol != NULL);
+   assert(nodeprudata->opttable != NULL);
 
    /* don't prune the root */
    if( SCIPnodeGetDepth(node) == 0 )
@@ -166,7 +160,7 @@ SCIP_DECL_NODEPRUPRUNE(nodepruPruneOracle)
    else
    {
       if( nodeprudata->checkopt )
-         SCIPnodeCheckOptimal(scip, node, optsol);
+         SCIP_CALL( SCIPnodeCheckOptimal(scip, node, nodeprudata->opttable) );
       isoptimal = SCIPnodeIsOptimal(node);
       if( isoptimal )
          *prune = FALSE;
@@ -182,7 +176,7 @@ SCIP_DECL_NODEPRUPRUNE(nodepruPruneOracle)
 #endif
          SCIPcalcNodepruFeat(scip, node, nodeprudata->feat);
          SCIPdebugMessage("node pruning feature of node #%"SCIP_LONGINT_FORMAT"\n", SCIPnodeGetNumber(node));
-         SCIPfeatLIBSVMPrint(scip, nodeprudata->trjfile, nodeprudata->wfile, nodeprudata->feat, *prune ? 1 : -1);
+         SCIPfeatLIBSVMPrint(scip, nodeprudata->trjfile, nodeprudata->feat, *prune ? 1 : -1);
       }
 #ifndef SCIP_DEBUG
    }
@@ -208,6 +202,7 @@ SCIP_RETCODE SCIPincludeNodepruOracle(
 
    nodepru = NULL;
    nodeprudata->optsol = NULL;
+   nodeprudata->opttable = NULL;
    nodeprudata->solfname = NULL;
    nodeprudata->trjfname = NULL;
 
@@ -28,6 +28,8 @@
 #include "scip/clock.h"
 #include "scip/struct_set.h"
 #include "scip/struct_scip.h"
+#include "profile.h"
+#include "perfcnt.h"
 
 #define NODEPRU_NAME            "policy"
 #define NODEPRU_DESC            "node pruner which pruects node according to a policy but writes exampels according to the oracle"
@@ -35,6 +37,9 @@
 #define NODEPRU_MEMSAVEPRIORITY 0
 
 #define DEFAULT_FILENAME        ""
+#define DEFAULT_PERFCOUNTERS    FALSE    /**< count hardware events around the prune callback? */
+#define DEFAULT_SAFETYEPS       0.0      /**< keep nodes within this relative distance of the dual bound (-1: off) */
+#define DEFAULT_THRESHOLD       0.0      /**< prune nodes whose pruning model output is above this */
 
 /*
  * Data structures
@@ -47,6 +52,14 @@ struct SCIP_NodepruData
    SCIP_POLICY*       policy;
    SCIP_FEAT*         feat;
    int                nprunes;
+   char*              statsfname;         /**< name of the file to append the phase statistics to */
+   SCIP_PROFILE       profile;            /**< per-phase timing */
+   SCIP_Bool          perfcounters;       /**< count hardware events around the prune callback? */
+   SCIP_PERFCNT       perfcnt;            /**< hardware event counts per region */
+   SCIP_Real          safetyeps;          /**< keep nodes within this relative distance of the dual bound (-1: off) */
+   SCIP_Real          threshold;          /**< prune nodes whose pruning model output is above this */
+   SCIP_PRUNEBATCH    batch;              /**< pruning scores of the last batch of nodes */
+   int                nsafe;              /**< number of nodes kept by the safety rule */
 };
 
 void SCIPnodeprupolicyPrintStatistics(
@@ -56,6 +69,7 @@ void SCIPnodeprupolicyPrintStatistics(
    )
 {
    SCIP_NODEPRUDATA* nodeprudata;
+   SCIP_Longint nnodes;
 
    assert(scip != NULL);
    assert(nodepru != NULL);
@@ -69,6 +83,18 @@ void SCIPnodeprupolicyPrintStatistics(
          "  nodes pruned     : %10d\n", nodeprudata->nprunes);
    SCIPmessageFPrintInfo(scip->messagehdlr, file, 
          "  pruning time     : %10.2f\n", SCIPnodepruGetTime(nodepru));
+   SCIPmessageFPrintInfo(scip->messagehdlr, file,
+         "  kept by safety   : %10d\n", nodeprudata->nsafe);
+   SCIPmessageFPrintInfo(scip->messagehdlr, file,
+         "  model batches    : %10d\n", nodeprudata->batch.nbatches);
+   /* a pruned node's LP is never solved; estimated by the averages over the nodes solved below the root */
+   nnodes = MAX(SCIPgetNNodes(scip) - 1, 1);
+   SCIPmessageFPrintInfo(scip->messagehdlr, file,
+         "  LP solves saved  : %10.0f\n", (SCIP_Real)nodeprudata->nprunes * SCIPgetNNodeLPs(scip) / nnodes);
+   SCIPmessageFPrintInfo(scip->messagehdlr, file,
+         "  LP iters saved   : %10.0f\n", (SCIP_Real)nodeprudata->nprunes * SCIPgetNNodeLPIterations(scip) / nnodes);
+   SCIPprofilePrint(scip, &nodeprudata->profile, file);
+   SCIPperfcntPrint(scip, &nodeprudata->perfcnt, file);
 }
 
 /** solving process initialization method of node pruner (called when branch and bound process is about to begin) */
@@ -86,7 +112,6 @@ SCIP_DECL_NODEPRUINIT(nodepruInitPolicy)
    SCIP_CALL( SCIPpolicyCreate(scip, &nodeprudata->policy) );
    assert(nodeprudata->polfname != NULL);
    SCIP_CALL( SCIPreadNNPolicy(scip, nodeprudata->polfname, &nodeprudata->policy) );
-   assert(nodeprudata->policy->weights != NULL);
   
    /* create feat */
    nodeprudata->feat = NULL;
@@ -95,7 +120,14 @@ SCIP_DECL_NODEPRUINIT(nodepruInitPolicy)
    SCIPfeatSetMaxDepth(nodeprudata->feat, SCIPgetNBinVars(scip) + SCIPgetNIntVars(scip));
 
    nodeprudata->nprunes = 0;
- 
+   nodeprudata->nsafe = 0;
+   SCIP_CALL( SCIPpruneBatchInit(scip, &nodeprudata->batch) );
+   SCIPprofileReset(&nodeprudata->profile);
+   if( nodeprudata->perfcounters )
+   {
+      SCIP_CALL( SCIPperfcntOpen(scip, &nodeprudata->perfcnt) );
+   }
+
    return SCIP_OKAY;
 }
 
@@ -109,11 +141,20 @@ SCIP_DECL_NODEPRUEXIT(nodepruExitPolicy)
 
    nodeprudata = SCIPnodepruGetData(nodepru);
 
+   if( nodeprudata->statsfname != NULL && nodeprudata->statsfname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPprofileWrite(scip, &nodeprudata->profile, nodeprudata->statsfname, "nodepru."NODEPRU_NAME) );
+      SCIP_CALL( SCIPperfcntWrite(scip, &nodeprudata->perfcnt, nodeprudata->statsfname, "nodepru."NODEPRU_NAME) );
+   }
+   SCIPperfcntClose(&nodeprudata->perfcnt);
+
    assert(nodeprudata->feat != NULL);
    SCIP_CALL( SCIPfeatFree(scip, &nodeprudata->feat) );
 
    assert(nodeprudata->policy != NULL);
    SCIP_CALL( SCIPpolicyFree(scip, &nodeprudata->policy) );
+
+   SCIPpruneBatchExit(scip, &nodeprudata->batch);
   
    return SCIP_OKAY;
 }
@@ -139,6 +180,9 @@ static
 SCIP_DECL_NODEPRUPRUNE(nodepruPrunePolicy)
 {
    SCIP_NODEPRUDATA* nodeprudata;
+   SCIP_Bool prunable;
+   SCIP_PERFSNAP prunesnap;
+   SCIP_Real score;
 
    assert(nodepru != NULL);
    assert(strcmp(SCIPnodepruGetName(nodepru), NODEPRU_NAME) == 0);
@@ -156,14 +200,22 @@ SCIP_DECL_NODEPRUPRUNE(nodepruPrunePolicy)
    }
    else
    {
-      SCIPcalcNodepruFeat(scip, node, nodeprudata->feat);
-      /*
-      SCIPclockStart(nodeprudata->featcalctime, scip->set);
-      SCIPclockStop(nodeprudata->featcalctime, scip->set);
-      */
-      SCIPcalcNodeScore(node, nodeprudata->feat, nodeprudata->policy);
-
-      if( SCIPsetIsGT(scip->set, SCIPnodeGetScore(node), 0) )
+      SCIPperfcntStart(&nodeprudata->perfcnt, &prunesnap);
+
+      /* the score is kept apart from the node score, which belongs to the node selector */
+      prunable = SCIPpolicyIsPrunable(scip, node, nodeprudata->safetyeps);
+      if( !prunable )
+      {
+         score = 0.0;
+         nodeprudata->nsafe++;
+      }
+      else
+      {
+         SCIP_CALL( SCIPpolicyGetPruneScore(scip, nodeprudata->policy, nodeprudata->feat, &nodeprudata->batch,
+               nodeprudata->safetyeps, &nodeprudata->profile, &nodeprudata->perfcnt, node, &score) );
+      }
+
+      if( prunable && SCIPsetIsGT(scip->set, score, nodeprudata->threshold) )
       {
          *prune = TRUE;
          nodeprudata->nprunes++;
@@ -171,6 +223,8 @@ SCIP_DECL_NODEPRUPRUNE(nodepruPrunePolicy)
       }
       else
          *prune = FALSE;
+
+      SCIPperfcntStop(&nodeprudata->perfcnt, SCIP_PERFREGION_CALLBACK, &prunesnap);
    }
 
    return SCIP_OKAY;
@@ -194,6 +248,12 @@ SCIP_RETCODE SCIPincludeNodepruPolicy(
 
    nodepru = NULL;
    nodeprudata->polfname = NULL;
+   nodeprudata->statsfname = NULL;
+   nodeprudata->batch.numbers = NULL;
+   nodeprudata->batch.scores = NULL;
+   nodeprudata->batch.vals = NULL;
+   SCIPprofileReset(&nodeprudata->profile);
+   SCIPperfcntInit(&nodeprudata->perfcnt);
 
    /* use SCIPincludeNodepruBasic() plus setter functions if you want to set callbacks one-by-one and your code should
     * compile independent of new callbacks being added in future SCIP versions
@@ -214,6 +274,23 @@ SCIP_RETCODE SCIPincludeNodepruPolicy(
          "nodepruning/"NODEPRU_NAME"/polfname",
          "name of the policy model file",
          &nodeprudata->polfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodepruning/"NODEPRU_NAME"/statsfname",
+         "name of the file to append the per-phase timing statistics to (empty: none)",
+         &nodeprudata->statsfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodepruning/"NODEPRU_NAME"/perfcounters",
+         "count cycles, instructions, cache and branch misses around prune, feature extraction and scoring?",
+         &nodeprudata->perfcounters, FALSE, DEFAULT_PERFCOUNTERS, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodepruning/"NODEPRU_NAME"/safetyeps",
+         "never prune a node whose lower bound is within this relative distance of the dual bound (-1: off)",
+         &nodeprudata->safetyeps, FALSE, DEFAULT_SAFETYEPS, -1.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodepruning/"NODEPRU_NAME"/threshold",
+         "prune a node if the pruning model output is above this (0: sign of a margin such as a linear SVM or "
+         "binary:logitraw, 0.5: binary:logistic probability)",
+         &nodeprudata->threshold, FALSE, DEFAULT_THRESHOLD, -SCIP_REAL_MAX, SCIP_REAL_MAX, NULL, NULL) );
 
    return SCIP_OKAY;
 }
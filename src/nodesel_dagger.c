@@ -1,4 +1,3 @@
-#define SCIP_DEBUG
 /**@file   nodesel_dagger.c
  * @brief  uct node selector which balances exploration and exploitation by considering node visits
  * @author Gregor Hendel
@@ -27,6 +26,15 @@
 #include "scip/struct_set.h"
 #include "scip/struct_scip.h"
 #include "time.h"
+#include "evtlog.h"
+#include "treesampler.h"
+#include "livestat.h"
+#include "profile.h"
+#include "hist.h"
+#include "trace.h"
+#include "perfcnt.h"
+#include "chrometrace.h"
+#include "memacct.h"
 
 #include "scip/prob.h"
 #include "scip/type_sol.h"
@@ -38,6 +46,11 @@
 #define NODESEL_MEMSAVEPRIORITY 0
 
 #define DEFAULT_FILENAME        ""
+#define DEFAULT_TRACELEVEL      0        /**< trace level of the text log (0: final solutions, 1: selections, 2: nodes) */
+#define DEFAULT_TRACERINGSIZE   1024     /**< number of recent events kept for dumps at exit or after errors */
+#define DEFAULT_SAMPLEFREQ      100      /**< sample the open nodes every this many selections (0: never by count) */
+#define DEFAULT_SAMPLEINTERVAL  1.0      /**< sample the open nodes every this many seconds (0: never by time) */
+#define DEFAULT_PERFCOUNTERS    FALSE    /**< count hardware events around the select callback? */
 
 /*
  * Data structures
@@ -48,11 +61,27 @@ struct SCIP_NodeselData
 {
    char*              solfname;           /**< name of the solution file */
    SCIP_SOL*          optsol;             /**< optimal solution */
+   SCIP_OPTTABLE*     opttable;           /**< optimal values of the active variables */
    char*              polfname;           /**< name of the solution file */
    SCIP_POLICY*       policy;
    char*              trjfname;           /**< name of the trajectory file */
-   FILE*              wfile;
    FILE*              trjfile;
+   SCIP_Longint       trjstart;           /**< size of the trajectory file when it was opened */
+   char*              evtfname;           /**< name of the binary event log file */
+   SCIP_EVTLOG*       evtlog;             /**< binary event log, or NULL */
+   char*              samplefname;        /**< name of the open-node sample file */
+   SCIP_TREESAMPLER*  sampler;            /**< open-node sampler, or NULL */
+   int                samplefreq;         /**< sample every this many selections */
+   SCIP_Real          sampleinterval;     /**< sample every this many seconds */
+   char*              statsfname;         /**< name of the file to append the phase statistics to */
+   SCIP_PROFILE       profile;            /**< per-phase timing */
+   SCIP_HIST          selecthist;         /**< latency of the select callback */
+   SCIP_Bool          perfcounters;       /**< count hardware events around the select callback? */
+   SCIP_PERFCNT       perfcnt;            /**< hardware event counts per region */
+   SCIP_TRACE*        trace;              /**< runtime trace */
+   int                tracelevel;         /**< trace level of the text log */
+   int                traceringsize;      /**< number of recent events kept in the trace ring buffer */
+   char*              tracefname;         /**< name of the file to dump the trace ring buffer to at exit */
    SCIP_FEAT*         feat;
    SCIP_FEAT*         optfeat;
 #ifndef NDEBUG
@@ -86,6 +115,12 @@ void SCIPnodeseldaggerPrintStatistics(
          "  comp error rate  : %d/%d\n", nodeseldata->nerrors, nodeseldata->ncomps);
    SCIPmessageFPrintInfo(scip->messagehdlr, file,
          "  selection time   : %10.2f\n", SCIPnodeselGetTime(nodesel));
+   SCIPprofilePrint(scip, &nodeseldata->profile, file);
+   SCIPhistPrintHeader(scip, file);
+   SCIPhistPrint(scip, &nodeseldata->selecthist, "select", file);
+   if( nodeseldata->policy != NULL )
+      SCIPhistPrint(scip, &nodeseldata->policy->modelhist, "model", file);
+   SCIPperfcntPrint(scip, &nodeseldata->perfcnt, file);
 }
 
 /** solving process initialization method of node selector (called when branch and bound process is about to begin) */
@@ -104,9 +139,9 @@ SCIP_DECL_NODESELINIT(nodeselInitDagger)
    nodeseldata->optsol = NULL;
    SCIP_CALL( SCIPreadOptSol(scip, nodeseldata->solfname, &nodeseldata->optsol) );
    assert(nodeseldata->optsol != NULL);
-#ifdef SCIP_DEBUG
+   SCIP_CALL( SCIPopttableCreate(scip, &nodeseldata->opttable, nodeseldata->optsol) );
+   /* the log parsers expect the optimal solution before the solutions found */
    SCIP_CALL( SCIPprintSol(scip, nodeseldata->optsol, NULL, FALSE) );
-#endif
 
    /* read policy */
    SCIP_CALL( SCIPpolicyCreate(scip, &nodeseldata->policy) );
@@ -119,12 +154,24 @@ SCIP_DECL_NODESELINIT(nodeselInitDagger)
    nodeseldata->trjfile = NULL;
    if( nodeseldata->trjfname != NULL )
    {
-      char wfname[SCIP_MAXSTRLEN];
-      strcpy(wfname, nodeseldata->trjfname);
-      strcat(wfname, ".weight");
-      nodeseldata->wfile = fopen(wfname, "a");
       nodeseldata->trjfile = fopen(nodeseldata->trjfname, "a");
    }
+   nodeseldata->trjstart = 0;
+   if( nodeseldata->trjfile != NULL && fseek(nodeseldata->trjfile, 0L, SEEK_END) == 0 )
+      nodeseldata->trjstart = (SCIP_Longint)ftell(nodeseldata->trjfile);
+
+   nodeseldata->evtlog = NULL;
+   if( nodeseldata->evtfname != NULL && nodeseldata->evtfname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPevtlogCreate(scip, &nodeseldata->evtlog, nodeseldata->evtfname) );
+   }
+
+   nodeseldata->sampler = NULL;
+   if( nodeseldata->samplefname != NULL && nodeseldata->samplefname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPtreesamplerCreate(scip, &nodeseldata->sampler, nodeseldata->samplefname, nodeseldata->samplefreq,
+            nodeseldata->sampleinterval) );
+   }
 
    /* create feat */
    nodeseldata->feat = NULL;
@@ -159,6 +206,16 @@ SCIP_DECL_NODESELINIT(nodeselInitDagger)
    nodeseldata->nerrors = 0;
    nodeseldata->ncomps = 0;
 
+   SCIPprofileReset(&nodeseldata->profile);
+   SCIPhistReset(&nodeseldata->selecthist);
+   if( nodeseldata->perfcounters )
+   {
+      SCIP_CALL( SCIPperfcntOpen(scip, &nodeseldata->perfcnt) );
+   }
+
+   SCIP_CALL( SCIPtraceCreate(scip, &nodeseldata->trace, "nodesel."NODESEL_NAME, nodeseldata->tracelevel,
+         nodeseldata->traceringsize) );
+
    return SCIP_OKAY;
 }
 
@@ -172,15 +229,37 @@ SCIP_DECL_NODESELEXIT(nodeselExitDagger)
 
    nodeseldata = SCIPnodeselGetData(nodesel);
 
+   if( nodeseldata->statsfname != NULL && nodeseldata->statsfname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPprofileWrite(scip, &nodeseldata->profile, nodeseldata->statsfname, "nodesel."NODESEL_NAME) );
+      SCIP_CALL( SCIPhistWrite(scip, &nodeseldata->selecthist, nodeseldata->statsfname, "nodesel."NODESEL_NAME,
+            "select") );
+      SCIP_CALL( SCIPhistWrite(scip, &nodeseldata->policy->modelhist, nodeseldata->statsfname,
+            "nodesel."NODESEL_NAME, "model") );
+      SCIP_CALL( SCIPperfcntWrite(scip, &nodeseldata->perfcnt, nodeseldata->statsfname, "nodesel."NODESEL_NAME) );
+      SCIP_CALL( SCIPmemacctWrite(scip, nodeseldata->statsfname, "nodesel."NODESEL_NAME) );
+   }
+   SCIPperfcntClose(&nodeseldata->perfcnt);
+
    assert(nodeseldata->optsol != NULL);
+   SCIPopttableFree(scip, &nodeseldata->opttable);
    SCIP_CALL( SCIPfreeSolSelf(scip, &nodeseldata->optsol) );
 
    if( nodeseldata->trjfile != NULL)
    {
-      fclose(nodeseldata->wfile);
       fclose(nodeseldata->trjfile);
    }
 
+   if( nodeseldata->evtlog != NULL )
+   {
+      SCIP_CALL( SCIPevtlogFree(scip, &nodeseldata->evtlog) );
+   }
+
+   if( nodeseldata->sampler != NULL )
+   {
+      SCIP_CALL( SCIPtreesamplerFree(scip, &nodeseldata->sampler) );
+   }
+
    assert(nodeseldata->feat != NULL);
    SCIP_CALL( SCIPfeatFree(scip, &nodeseldata->feat) );
 
@@ -196,6 +275,12 @@ SCIP_DECL_NODESELEXIT(nodeselExitDagger)
    assert(nodeseldata->policy != NULL);
    SCIP_CALL( SCIPpolicyFree(scip, &nodeseldata->policy) );
 
+   if( nodeseldata->tracefname != NULL && nodeseldata->tracefname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPtraceDumpFile(nodeseldata->trace, nodeseldata->tracefname) );
+   }
+   SCIP_CALL( SCIPtraceFree(scip, &nodeseldata->trace) );
+
    return SCIP_OKAY;
 }
 
@@ -223,6 +308,11 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
    SCIP_NODE** leaves;
    SCIP_NODE** children;
    SCIP_NODE** siblings;
+   SCIP_Longint selectstart;
+   SCIP_Longint selectend;
+   SCIP_PERFSNAP selectsnap;
+   SCIP_PERFSNAP snap;
+   SCIP_Longint start;
    int nleaves;
    int nsiblings;
    int nchildren;
@@ -241,6 +331,14 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
    nodeseldata = SCIPnodeselGetData(nodesel);
    assert(nodeseldata != NULL);
 
+   selectstart = SCIPprofileStart();
+   SCIPperfcntStart(&nodeseldata->perfcnt, &selectsnap);
+
+   if( nodeseldata->sampler != NULL )
+   {
+      SCIP_CALL( SCIPtreesamplerSelect(scip, nodeseldata->sampler) );
+   }
+
    /* collect leaves, children and siblings data */
    SCIP_CALL( SCIPgetOpenNodesData(scip, &leaves, &children, &siblings, &nleaves, &nchildren, &nsiblings) );
 
@@ -249,14 +347,23 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
    for( i = 0; i < nchildren; i++)
    {
       /* compute score */
+      start = SCIPprofileStart();
+      SCIPperfcntStart(&nodeseldata->perfcnt, &snap);
       SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
+      SCIPperfcntStop(&nodeseldata->perfcnt, SCIP_PERFREGION_FEAT, &snap);
+      SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_FEAT, start);
+
+      start = SCIPprofileStart();
+      SCIPperfcntStart(&nodeseldata->perfcnt, &snap);
       SCIPcalcNNNodeScore(children[i], nodeseldata->feat, nodeseldata->policy);
+      SCIPperfcntStop(&nodeseldata->perfcnt, SCIP_PERFREGION_MODEL, &snap);
+      SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_MODEL, start);
       // SCIPcalcNNNodeScoreConcat(children[i], nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, nodeseldata->policy);
 
       /* check optimality */
       if( ! SCIPnodeIsOptchecked(children[i]) )
       {
-         SCIPnodeCheckOptimal(scip, children[i], nodeseldata->optsol);
+         SCIP_CALL( SCIPnodeCheckOptimal(scip, children[i], nodeseldata->opttable) );
          SCIPnodeSetOptchecked(children[i]);
       }
       if( SCIPnodeIsOptimal(children[i]) )
@@ -271,7 +378,10 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
       //    SCIPcalcNodeselFeat(scip, children[i], nodeseldata->left_feat);
       // if (SCIPnodeGetNumber(children[i]) == 3)
       //    SCIPcalcNodeselFeat(scip, children[i], nodeseldata->right_feat);
-      if (TRUE)
+      SCIPtraceRecord(nodeseldata->trace, SCIP_TRACEEVT_NODE, SCIPnodeGetNumber(children[i]), SCIPnodeIsOptimal(children[i]),
+         SCIPnodeGetLowerbound(children[i]), SCIPnodeGetScore(children[i]), (SCIP_Real)SCIPnodeGetDepth(children[i]), 0.0);
+
+      if( SCIPtraceIsOn(nodeseldata->trace, SCIP_TRACELEVEL_NODE) )
       {
          SCIP_Real nodelowerbound = SCIPnodeGetLowerbound(children[i]);
          SCIP_Real primalbound = SCIPgetPrimalbound(scip);
@@ -279,13 +389,15 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
          int idx = (int)SCIPnodeGetNumber(children[i]);
          SCIP_Real score = SCIPnodeGetScore(children[i]);
 
-         SCIPdebugMessage("checking node %d pb %.3f db %.3f nlb %.3f score %f\n", idx, primalbound, dualbound, nodelowerbound, score);
+         SCIPtraceMessage("checking node %d pb %.3f db %.3f nlb %.3f score %f\n", idx, primalbound, dualbound, nodelowerbound, score);
       }
    }
 
    /* write examples */
    if( nodeseldata->trjfile != NULL)
    {
+      start = SCIPprofileStart();
+
       /* new opt*/
       if( optchild != -1 )
       {
@@ -296,24 +408,24 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
             {
                SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
                SCIPdebugMessage("example  #%d #%d\n", (int)nodeseldata->optnodenumber, (int)SCIPnodeGetNumber(children[i]));
-               SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->feat, -1, nodeseldata->negate);
+               SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->feat, -1, nodeseldata->negate);
             }
             else
             {
-               SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, 1, nodeseldata->negate);
+               SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, 1, nodeseldata->negate);
             }
          }
          for ( i = 0; i < nsiblings; i++)
          {
             SCIPcalcNodeselFeat(scip, siblings[i], nodeseldata->feat);
             SCIPdebugMessage("example  #%d #%d\n", (int)nodeseldata->optnodenumber, (int)SCIPnodeGetNumber(siblings[i]));
-            SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->feat, -1, nodeseldata->negate);
+            SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->feat, -1, nodeseldata->negate);
          }
          for (i = 0; i < nleaves; i++)
          {
             SCIPcalcNodeselFeat(scip, leaves[i], nodeseldata->feat);
             SCIPdebugMessage("example  #%d #%d\n", (int)nodeseldata->optnodenumber, (int)SCIPnodeGetNumber(leaves[i]));
-            SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->feat, -1, nodeseldata->negate);
+            SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->feat, -1, nodeseldata->negate);
          }
       }
       else
@@ -324,12 +436,18 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
          {
             SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
             SCIPdebugMessage("example  #%d #%d\n", (int)nodeseldata->optnodenumber, (int)SCIPnodeGetNumber(children[i]));
-            SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->feat, -1, nodeseldata->negate);
+            SCIPfeatNNPrint(scip, nodeseldata->trjfile, nodeseldata->feat, -1, nodeseldata->negate);
          }
       }
+
+      SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_TRJWRITE, start);
    }
 
-   if (TRUE)
+   /* the rank of the optimal node and the selection log are timed together as logging */
+   start = SCIPprofileStart();
+
+   /* rank of the optimal node among the open nodes; scans the whole queue */
+   if( SCIPtraceIsOn(nodeseldata->trace, SCIP_TRACELEVEL_NODE) )
    {
       for( i = 0; i < nchildren; i++)
          if (children[i] != NULL)
@@ -362,15 +480,36 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
             max_score = SCIPisLE(scip, max_score, SCIPnodeGetScore(leaves[i])) ? SCIPnodeGetScore(leaves[i]) : max_score;
          }
       if (SCIPisEQ(scip, opt_score, -100.0))
-         SCIPdebugMessage("opt is not in PQ, total %d max_score %.3f\n", nleaves+nchildren+nsiblings, max_score);
+         SCIPtraceMessage("opt is not in PQ, total %d max_score %.3f\n", nleaves+nchildren+nsiblings, max_score);
       else
-         SCIPdebugMessage("opt is better than %d total %d max_score %.3f opt_score %.3f\n", smaller_nodes, nleaves+nchildren+nsiblings, max_score, opt_score);
+         SCIPtraceMessage("opt is better than %d total %d max_score %.3f opt_score %.3f\n", smaller_nodes, nleaves+nchildren+nsiblings, max_score, opt_score);
    }
 
    /* experiment start: ml-HeFeatures */
    *selnode = SCIPgetBestNode(scip);
 
-   if (TRUE)
+   if( SCIPlivestatIsDue() )
+   {
+      SCIPlivestatPublishNodesel(NODESEL_NAME, &nodeseldata->policy->modelhist,
+         nodeseldata->trjfile != NULL ? (SCIP_Longint)ftell(nodeseldata->trjfile) - nodeseldata->trjstart : -1);
+   }
+
+   if( *selnode != NULL )
+   {
+      SCIPtraceRecord(nodeseldata->trace, SCIP_TRACEEVT_SELECT, SCIPnodeGetNumber(*selnode), nchildren + nsiblings + nleaves,
+         SCIPnodeGetLowerbound(*selnode), SCIPgetPrimalbound(scip), SCIPgetDualbound(scip), SCIPnodeGetScore(*selnode));
+   }
+
+   if( nodeseldata->evtlog != NULL )
+   {
+      SCIP_CALL( SCIPevtlogSelect(scip, nodeseldata->evtlog, *selnode, nchildren + nsiblings + nleaves,
+            *selnode != NULL && SCIPnodeIsOptimal(*selnode)) );
+   }
+
+   /* text log of the selection, written from trace level 1 unless there is an event log; the final solutions are
+    * always printed
+    */
+   if( (nodeseldata->evtlog == NULL && SCIPtraceIsOn(nodeseldata->trace, SCIP_TRACELEVEL_SELECT)) || *selnode == NULL )
    {
       int idx = -1;
       int isopt = -1;
@@ -400,8 +539,10 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
 
       if (*selnode != NULL)
       {
-         SCIPprintNodeRootPath(scip, *selnode, NULL);        
          idx = SCIPnodeGetNumber(*selnode);
+
+         /* without an event log, the branching path of a selection is only in the text log */
+         SCIPprintNodeRootPath(scip, *selnode, NULL);
         
          if (SCIPnodeIsOptimal(*selnode))
             isopt = 1;
@@ -410,7 +551,7 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
          score = SCIPnodeGetScore(*selnode);
          lowerbound = SCIPnodeGetLowerbound(*selnode);
 
-         SCIPdebugMessage("final selecting node number %d primalbound %.3f lowerbound %.3f dualbound %.3f time %.2f depth %d left %d bPB_time %.2f opt %d score %.3f nsols %d ",
+         SCIPtraceMessage("final selecting node number %d primalbound %.3f lowerbound %.3f dualbound %.3f time %.2f depth %d left %d bPB_time %.2f opt %d score %.3f nsols %d ",
                                                    idx, primalbound, lowerbound, dualbound, current_time, depth, left, bPB_time, isopt, score, nsols);
 
          SCIP_SOL** sols_top5;
@@ -449,6 +590,13 @@ SCIP_DECL_NODESELSELECT(nodeselSelectDagger)
       }
    }
    /* experiment end */
+
+   SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_LOG, start);
+   selectend = SCIPprofileStart();
+   SCIPhistAdd(&nodeseldata->selecthist, selectend - selectstart);
+   SCIPchrometraceSpan("select", selectstart, selectend);
+   SCIPperfcntStop(&nodeseldata->perfcnt, SCIP_PERFREGION_CALLBACK, &selectsnap);
+
    return SCIP_OKAY;
 }
 
@@ -463,6 +611,8 @@ SCIP_DECL_NODESELCOMP(nodeselCompDagger)
    SCIP_Bool isopt1;
    SCIP_Bool isopt2;
    SCIP_NODESELDATA* nodeseldata;
+   SCIP_Longint start;
+   SCIP_Bool timed;
    int result;
    // SCIP_Real mid = 0.5;
 
@@ -476,6 +626,13 @@ SCIP_DECL_NODESELCOMP(nodeselCompDagger)
    assert(SCIPnodeIsOptchecked(node1) == TRUE);
    assert(SCIPnodeIsOptchecked(node2) == TRUE);
 
+   nodeseldata = SCIPnodeselGetData(nodesel);
+   assert(nodeseldata != NULL);
+
+   /* only a sample of the calls is timed, the clock reads would cost more than the comparison */
+   timed = SCIPprofileSampleComp(&nodeseldata->profile);
+   start = timed ? SCIPprofileStart() : 0;
+
    score1 = SCIPnodeGetScore(node1);
    score2 = SCIPnodeGetScore(node2);
 
@@ -588,8 +745,6 @@ SCIP_DECL_NODESELCOMP(nodeselCompDagger)
       }
    }
 
-   nodeseldata = SCIPnodeselGetData(nodesel);
-   assert(nodeseldata != NULL);
    isopt1 = SCIPnodeIsOptimal(node1);
    isopt2 = SCIPnodeIsOptimal(node2);
    if( (isopt1 && result == 1) || (isopt2 && result == -1) )
@@ -598,6 +753,9 @@ SCIP_DECL_NODESELCOMP(nodeselCompDagger)
    if( isopt1 || isopt2 )
       nodeseldata->ncomps++;
 
+   if( timed )
+      SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_COMP, start);
+
    return result;
 }
 
@@ -618,9 +776,21 @@ SCIP_RETCODE SCIPincludeNodeselDagger(
 
    nodesel = NULL;
    nodeseldata->optsol = NULL;
+   nodeseldata->opttable = NULL;
    nodeseldata->solfname = NULL;
    nodeseldata->trjfname = NULL;
    nodeseldata->polfname = NULL;
+   nodeseldata->evtfname = NULL;
+   nodeseldata->samplefname = NULL;
+   nodeseldata->sampler = NULL;
+   nodeseldata->evtlog = NULL;
+   nodeseldata->statsfname = NULL;
+   nodeseldata->policy = NULL;
+   nodeseldata->trace = NULL;
+   nodeseldata->tracefname = NULL;
+   SCIPprofileReset(&nodeseldata->profile);
+   SCIPhistReset(&nodeseldata->selecthist);
+   SCIPperfcntInit(&nodeseldata->perfcnt);
 
    /* use SCIPincludeNodeselBasic() plus setter functions if you want to set callbacks one-by-one and your code should
     * compile independent of new callbacks being added in future SCIP versions
@@ -645,6 +815,42 @@ SCIP_RETCODE SCIPincludeNodeselDagger(
          "nodeselection/"NODESEL_NAME"/trjfname",
          "name of the file to write node selection trajectories",
          &nodeseldata->trjfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/evtfname",
+         "name of the file to write the binary solve-event log (empty: text log only)",
+         &nodeseldata->evtfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/samplefname",
+         "name of the file to write open-node queue samples to (empty: no sampling)",
+         &nodeseldata->samplefname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/samplefreq",
+         "sample the open nodes every this many selections (0: never by count)",
+         &nodeseldata->samplefreq, FALSE, DEFAULT_SAMPLEFREQ, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/sampleinterval",
+         "sample the open nodes every this many seconds of wall clock time (0: never by time)",
+         &nodeseldata->sampleinterval, FALSE, DEFAULT_SAMPLEINTERVAL, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/statsfname",
+         "name of the file to append the per-phase timing statistics to (empty: none)",
+         &nodeseldata->statsfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodeselection/"NODESEL_NAME"/perfcounters",
+         "count cycles, instructions, cache and branch misses around select, feature extraction and scoring?",
+         &nodeseldata->perfcounters, FALSE, DEFAULT_PERFCOUNTERS, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/tracelevel",
+         "trace level of the text log (0: final solutions only, 1: one line per selection, 2: also per node)",
+         &nodeseldata->tracelevel, FALSE, DEFAULT_TRACELEVEL, 0, 2, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/traceringsize",
+         "number of recent events kept in memory and dumped at exit or after an error (0: none)",
+         &nodeseldata->traceringsize, FALSE, DEFAULT_TRACERINGSIZE, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/tracefname",
+         "name of the file to dump the recent events to at exit (empty: dumped only after an error)",
+         &nodeseldata->tracefname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
    SCIP_CALL( SCIPaddStringParam(scip,
          "nodeselection/"NODESEL_NAME"/polfname",
          "name of the policy model file",
@@ -1,4 +1,3 @@
-#define SCIP_DEBUG
 /**@file   nodesel_uct.c
  * @brief  uct node selector which balances exploration and exploitation by considering node visits
  * @author Gregor Hendel
@@ -19,6 +18,13 @@
 #include <string.h>
 #include "nodesel_oracle.h"
 #include "feat.h"
+#include "trjsink.h"
+#include "evtlog.h"
+#include "treesampler.h"
+#include "livestat.h"
+#include "trace.h"
+#include "profile.h"
+#include "chrometrace.h"
 #include "scip/sol.h"
 #include "scip/tree.h"
 #include "scip/struct_set.h"
@@ -37,6 +43,16 @@
 #define NODESEL_MEMSAVEPRIORITY 0
 
 #define DEFAULT_FILENAME        ""
+#define DEFAULT_TRJDEDUP        TRUE     /**< write each node's feature row only when it appears or changes */
+#define DEFAULT_TRJMAXPOSGROUPS 0        /**< budget for groups containing an optimal node (0: no limit) */
+#define DEFAULT_TRJMAXNEGGROUPS 0        /**< budget for pure-negative groups (0: no limit) */
+#define DEFAULT_TRJNEGRATE      1.0      /**< rate at which pure-negative groups are kept */
+#define DEFAULT_TRJSEED         0        /**< random seed of the trajectory sampler */
+#define DEFAULT_TRJAIO          FALSE    /**< write the trajectory through the asynchronous writer */
+#define DEFAULT_TRACELEVEL      0        /**< trace level of the text log (0: final solutions, 1: selections, 2: nodes) */
+#define DEFAULT_TRACERINGSIZE   1024     /**< number of recent events kept for dumps at exit or after errors */
+#define DEFAULT_SAMPLEFREQ      100      /**< sample the open nodes every this many selections (0: never by count) */
+#define DEFAULT_SAMPLEINTERVAL  1.0      /**< sample the open nodes every this many seconds (0: never by time) */
 
 /*
  * Data structures
@@ -46,10 +62,27 @@
 struct SCIP_NodeselData
 {
    SCIP_SOL*          optsol;             /**< optimal solution */
+   SCIP_OPTTABLE*     opttable;           /**< optimal values of the active variables */
    char*              solfname;           /**< name of the solution file */
    char*              trjfname;           /**< name of the trajectory file */
-   FILE*              trjfile;
-   FILE*              wfile;
+   SCIP_TRJSINK*      trjsink;            /**< sink for priority queue groups */
+   SCIP_Bool          trjdedup;           /**< write node-deduplicated groups? */
+   int                trjmaxposgroups;    /**< budget for groups containing an optimal node (0: no limit) */
+   int                trjmaxneggroups;    /**< budget for pure-negative groups (0: no limit) */
+   SCIP_Real          trjnegrate;         /**< rate at which pure-negative groups are kept */
+   int                trjseed;            /**< random seed of the trajectory sampler */
+   SCIP_Bool          trjaio;             /**< write the trajectory through the asynchronous writer? */
+   FILE*              trjfile;            /**< file of the trajectory sink (NULL with the asynchronous writer) */
+   char*              evtfname;           /**< name of the binary event log file */
+   SCIP_EVTLOG*       evtlog;             /**< binary event log, or NULL */
+   char*              samplefname;        /**< name of the open-node sample file */
+   SCIP_TREESAMPLER*  sampler;            /**< open-node sampler, or NULL */
+   int                samplefreq;         /**< sample every this many selections */
+   SCIP_Real          sampleinterval;     /**< sample every this many seconds */
+   SCIP_TRACE*        trace;              /**< runtime trace */
+   int                tracelevel;         /**< trace level of the text log */
+   int                traceringsize;      /**< number of recent events kept in the trace ring buffer */
+   char*              tracefname;         /**< name of the file to dump the trace ring buffer to at exit */
    SCIP_FEAT*         feat;
    SCIP_FEAT*         optfeat;
 #ifndef NDEBUG
@@ -69,29 +102,24 @@ struct SCIP_NodeselData
  * Local methods
  */
 
-/** check if the given node include the optimal solution */
+/** check if the given node include the optimal solution
+ *
+ * The parent is checked before its children are created, so only the branching bound changes that created the node
+ * have to be compared with the optimal solution; they are read directly from the node's domain changes.
+ */
 /* TODO: remove to ischecked */
 SCIP_RETCODE SCIPnodeCheckOptimal(
    SCIP*                 scip,               /**< SCIP data structure */
    SCIP_NODE*            node,               /**< the node in question */
-   SCIP_SOL*             optsol              /**< node selector data */
+   SCIP_OPTTABLE*        opttable            /**< optimal values */
    )
 {
-   /* get parent branch vars lead to this node */
-
-   SCIP_VAR**            branchvars;         /* array of variables on which the branchings has been performed in all ancestors */
-   SCIP_Real*            branchbounds;       /* array of bounds which the branchings in all ancestors set */
-   SCIP_BOUNDTYPE*       boundtypes;         /* array of boundtypes which the branchings in all ancestors set */
-   int                   nbranchvars;        /* number of variables on which branchings have been performed in all ancestors
-                                              *   if this is larger than the array size, arrays should be reallocated and method should be called again */
-   int                   branchvarssize;     /* available slots in arrays */
-
+   SCIP_BOUNDCHG* boundchgs;
+   int nboundchgs;
    int i;
    SCIP_NODE* parent;
-   SCIP_Bool isoptimal = TRUE;
 
-
-   assert(optsol != NULL);
+   assert(opttable != NULL);
    assert(node != NULL);
 
    // SCIPdebugMessage("checking node %d\n", (int)SCIPnodeGetNumber(node));
@@ -101,7 +129,7 @@ SCIP_RETCODE SCIPnodeCheckOptimal(
    /* don't consider root node */
    assert(SCIPnodeGetDepth(node) != 0);
    
-   if (TRUE)
+#ifdef SCIP_DEBUG
    {
       SCIP_Real nodelowerbound = SCIPnodeGetLowerbound(node);
       SCIP_Real primalbound = SCIPgetPrimalbound(scip);
@@ -110,6 +138,7 @@ SCIP_RETCODE SCIPnodeCheckOptimal(
 
       SCIPdebugMessage("checking node %d pb %.3f db %.3f nlb %.3f\n", idx, primalbound, dualbound, nodelowerbound);
    }
+#endif
 
    /* check parent: if parent is not optimal, its subtree is not optimal */
    parent = SCIPnodeGetParent(node);
@@ -117,49 +146,25 @@ SCIP_RETCODE SCIPnodeCheckOptimal(
    if( SCIPnodeGetDepth(parent) > 0 && !SCIPnodeIsOptimal(parent) )
       return SCIP_OKAY;
 
-   branchvarssize = 1;
-
-   /* memory allocation */
-   SCIP_CALL( SCIPallocBufferArray(scip, &branchvars, branchvarssize) );
-   SCIP_CALL( SCIPallocBufferArray(scip, &branchbounds, branchvarssize) );
-   SCIP_CALL( SCIPallocBufferArray(scip, &boundtypes, branchvarssize) );
+   SCIP_CALL( SCIPopttableUpdate(scip, opttable) );
 
-   SCIPnodeGetParentBranchings(node, branchvars, branchbounds, boundtypes, &nbranchvars, branchvarssize);
+   assert(node->domchg != NULL);
+   boundchgs = node->domchg->domchgbound.boundchgs;
+   nboundchgs = (int)node->domchg->domchgbound.nboundchgs;
 
-   /* if the arrays were to small, we have to reallocate them and recall SCIPnodeGetParentBranchings */
-   if( nbranchvars > branchvarssize )
+   /* check optimality; the branching bound changes come first (see SCIPnodeGetParentBranchings()) */
+   for( i = 0; i < nboundchgs && boundchgs[i].boundchgtype == SCIP_BOUNDCHGTYPE_BRANCHING; ++i )
    {
-      branchvarssize = nbranchvars;
+      SCIP_Real optval = SCIPopttableGetVal(scip, opttable, boundchgs[i].var);
+      SCIP_Real bound = boundchgs[i].newbound;
 
-      /* memory reallocation */
-      SCIP_CALL( SCIPreallocBufferArray(scip, &branchvars, branchvarssize) );
-      SCIP_CALL( SCIPreallocBufferArray(scip, &branchbounds, branchvarssize) );
-      SCIP_CALL( SCIPreallocBufferArray(scip, &boundtypes, branchvarssize) );
-
-      SCIPnodeGetParentBranchings(node, branchvars, branchbounds, boundtypes, &nbranchvars, branchvarssize);
-      assert(nbranchvars == branchvarssize);
-   }
-
-   /* check optimality */
-   assert(nbranchvars >= 1);
-   for( i = 0; i < nbranchvars; ++i)
-   {
-      SCIP_Real optval = SCIPgetSolVal(scip, optsol, branchvars[i]);
-      if( (boundtypes[i] == SCIP_BOUNDTYPE_LOWER && optval < branchbounds[i]) ||
-          (boundtypes[i] == SCIP_BOUNDTYPE_UPPER && optval > branchbounds[i]) )
-      {
-         isoptimal = FALSE;
-         break;
-      }
+      if( (boundchgs[i].boundtype == SCIP_BOUNDTYPE_LOWER && optval < bound) ||
+          (boundchgs[i].boundtype == SCIP_BOUNDTYPE_UPPER && optval > bound) )
+         return SCIP_OKAY;
    }
+   assert(i >= 1);
 
-   /* free all local memory */
-   SCIPfreeBufferArray(scip, &branchvars);
-   SCIPfreeBufferArray(scip, &boundtypes);
-   SCIPfreeBufferArray(scip, &branchbounds);
-
-   if( isoptimal )
-      SCIPnodeSetOptimal(node);
+   SCIPnodeSetOptimal(node);
 
    return SCIP_OKAY;
 }
@@ -173,9 +178,12 @@ SCIP_RETCODE SCIPreadOptSol(
    )
 {
    SCIP_FILE* file;
+   SCIP_VAR** origvars;
    SCIP_Bool error;
    SCIP_Bool unknownvariablemessage;
    SCIP_Bool usevartable;
+   int norigvars;
+   int nextvar;
    int lineno;
 
    assert(scip != NULL);
@@ -202,6 +210,13 @@ SCIP_RETCODE SCIPreadOptSol(
    SCIP_CALL( SCIPcreateSolSelf(scip, sol, NULL) );
    assert(SCIPsolIsOriginal(*sol) == TRUE);
 
+   /* solution files list the variables in problem order, so the next line usually names the original variable after
+    * the one just read; only names out of this order are looked up in the variable hash table
+    */
+   origvars = SCIPgetOrigVars(scip);
+   norigvars = SCIPgetNOrigVars(scip);
+   nextvar = 0;
+
    /* read the file */
    error = FALSE;
    unknownvariablemessage = FALSE;
@@ -238,7 +253,12 @@ SCIP_RETCODE SCIPreadOptSol(
       }
 
       /* find the variable */
-      var = SCIPfindVar(scip, varname);
+      if( nextvar < norigvars && strcmp(SCIPvarGetName(origvars[nextvar]), varname) == 0 )
+         var = origvars[nextvar];
+      else
+         var = SCIPfindVar(scip, varname);
+      if( var != NULL && SCIPvarIsOriginal(var) && SCIPvarGetProbindex(var) >= 0 )
+         nextvar = SCIPvarGetProbindex(var) + 1;
       if( var == NULL )
       {
          if( !unknownvariablemessage )
@@ -343,20 +363,37 @@ SCIP_DECL_NODESELINIT(nodeselInitOracle)
    nodeseldata->optsol = NULL;
    SCIP_CALL( SCIPreadOptSol(scip, nodeseldata->solfname, &nodeseldata->optsol) );
    assert(nodeseldata->optsol != NULL);
-#ifdef SCIP_DEBUG
+   SCIP_CALL( SCIPopttableCreate(scip, &nodeseldata->opttable, nodeseldata->optsol) );
+   /* the log parsers expect the optimal solution before the solutions found */
    SCIP_CALL( SCIPprintSol(scip, nodeseldata->optsol, NULL, FALSE) );
-#endif
 
+   nodeseldata->trjsink = NULL;
    nodeseldata->trjfile = NULL;
-   if( nodeseldata->trjfname != NULL )
+   if( nodeseldata->trjfname != NULL && nodeseldata->trjfname[0] != '\0' )
    {
-      char wfname[SCIP_MAXSTRLEN];
-      strcpy(wfname, nodeseldata->trjfname);
-      strcat(wfname, ".weight");
-      nodeseldata->wfile = fopen(wfname, "a");
-      nodeseldata->trjfile = fopen(nodeseldata->trjfname, "a");
+      SCIP_CALL( SCIPtrjsinkCreate(scip, &nodeseldata->trjsink, nodeseldata->trjfname, SCIP_FEATNODESEL_SIZE,
+            nodeseldata->trjdedup, nodeseldata->trjaio) );
+      SCIP_CALL( SCIPtrjsinkSetSampling(scip, nodeseldata->trjsink, nodeseldata->trjmaxposgroups,
+            nodeseldata->trjmaxneggroups, nodeseldata->trjnegrate, (unsigned int)nodeseldata->trjseed) );
+      nodeseldata->trjfile = nodeseldata->trjsink->file;
    }
 
+   nodeseldata->evtlog = NULL;
+   if( nodeseldata->evtfname != NULL && nodeseldata->evtfname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPevtlogCreate(scip, &nodeseldata->evtlog, nodeseldata->evtfname) );
+   }
+
+   nodeseldata->sampler = NULL;
+   if( nodeseldata->samplefname != NULL && nodeseldata->samplefname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPtreesamplerCreate(scip, &nodeseldata->sampler, nodeseldata->samplefname, nodeseldata->samplefreq,
+            nodeseldata->sampleinterval) );
+   }
+
+   SCIP_CALL( SCIPtraceCreate(scip, &nodeseldata->trace, "nodesel."NODESEL_NAME, nodeseldata->tracelevel,
+         nodeseldata->traceringsize) );
+
    /* create feat */
    nodeseldata->feat = NULL;
    SCIP_CALL( SCIPfeatCreate(scip, &nodeseldata->feat, SCIP_FEATNODESEL_SIZE) );
@@ -404,17 +441,32 @@ SCIP_DECL_NODESELEXIT(nodeselExitOracle)
    nodeseldata = SCIPnodeselGetData(nodesel);
 
    assert(nodeseldata->optsol != NULL);
+   SCIPopttableFree(scip, &nodeseldata->opttable);
    SCIP_CALL( SCIPfreeSolSelf(scip, &nodeseldata->optsol) );
    nodeseldata->optsol = NULL;
 
-   if( nodeseldata->trjfile != NULL)
+   if( nodeseldata->trjsink != NULL)
    {
-      fclose(nodeseldata->wfile);
-      fclose(nodeseldata->trjfile);
-      nodeseldata->wfile = NULL;
+      SCIP_CALL( SCIPtrjsinkFree(scip, &nodeseldata->trjsink) );
       nodeseldata->trjfile = NULL;
    }
 
+   if( nodeseldata->evtlog != NULL )
+   {
+      SCIP_CALL( SCIPevtlogFree(scip, &nodeseldata->evtlog) );
+   }
+
+   if( nodeseldata->sampler != NULL )
+   {
+      SCIP_CALL( SCIPtreesamplerFree(scip, &nodeseldata->sampler) );
+   }
+
+   if( nodeseldata->tracefname != NULL && nodeseldata->tracefname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPtraceDumpFile(nodeseldata->trace, nodeseldata->tracefname) );
+   }
+   SCIP_CALL( SCIPtraceFree(scip, &nodeseldata->trace) );
+
    if( nodeseldata->feat != NULL )
    {
       SCIP_CALL( SCIPfeatFree(scip, &nodeseldata->feat) );
@@ -469,6 +521,7 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
    SCIP_NODE** leaves;
    SCIP_NODE** children;
    SCIP_NODE** siblings;
+   SCIP_Longint selectstart;
    int nleaves;
    int nsiblings;
    int nchildren;
@@ -486,6 +539,13 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
    nodeseldata = SCIPnodeselGetData(nodesel);
    assert(nodeseldata != NULL);
 
+   selectstart = SCIPchrometraceIsOn() ? SCIPprofileStart() : 0;
+
+   if( nodeseldata->sampler != NULL )
+   {
+      SCIP_CALL( SCIPtreesamplerSelect(scip, nodeseldata->sampler) );
+   }
+
    /* collect leaves, children and siblings data */
    SCIP_CALL( SCIPgetOpenNodesData(scip, &leaves, &children, &siblings, &nleaves, &nchildren, &nsiblings) );
 
@@ -498,7 +558,7 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
        */
       if( ! SCIPnodeIsOptchecked(children[i]) )
       {
-         SCIPnodeCheckOptimal(scip, children[i], nodeseldata->optsol);
+         SCIP_CALL( SCIPnodeCheckOptimal(scip, children[i], nodeseldata->opttable) );
          SCIPnodeSetOptchecked(children[i]);
       }
       
@@ -510,6 +570,9 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
 #endif
          optchild = i;
       }
+
+      SCIPtraceRecord(nodeseldata->trace, SCIP_TRACEEVT_NODE, SCIPnodeGetNumber(children[i]), SCIPnodeIsOptimal(children[i]),
+         SCIPnodeGetLowerbound(children[i]), 0.0, (SCIP_Real)SCIPnodeGetDepth(children[i]), 0.0);
    }
 
    /* write examples - origin */
@@ -529,20 +592,20 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
                {
                   SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
                   nodeseldata->negate ^= 1;
-                  SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
+                  SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
                }
             }
             for( i = 0; i < nsiblings; i++ )
             {
                SCIPcalcNodeselFeat(scip, siblings[i], nodeseldata->feat);
                nodeseldata->negate ^= 1;
-               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
+               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
             }
             for( i = 0; i < nleaves; i++ )
             {
                SCIPcalcNodeselFeat(scip, leaves[i], nodeseldata->feat);
                nodeseldata->negate ^= 1;
-               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
+               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
             }
          }
          else
@@ -553,7 +616,7 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
             {
                SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
                nodeseldata->negate ^= 1;
-               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, -1, nodeseldata->negate);
+               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, -1, nodeseldata->negate);
             }
          }
       }
@@ -561,28 +624,34 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
    else if (TRUE)
    {
       /* single feat */
-      if( nodeseldata->trjfile != NULL && nchildren + nsiblings + nleaves > 1)
+      if( nodeseldata->trjsink != NULL && nchildren + nsiblings + nleaves > 1)
       {
          SCIPdebugMessage("node selection single feature\n");
          nodeseldata->cur_group_idx += 1;
+         SCIPtrjsinkBeginGroup(nodeseldata->trjsink, nodeseldata->cur_group_idx);
 
          for( i = 0; i < nchildren; i++)
          {
             SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
-            SCIPfeatSingleNNPrint(scip, nodeseldata->trjfile, nodeseldata->feat, SCIPnodeGetNumber(children[i]), nodeseldata->cur_group_idx);
+            SCIP_CALL( SCIPtrjsinkAddNode(scip, nodeseldata->trjsink, nodeseldata->feat, (int)SCIPnodeGetNumber(children[i]),
+                  SCIPnodeIsOptimal(children[i])) );
          }
          for( i = 0; i < nsiblings; i++ )
          {
             SCIPcalcNodeselFeat(scip, siblings[i], nodeseldata->feat);
-            SCIPfeatSingleNNPrint(scip, nodeseldata->trjfile, nodeseldata->feat, SCIPnodeGetNumber(siblings[i]), nodeseldata->cur_group_idx);
-            // SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
+            SCIP_CALL( SCIPtrjsinkAddNode(scip, nodeseldata->trjsink, nodeseldata->feat, (int)SCIPnodeGetNumber(siblings[i]),
+                  SCIPnodeIsOptimal(siblings[i])) );
+            // SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
          }
          for( i = 0; i < nleaves; i++ )
          {
             SCIPcalcNodeselFeat(scip, leaves[i], nodeseldata->feat);
-            SCIPfeatSingleNNPrint(scip, nodeseldata->trjfile, nodeseldata->feat, SCIPnodeGetNumber(leaves[i]), nodeseldata->cur_group_idx);
-            // SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
+            SCIP_CALL( SCIPtrjsinkAddNode(scip, nodeseldata->trjsink, nodeseldata->feat, (int)SCIPnodeGetNumber(leaves[i]),
+                  SCIPnodeIsOptimal(leaves[i])) );
+            // SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
          }
+
+         SCIP_CALL( SCIPtrjsinkEndGroup(scip, nodeseldata->trjsink) );
       }
    }
    else
@@ -612,23 +681,23 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
                {
                   SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
                   nodeseldata->negate ^= 1;
-                  SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
-                  // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, 1, nodeseldata->negate);
+                  SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
+                  // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, 1, nodeseldata->negate);
                }
             }
             for( i = 0; i < nsiblings; i++ )
             {
                SCIPcalcNodeselFeat(scip, siblings[i], nodeseldata->feat);
                nodeseldata->negate ^= 1;
-               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
-               // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, 1, nodeseldata->negate);
+               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
+               // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, 1, nodeseldata->negate);
             }
             for( i = 0; i < nleaves; i++ )
             {
                SCIPcalcNodeselFeat(scip, leaves[i], nodeseldata->feat);
                nodeseldata->negate ^= 1;
-               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
-               // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, 1, nodeseldata->negate);
+               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 1, nodeseldata->negate);
+               // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, 1, nodeseldata->negate);
             }
          }
          else
@@ -639,8 +708,8 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
             {
                SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
                nodeseldata->negate ^= 1;
-               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, 11, nodeseldata->negate);
-               // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, 1, nodeseldata->negate);
+               SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, 11, nodeseldata->negate);
+               // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, 1, nodeseldata->negate);
             }
          }
       }
@@ -652,16 +721,36 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
          {
             SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
             nodeseldata->negate ^= 1;
-            SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, -1, nodeseldata->negate);
-            // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->wfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, -1, nodeseldata->negate);
+            SCIPfeatDiffNNPrint(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, -1, nodeseldata->negate);
+            // SCIPfeatDiffNNPrintConcat(scip, nodeseldata->trjfile, nodeseldata->optfeat, nodeseldata->feat, nodeseldata->left_feat, nodeseldata->right_feat, -1, nodeseldata->negate);
          }
       }
    }
 
    *selnode = SCIPgetBestNode(scip);
-   
-   /* experiment start: ml-HeFeatures */
-   if (TRUE)
+
+   if( SCIPlivestatIsDue() )
+   {
+      SCIPlivestatPublishNodesel(NODESEL_NAME, NULL,
+         nodeseldata->trjsink != NULL ? SCIPtrjsinkGetNBytes(nodeseldata->trjsink) : -1);
+   }
+
+   if( *selnode != NULL )
+   {
+      SCIPtraceRecord(nodeseldata->trace, SCIP_TRACEEVT_SELECT, SCIPnodeGetNumber(*selnode), nchildren + nsiblings + nleaves,
+         SCIPnodeGetLowerbound(*selnode), SCIPgetPrimalbound(scip), SCIPgetDualbound(scip), SCIPnodeGetScore(*selnode));
+   }
+
+   if( nodeseldata->evtlog != NULL )
+   {
+      SCIP_CALL( SCIPevtlogSelect(scip, nodeseldata->evtlog, *selnode, nchildren + nsiblings + nleaves,
+            *selnode != NULL && SCIPnodeIsOptimal(*selnode)) );
+   }
+
+   /* text log of the selection, written from trace level 1 unless there is an event log; the final solutions are
+    * always printed
+    */
+   if( (nodeseldata->evtlog == NULL && SCIPtraceIsOn(nodeseldata->trace, SCIP_TRACELEVEL_SELECT)) || *selnode == NULL )
    {
       int idx = -1;
       int isopt = -1;
@@ -687,8 +776,10 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
 
       if (*selnode != NULL)
       {
-         SCIPprintNodeRootPath(scip, *selnode, NULL);        
          idx = SCIPnodeGetNumber(*selnode);
+
+         /* without an event log, the branching path of a selection is only in the text log */
+         SCIPprintNodeRootPath(scip, *selnode, NULL);
         
          if (SCIPnodeIsOptimal(*selnode))
             isopt = 1;
@@ -696,7 +787,7 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
          depth = SCIPnodeGetDepth(*selnode);
          lowerbound = SCIPnodeGetLowerbound(*selnode);
          
-         SCIPdebugMessage("final selecting node number %d primalbound %.3f lowerbound %.3f dualbound %.3f time %.2f depth %d left %d bPB_time %.2f opt %d nsols %d ", 
+         SCIPtraceMessage("final selecting node number %d primalbound %.3f lowerbound %.3f dualbound %.3f time %.2f depth %d left %d bPB_time %.2f opt %d nsols %d ", 
                                                    idx, primalbound, lowerbound, dualbound, current_time, depth, left, bPB_time, isopt, nsols);
 
          SCIPinfoMessage(scip, NULL, "total_time %.2f", total_time);
@@ -719,6 +810,9 @@ SCIP_DECL_NODESELSELECT(nodeselSelectOracle)
    }
    /* experiment end */
 
+   if( SCIPchrometraceIsOn() )
+      SCIPchrometraceSpan("select", selectstart, SCIPprofileStart());
+
    return SCIP_OKAY;
 }
 
@@ -894,6 +988,63 @@ SCIP_RETCODE SCIPincludeNodeselOracle(
          "nodeselection/"NODESEL_NAME"/trjfname",
          "name of the file to write node selection trajectories",
          &nodeseldata->trjfname, TRUE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodeselection/"NODESEL_NAME"/trjdedup",
+         "should each node's feature row be written only when it appears or changes (groups list node numbers)?",
+         &nodeseldata->trjdedup, TRUE, DEFAULT_TRJDEDUP, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/trjmaxposgroups",
+         "maximal number of groups containing an optimal node kept per instance, sampled by reservoir (0: no limit)",
+         &nodeseldata->trjmaxposgroups, TRUE, DEFAULT_TRJMAXPOSGROUPS, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/trjmaxneggroups",
+         "maximal number of pure-negative groups kept per instance, sampled by reservoir (0: no limit)",
+         &nodeseldata->trjmaxneggroups, TRUE, DEFAULT_TRJMAXNEGGROUPS, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/trjnegrate",
+         "rate at which pure-negative groups are kept",
+         &nodeseldata->trjnegrate, TRUE, DEFAULT_TRJNEGRATE, 0.0, 1.0, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/trjseed",
+         "random seed of the trajectory sampler",
+         &nodeseldata->trjseed, TRUE, DEFAULT_TRJSEED, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodeselection/"NODESEL_NAME"/trjaio",
+         "should the trajectory be written asynchronously (io_uring on Linux, pwrite otherwise)?",
+         &nodeseldata->trjaio, TRUE, DEFAULT_TRJAIO, NULL, NULL) );
+   nodeseldata->evtfname = NULL;
+   nodeseldata->samplefname = NULL;
+   nodeseldata->sampler = NULL;
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/evtfname",
+         "name of the file to write the binary solve-event log (empty: text log only)",
+         &nodeseldata->evtfname, TRUE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/samplefname",
+         "name of the file to write open-node queue samples to (empty: no sampling)",
+         &nodeseldata->samplefname, TRUE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/samplefreq",
+         "sample the open nodes every this many selections (0: never by count)",
+         &nodeseldata->samplefreq, TRUE, DEFAULT_SAMPLEFREQ, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/sampleinterval",
+         "sample the open nodes every this many seconds of wall clock time (0: never by time)",
+         &nodeseldata->sampleinterval, TRUE, DEFAULT_SAMPLEINTERVAL, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   nodeseldata->trace = NULL;
+   nodeseldata->tracefname = NULL;
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/tracelevel",
+         "trace level of the text log (0: final solutions only, 1: one line per selection, 2: also per node)",
+         &nodeseldata->tracelevel, TRUE, DEFAULT_TRACELEVEL, 0, 2, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/traceringsize",
+         "number of recent events kept in memory and dumped at exit or after an error (0: none)",
+         &nodeseldata->traceringsize, TRUE, DEFAULT_TRACERINGSIZE, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/tracefname",
+         "name of the file to dump the recent events to at exit (empty: dumped only after an error)",
+         &nodeseldata->tracefname, TRUE, DEFAULT_FILENAME, NULL, NULL) );
 
    return SCIP_OKAY;
 }
@@ -64,6 +64,7 @@
 
 #include "scip/scip.h"
 #include "feat.h"
+#include "opttable.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -88,7 +89,7 @@ EXTERN
 SCIP_RETCODE SCIPnodeCheckOptimal(
    SCIP*                 scip,               /**< SCIP data structure */
    SCIP_NODE*            node,               /**< the node in question */
-   SCIP_SOL*             optsol              /**< node selector data */
+   SCIP_OPTTABLE*        opttable            /**< optimal values */
    );
 
 #ifdef __cplusplus
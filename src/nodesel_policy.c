@@ -1,4 +1,3 @@
-#define SCIP_DEBUG
 /**@file   nodesel_policy.c
  * @brief  node selector using a learned policy 
  * @author He He 
@@ -11,6 +10,7 @@
 /*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
 #include <assert.h>
 #include <string.h>
+#include <stdint.h>
 #include "nodesel_policy.h"
 #include "nodesel_oracle.h"
 #include "feat.h"
@@ -18,13 +18,25 @@
 #include "struct_policy.h"
 #include "scip/sol.h"
 #include "scip/tree.h"
+#include "scip/nodepq.h"
+#include "scip/struct_tree.h"
 #include "scip/struct_set.h"
+#include "scip/struct_mem.h"
 #include "scip/struct_scip.h"
 
 #include "time.h"
 #include "scip/prob.h"
 #include "scip/type_sol.h"
 #include "scip/struct_sol.h"
+#include "evtlog.h"
+#include "treesampler.h"
+#include "livestat.h"
+#include "profile.h"
+#include "hist.h"
+#include "trace.h"
+#include "perfcnt.h"
+#include "chrometrace.h"
+#include "memacct.h"
 
 #define NODESEL_NAME            "policy"
 #define NODESEL_DESC            "node selector which selects node according to a policy"
@@ -32,6 +44,37 @@
 #define NODESEL_MEMSAVEPRIORITY 0
 
 #define DEFAULT_FILENAME        ""
+#define DEFAULT_TRACELEVEL      0        /**< trace level of the text log (0: final solutions, 1: selections, 2: nodes) */
+#define DEFAULT_TRACERINGSIZE   1024     /**< number of recent events kept for dumps at exit or after errors */
+#define DEFAULT_SAMPLEFREQ      100      /**< sample the open nodes every this many selections (0: never by count) */
+#define DEFAULT_SAMPLEINTERVAL  1.0      /**< sample the open nodes every this many seconds (0: never by time) */
+#define DEFAULT_PERFCOUNTERS    FALSE    /**< count hardware events around the select callback? */
+#define DEFAULT_HYBRID          FALSE    /**< score children with the model only while the search state asks for it? */
+#define DEFAULT_HYBRIDMINNODES  0LL      /**< consult the model from this node count on */
+#define DEFAULT_HYBRIDMAXNODES  -1LL     /**< consult the model up to this node count (-1: no limit) */
+#define DEFAULT_HYBRIDMINDEPTH  0        /**< consult the model for children at this depth or deeper */
+#define DEFAULT_HYBRIDMAXDEPTH  -1       /**< consult the model for children up to this depth (-1: no limit) */
+#define DEFAULT_HYBRIDMINGAP    0.0      /**< consult the model while the gap is at least this large */
+#define DEFAULT_HYBRIDMAXOPEN   -1       /**< consult the model while at most this many nodes are open (-1: no limit) */
+#define DEFAULT_GATE            FALSE    /**< score only children whose lower bound is close to the best open node? */
+#define DEFAULT_GATEBAND        0.1      /**< gate: largest relative bound of a child that is scored by the model */
+#define DEFAULT_RERANK          FALSE    /**< rescore leaves after the incumbent changed? */
+#define DEFAULT_RERANKK         0        /**< rescore only this many leaves with the smallest lower bound (0: all) */
+#define DEFAULT_RERANKMAXNODES  -1LL     /**< total number of leaf rescorings in the solve (-1: no limit) */
+#define DEFAULT_RERANKMAXTIME   -1.0     /**< total seconds spent rescoring leaves in the solve (-1: no limit) */
+#define DEFAULT_ASYNC           FALSE    /**< score children in the background while the next node is solved? */
+#define DEFAULT_ASYNCMAXPENDING 16       /**< number of background requests in flight before the oldest is waited for */
+#define DEFAULT_EVICTMAXOPEN    -1       /**< evict leaves while more nodes than this are open (-1: no limit) */
+#define DEFAULT_EVICTMAXMEM     -1.0     /**< evict leaves while SCIP uses more than this many MB (-1: no limit) */
+#define DEFAULT_EVICTRATIO      0.9      /**< evict down to this fraction of the limit */
+#define DEFAULT_EVICTSAFETY     0.0      /**< keep leaves within this relative distance of the dual bound (-1: off) */
+#define DEFAULT_TOPM            0        /**< rank this many leaves with the smallest lower bound at each select (0: off) */
+#define MAXTOPM                 (64 * SCIP_POLICY_MAXBATCH) /**< largest value of the topm parameter */
+#define DEFAULT_TOPMSCAN        4096     /**< leaves looked at in the first stage of a top-M select (-1: all) */
+
+#define ORDERKEY_SCOREBITS      46       /**< bits of the quantized score in an order key */
+#define ORDERKEY_DEPTHBITS      16       /**< bits of the depth in an order key */
+#define GATEDSCORE              -1e+09   /**< gated children score in [GATEDSCORE-1, GATEDSCORE), below the model */
 
 /*
  * Data structures
@@ -43,6 +86,65 @@ struct SCIP_NodeselData
    char*              polfname;           /**< name of the solution file */
    SCIP_POLICY*       policy;
    SCIP_FEAT*         feat;
+   char*              evtfname;           /**< name of the binary event log file */
+   SCIP_EVTLOG*       evtlog;             /**< binary event log, or NULL */
+   char*              samplefname;        /**< name of the open-node sample file */
+   SCIP_TREESAMPLER*  sampler;            /**< open-node sampler, or NULL */
+   int                samplefreq;         /**< sample every this many selections */
+   SCIP_Real          sampleinterval;     /**< sample every this many seconds */
+   char*              statsfname;         /**< name of the file to append the phase statistics to */
+   SCIP_PROFILE       profile;            /**< per-phase timing */
+   SCIP_HIST          selecthist;         /**< latency of the select callback */
+   SCIP_Bool          perfcounters;       /**< count hardware events around the select callback? */
+   SCIP_PERFCNT       perfcnt;            /**< hardware event counts per region */
+   SCIP_TRACE*        trace;              /**< runtime trace */
+   int                tracelevel;         /**< trace level of the text log */
+   int                traceringsize;      /**< number of recent events kept in the trace ring buffer */
+   char*              tracefname;         /**< name of the file to dump the trace ring buffer to at exit */
+   uint64_t*          orderkeys;          /**< order key of each scored node, indexed by node number (0: none) */
+   int                orderkeyssize;      /**< size of orderkeys */
+   SCIP_Bool          hybrid;             /**< score children with the model only while the search state asks for it? */
+   SCIP_Longint       hybridminnodes;     /**< consult the model from this node count on */
+   SCIP_Longint       hybridmaxnodes;     /**< consult the model up to this node count (-1: no limit) */
+   int                hybridmindepth;     /**< consult the model for children at this depth or deeper */
+   int                hybridmaxdepth;     /**< consult the model for children up to this depth (-1: no limit) */
+   SCIP_Real          hybridmingap;       /**< consult the model while the gap is at least this large */
+   int                hybridmaxopen;      /**< consult the model while at most this many nodes are open (-1: no limit) */
+   SCIP_Longint       nmodelcalls;        /**< number of children scored by the model */
+   SCIP_Longint       nfallbacks;         /**< number of children ordered without the model */
+   SCIP_Bool          gate;               /**< score only children whose lower bound is close to the best open node? */
+   SCIP_Real          gateband;           /**< gate: largest relative bound of a child that is scored by the model */
+   SCIP_Longint       ngated;             /**< number of children given a surrogate score */
+   SCIP_Bool          rerank;             /**< rescore leaves after the incumbent changed? */
+   int                rerankk;            /**< rescore only this many leaves with the smallest lower bound (0: all) */
+   SCIP_Longint       rerankmaxnodes;     /**< total number of leaf rescorings in the solve (-1: no limit) */
+   SCIP_Real          rerankmaxtime;      /**< total seconds spent rescoring leaves in the solve (-1: no limit) */
+   SCIP_Real*         featrows;           /**< features of each model-scored node, indexed by node number (rerank, topm) */
+   int                featrowssize;       /**< number of rows in featrows */
+   SCIP_Longint       lastnbestsols;      /**< number of best solutions found at the last rerank */
+   SCIP_Longint       nreranks;           /**< number of reranks */
+   SCIP_Longint       nrescored;          /**< number of rescored leaves */
+   SCIP_Longint       reranktime;         /**< time spent reranking in nanoseconds */
+   SCIP_Bool          async;              /**< score children in the background while the next node is solved? */
+   int                asyncmaxpending;    /**< number of background requests in flight before the oldest is waited for */
+   SCIP_Longint*      asyncnumbers;       /**< node numbers of the requests in flight, SCIP_POLICY_MAXBATCH per request */
+   int*               asyncnnodes;        /**< number of nodes of the requests in flight, indexed by sequence number */
+   SCIP_Longint       nasyncsent;         /**< number of children scored in the background */
+   SCIP_Longint       nasyncapplied;      /**< number of background scores applied to open nodes */
+   SCIP_Longint       nasyncstale;        /**< number of background scores of nodes that were no longer open */
+   int                evictmaxopen;       /**< evict leaves while more nodes than this are open (-1: no limit) */
+   SCIP_Real          evictmaxmem;        /**< evict leaves while SCIP uses more than this many MB (-1: no limit) */
+   SCIP_Real          evictratio;         /**< evict down to this fraction of the limit */
+   SCIP_Real          evictsafety;        /**< keep leaves within this relative distance of the dual bound (-1: off) */
+   SCIP_Longint       nevictions;         /**< number of eviction rounds */
+   SCIP_Longint       nevicted;           /**< number of evicted leaves */
+   SCIP_Real          evictedbound;       /**< smallest lower bound of an evicted leaf (SCIP_INVALID: none) */
+   SCIP_Longint       lastevictmem;       /**< memory used after the last round over the memory limit (0: none) */
+   int                topm;               /**< rank this many leaves with the smallest lower bound at each select (0: off) */
+   SCIP_Longint       ntopmscored;        /**< number of leaves ranked by the model in the second stage */
+   SCIP_Longint       ntopmleaves;        /**< number of selections of a leaf ranked in the second stage */
+   int                topmscan;           /**< leaves looked at in the first stage of a top-M select (-1: all) */
+   int                topmscanpos;        /**< position in the leaf queue where the next first stage starts */
 };
 
 void SCIPnodeselpolicyPrintStatistics(
@@ -51,13 +153,72 @@ void SCIPnodeselpolicyPrintStatistics(
    FILE*                 file
    )
 {
+   SCIP_NODESELDATA* nodeseldata;
+
    assert(scip != NULL);
    assert(nodesel != NULL);
 
+   nodeseldata = SCIPnodeselGetData(nodesel);
+   assert(nodeseldata != NULL);
+
    SCIPmessageFPrintInfo(scip->messagehdlr, file, 
          "Node selector      :\n");
    SCIPmessageFPrintInfo(scip->messagehdlr, file, 
          "  selection time   : %10.2f\n", SCIPnodeselGetTime(nodesel));
+   SCIPprofilePrint(scip, &nodeseldata->profile, file);
+   SCIPhistPrintHeader(scip, file);
+   SCIPhistPrint(scip, &nodeseldata->selecthist, "select", file);
+   if( nodeseldata->policy != NULL )
+      SCIPhistPrint(scip, &nodeseldata->policy->modelhist, "model", file);
+   SCIPperfcntPrint(scip, &nodeseldata->perfcnt, file);
+   if( nodeseldata->hybrid )
+   {
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  model calls      : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nmodelcalls);
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  model fallbacks  : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nfallbacks);
+   }
+   if( nodeseldata->gate )
+   {
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  model gated      : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->ngated);
+   }
+   if( nodeseldata->rerank )
+   {
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  reranks          : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nreranks);
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  rescored leaves  : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nrescored);
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  rerank time      : %10.2f\n", nodeseldata->reranktime / 1e9);
+   }
+   if( nodeseldata->async )
+   {
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  async requests   : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nasyncsent);
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  async applied    : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nasyncapplied);
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  async stale      : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nasyncstale);
+   }
+   if( nodeseldata->topm > 0 )
+   {
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  top-M ranked     : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->ntopmscored);
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  top-M leaf picks : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->ntopmleaves);
+   }
+   if( nodeseldata->evictmaxopen >= 0 || nodeseldata->evictmaxmem >= 0.0 )
+   {
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  evictions        : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nevictions);
+      SCIPmessageFPrintInfo(scip->messagehdlr, file,
+            "  evicted leaves   : %10"SCIP_LONGINT_FORMAT"\n", nodeseldata->nevicted);
+      /* the dual bound of the solve is only valid up to the best evicted leaf */
+      if( nodeseldata->evictedbound != SCIP_INVALID ) /*lint !e777*/
+         SCIPmessageFPrintInfo(scip->messagehdlr, file,
+               "  evicted bound    : %10.4e (not exact)\n", SCIPretransformObj(scip, nodeseldata->evictedbound));
+   }
 }
 
 /** solving process initialization method of node selector (called when branch and bound process is about to begin) */
@@ -83,7 +244,64 @@ SCIP_DECL_NODESELINIT(nodeselInitPolicy)
    // SCIP_CALL( SCIPhgfeatCreate(scip, &nodeseldata->feat, SCIP_FEATNODESEL_SIZE) );
    assert(nodeseldata->feat != NULL);
    SCIPfeatSetMaxDepth(nodeseldata->feat, SCIPgetNBinVars(scip) + SCIPgetNIntVars(scip));
-  
+
+   nodeseldata->evtlog = NULL;
+   if( nodeseldata->evtfname != NULL && nodeseldata->evtfname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPevtlogCreate(scip, &nodeseldata->evtlog, nodeseldata->evtfname) );
+   }
+
+   nodeseldata->sampler = NULL;
+   if( nodeseldata->samplefname != NULL && nodeseldata->samplefname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPtreesamplerCreate(scip, &nodeseldata->sampler, nodeseldata->samplefname, nodeseldata->samplefreq,
+            nodeseldata->sampleinterval) );
+   }
+
+   SCIPprofileReset(&nodeseldata->profile);
+   SCIPhistReset(&nodeseldata->selecthist);
+   if( nodeseldata->perfcounters )
+   {
+      SCIP_CALL( SCIPperfcntOpen(scip, &nodeseldata->perfcnt) );
+   }
+
+   SCIP_CALL( SCIPtraceCreate(scip, &nodeseldata->trace, "nodesel."NODESEL_NAME, nodeseldata->tracelevel,
+         nodeseldata->traceringsize) );
+
+   nodeseldata->orderkeys = NULL;
+   nodeseldata->orderkeyssize = 0;
+   nodeseldata->nmodelcalls = 0;
+   nodeseldata->nfallbacks = 0;
+   nodeseldata->ngated = 0;
+   nodeseldata->featrows = NULL;
+   nodeseldata->featrowssize = 0;
+   nodeseldata->lastnbestsols = 0;
+   nodeseldata->nreranks = 0;
+   nodeseldata->nrescored = 0;
+   nodeseldata->reranktime = 0;
+
+   nodeseldata->nevictions = 0;
+   nodeseldata->nevicted = 0;
+   nodeseldata->evictedbound = SCIP_INVALID;
+   nodeseldata->lastevictmem = 0;
+   nodeseldata->ntopmscored = 0;
+   nodeseldata->ntopmleaves = 0;
+   nodeseldata->topmscanpos = 0;
+
+   nodeseldata->asyncnumbers = NULL;
+   nodeseldata->asyncnnodes = NULL;
+   nodeseldata->nasyncsent = 0;
+   nodeseldata->nasyncapplied = 0;
+   nodeseldata->nasyncstale = 0;
+   if( nodeseldata->async )
+   {
+      SCIP_CALL( SCIPallocMemoryArray(scip, &nodeseldata->asyncnumbers,
+            nodeseldata->asyncmaxpending * SCIP_POLICY_MAXBATCH) );
+      SCIP_CALL( SCIPallocMemoryArray(scip, &nodeseldata->asyncnnodes, nodeseldata->asyncmaxpending) );
+      SCIPmemacctAlloc(SCIP_MEMCOMP_MODEL, (size_t)nodeseldata->asyncmaxpending
+         * (SCIP_POLICY_MAXBATCH * sizeof(SCIP_Longint) + sizeof(int)));
+   }
+
    return SCIP_OKAY;
 }
 
@@ -97,12 +315,60 @@ SCIP_DECL_NODESELEXIT(nodeselExitPolicy)
 
    nodeseldata = SCIPnodeselGetData(nodesel);
 
+   if( nodeseldata->statsfname != NULL && nodeseldata->statsfname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPprofileWrite(scip, &nodeseldata->profile, nodeseldata->statsfname, "nodesel."NODESEL_NAME) );
+      SCIP_CALL( SCIPhistWrite(scip, &nodeseldata->selecthist, nodeseldata->statsfname, "nodesel."NODESEL_NAME,
+            "select") );
+      SCIP_CALL( SCIPhistWrite(scip, &nodeseldata->policy->modelhist, nodeseldata->statsfname,
+            "nodesel."NODESEL_NAME, "model") );
+      SCIP_CALL( SCIPperfcntWrite(scip, &nodeseldata->perfcnt, nodeseldata->statsfname, "nodesel."NODESEL_NAME) );
+      SCIP_CALL( SCIPmemacctWrite(scip, nodeseldata->statsfname, "nodesel."NODESEL_NAME) );
+   }
+   SCIPperfcntClose(&nodeseldata->perfcnt);
+
    assert(nodeseldata->feat != NULL);
    SCIP_CALL( SCIPfeatFree(scip, &nodeseldata->feat) );
 
+   /* replies still in flight are read and dropped when the policy is freed */
    assert(nodeseldata->policy != NULL);
    SCIP_CALL( SCIPpolicyFree(scip, &nodeseldata->policy) );
-   
+
+   if( nodeseldata->asyncnumbers != NULL )
+   {
+      SCIPmemacctFree(SCIP_MEMCOMP_MODEL, (size_t)nodeseldata->asyncmaxpending
+         * (SCIP_POLICY_MAXBATCH * sizeof(SCIP_Longint) + sizeof(int)));
+      SCIPfreeMemoryArray(scip, &nodeseldata->asyncnnodes);
+      SCIPfreeMemoryArray(scip, &nodeseldata->asyncnumbers);
+   }
+
+   if( nodeseldata->evtlog != NULL )
+   {
+      SCIP_CALL( SCIPevtlogFree(scip, &nodeseldata->evtlog) );
+   }
+
+   if( nodeseldata->sampler != NULL )
+   {
+      SCIP_CALL( SCIPtreesamplerFree(scip, &nodeseldata->sampler) );
+   }
+
+   if( nodeseldata->tracefname != NULL && nodeseldata->tracefname[0] != '\0' )
+   {
+      SCIP_CALL( SCIPtraceDumpFile(nodeseldata->trace, nodeseldata->tracefname) );
+   }
+   SCIP_CALL( SCIPtraceFree(scip, &nodeseldata->trace) );
+
+   if( nodeseldata->orderkeys != NULL )
+      SCIPmemacctFree(SCIP_MEMCOMP_NODEDATA, (size_t)nodeseldata->orderkeyssize * sizeof(uint64_t));
+   BMSfreeMemoryArrayNull(&nodeseldata->orderkeys);
+   nodeseldata->orderkeyssize = 0;
+
+   if( nodeseldata->featrows != NULL )
+      SCIPmemacctFree(SCIP_MEMCOMP_NODEDATA,
+         (size_t)nodeseldata->featrowssize * SCIP_FEATNODESEL_SIZE * sizeof(SCIP_Real));
+   BMSfreeMemoryArrayNull(&nodeseldata->featrows);
+   nodeseldata->featrowssize = 0;
+
    return SCIP_OKAY;
 }
 
@@ -122,12 +388,889 @@ SCIP_DECL_NODESELFREE(nodeselFreePolicy)
    return SCIP_OKAY;
 }
 
+/** order key of a scored node; a smaller key means a better node, 0 means no key
+ *
+ * The score is quantized to multiples of epsilon; higher scores get smaller keys. Below it, greater depths get smaller
+ * keys. Ties in the key are broken by lower bound in the comparator. The top bit is always set so that 0 can mark
+ * nodes without a key. The next bit marks the tier of gated children, whose score part is taken relative to
+ * GATEDSCORE, so they come after every other node and in the order of their relative bound.
+ *
+ * Unlike SCIPisGT(), which calls scores within epsilon equal, the quantization orders two such scores by score when
+ * they fall on either side of a bucket boundary, so the keys then do not fall back to the depth. A score outside the
+ * range of the key part gets no key and is compared by compNodes() instead of being clamped.
+ */
+static
+uint64_t calcOrderKey(
+   SCIP*              scip,
+   SCIP_NODE*         node
+   )
+{
+   const SCIP_Real maxq = (SCIP_Real)(((int64_t)1 << (ORDERKEY_SCOREBITS - 1)) - 1);
+   SCIP_Real score;
+   SCIP_Real q;
+   SCIP_Bool gated;
+   uint64_t scorepart;
+   uint64_t depthpart;
+   int depth;
+
+   score = SCIPnodeGetScore(node);
+   gated = score < GATEDSCORE;
+   q = floor((gated ? score - GATEDSCORE : score) / SCIPepsilon(scip) + 0.5);
+   if( REALABS(q) > maxq )
+      return 0;
+   scorepart = (uint64_t)(int64_t)(maxq - q);
+
+   depth = MIN(SCIPnodeGetDepth(node), (1 << ORDERKEY_DEPTHBITS) - 1);
+   depthpart = (uint64_t)((1 << ORDERKEY_DEPTHBITS) - 1 - depth);
+
+   return ((uint64_t)1 << 63) | ((uint64_t)gated << 62) | (scorepart << ORDERKEY_DEPTHBITS) | depthpart;
+}
+
+/** store the order key of a node that has just been scored */
+static
+SCIP_RETCODE setOrderKey(
+   SCIP*              scip,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE*         node
+   )
+{
+   SCIP_Longint number = SCIPnodeGetNumber(node);
+
+   if( number >= nodeseldata->orderkeyssize )
+   {
+      int newsize;
+
+      /* over the soft cap the key array is not grown; nodes beyond it are compared field by field */
+      if( SCIPmemacctIsOverCap() || number >= INT_MAX )
+      {
+         SCIPmemacctShed(SCIP_MEMCOMP_NODEDATA);
+         return SCIP_OKAY;
+      }
+
+      newsize = SCIPcalcMemGrowSize(scip, (int)number + 1);
+      SCIP_ALLOC( BMSreallocMemoryArray(&nodeseldata->orderkeys, newsize) );
+      SCIPmemacctRealloc(SCIP_MEMCOMP_NODEDATA, (size_t)nodeseldata->orderkeyssize * sizeof(uint64_t),
+         (size_t)newsize * sizeof(uint64_t));
+      BMSclearMemoryArray(&nodeseldata->orderkeys[nodeseldata->orderkeyssize], newsize - nodeseldata->orderkeyssize);
+      nodeseldata->orderkeyssize = newsize;
+   }
+
+   nodeseldata->orderkeys[number] = calcOrderKey(scip, node);
+
+   return SCIP_OKAY;
+}
+
+/** keep the features of a node that has just been scored, so that it can be rescored after the incumbent changed */
+static
+SCIP_RETCODE storeFeatRow(
+   SCIP*              scip,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE*         node
+   )
+{
+   SCIP_Longint number = SCIPnodeGetNumber(node);
+
+   assert(SCIPfeatGetSize(nodeseldata->feat) == SCIP_FEATNODESEL_SIZE);
+
+   if( number >= nodeseldata->featrowssize )
+   {
+      int newsize;
+
+      /* over the soft cap the rows are not grown; nodes beyond them keep their score */
+      if( SCIPmemacctIsOverCap() || number >= INT_MAX / SCIP_FEATNODESEL_SIZE )
+      {
+         SCIPmemacctShed(SCIP_MEMCOMP_NODEDATA);
+         return SCIP_OKAY;
+      }
+
+      newsize = SCIPcalcMemGrowSize(scip, (int)number + 1);
+      SCIP_ALLOC( BMSreallocMemoryArray(&nodeseldata->featrows, newsize * SCIP_FEATNODESEL_SIZE) );
+      SCIPmemacctRealloc(SCIP_MEMCOMP_NODEDATA,
+         (size_t)nodeseldata->featrowssize * SCIP_FEATNODESEL_SIZE * sizeof(SCIP_Real),
+         (size_t)newsize * SCIP_FEATNODESEL_SIZE * sizeof(SCIP_Real));
+      BMSclearMemoryArray(&nodeseldata->featrows[nodeseldata->featrowssize * SCIP_FEATNODESEL_SIZE],
+         (newsize - nodeseldata->featrowssize) * SCIP_FEATNODESEL_SIZE);
+      nodeseldata->featrowssize = newsize;
+   }
+
+   BMScopyMemoryArray(&nodeseldata->featrows[number * SCIP_FEATNODESEL_SIZE], SCIPfeatGetVals(nodeseldata->feat),
+      SCIP_FEATNODESEL_SIZE);
+
+   return SCIP_OKAY;
+}
+
+/** features of a node stored by storeFeatRow(), or NULL */
+static
+SCIP_Real* getFeatRow(
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE*         node
+   )
+{
+   SCIP_Longint number = SCIPnodeGetNumber(node);
+   SCIP_Real* row;
+
+   if( number >= nodeseldata->featrowssize )
+      return NULL;
+
+   /* every calculated row has exactly one of the bound type indicators set; rows never stored are zero */
+   row = &nodeseldata->featrows[number * SCIP_FEATNODESEL_SIZE];
+   if( row[SCIP_FEATNODESEL_BOUNDTYPE_LOWER] == 0.0 && row[SCIP_FEATNODESEL_BOUNDTYPE_UPPER] == 0.0 )
+      return NULL;
+
+   return row;
+}
+
+/** sorts leaves by increasing lower bound */
+static
+SCIP_DECL_SORTPTRCOMP(leafCompLowerbound)
+{
+   SCIP_Real lowerbound1 = SCIPnodeGetLowerbound((SCIP_NODE*)elem1);
+   SCIP_Real lowerbound2 = SCIPnodeGetLowerbound((SCIP_NODE*)elem2);
+
+   if( lowerbound1 < lowerbound2 )
+      return -1;
+   else if( lowerbound1 > lowerbound2 )
+      return +1;
+   else
+      return 0;
+}
+
+/** rebuild the leaf queue after scores of leaves changed, as SCIP does when the node selector changes */
+static
+SCIP_RETCODE resortLeaves(
+   SCIP*              scip,
+   SCIP_NODESEL*      nodesel
+   )
+{
+   SCIP_NODEPQ* leaves;
+   SCIP_NODE** nodes;
+   int nnodes;
+   int i;
+
+   nodes = SCIPnodepqNodes(scip->tree->leaves);
+   nnodes = SCIPnodepqLen(scip->tree->leaves);
+
+   SCIP_CALL( SCIPnodepqCreate(&leaves, scip->set, nodesel) );
+   for( i = 0; i < nnodes; i++ )
+   {
+      SCIP_CALL( SCIPnodepqInsert(leaves, scip->set, nodes[i]) );
+   }
+   SCIPnodepqDestroy(&scip->tree->leaves);
+   scip->tree->leaves = leaves;
+
+   return SCIP_OKAY;
+}
+
+/** rescore the leaves after the incumbent changed
+ *
+ * The gap, global upper bound and relative bound features of the stored rows are recomputed for the new bounds and
+ * the leaves are scored in batches; the others, which depend on the LP of the node's parent, are kept. Leaves
+ * without a stored row (created in the hybrid fallback or beyond the soft cap) keep their score.
+ */
+static
+SCIP_RETCODE rerankLeaves(
+   SCIP*              scip,
+   SCIP_NODESEL*      nodesel,
+   SCIP_NODESELDATA*  nodeseldata
+   )
+{
+   SCIP_Real savedvals[SCIP_FEATNODESEL_SIZE];
+   SCIP_NODE** leaves;
+   SCIP_NODE** cands;
+   SCIP_Real* batchvals;
+   SCIP_Real* featvals;
+   SCIP_Longint start;
+   SCIP_Longint maxtime;
+   SCIP_Longint nbestsols;
+   int nleaves;
+   int ncands;
+   int first;
+   int n;
+   int i;
+
+   nbestsols = SCIPgetNBestSolsFound(scip);
+   if( nbestsols == nodeseldata->lastnbestsols )
+      return SCIP_OKAY;
+   nodeseldata->lastnbestsols = nbestsols;
+
+   maxtime = nodeseldata->rerankmaxtime < 0.0 ? SCIP_LONGINT_MAX : (SCIP_Longint)(nodeseldata->rerankmaxtime * 1e9);
+   if( nodeseldata->reranktime >= maxtime
+      || (nodeseldata->rerankmaxnodes >= 0 && nodeseldata->nrescored >= nodeseldata->rerankmaxnodes) )
+      return SCIP_OKAY;
+
+   SCIP_CALL( SCIPgetLeaves(scip, &leaves, &nleaves) );
+   if( nleaves == 0 )
+      return SCIP_OKAY;
+
+   start = SCIPprofileStart();
+
+   SCIP_CALL( SCIPallocBufferArray(scip, &cands, nleaves) );
+   ncands = 0;
+   for( i = 0; i < nleaves; i++ )
+   {
+      if( getFeatRow(nodeseldata, leaves[i]) != NULL )
+         cands[ncands++] = leaves[i];
+   }
+
+   if( nodeseldata->rerankk > 0 && ncands > nodeseldata->rerankk )
+   {
+      SCIPsortPtr((void**)cands, leafCompLowerbound, ncands);
+      ncands = nodeseldata->rerankk;
+   }
+   if( nodeseldata->rerankmaxnodes >= 0 )
+      ncands = (int)MIN(ncands, nodeseldata->rerankmaxnodes - nodeseldata->nrescored);
+
+   SCIP_CALL( SCIPallocBufferArray(scip, &batchvals, SCIP_POLICY_MAXBATCH * SCIP_FEATNODESEL_SIZE) );
+
+   /* the feature buffer is used for the update; keep what the next child would start from */
+   featvals = SCIPfeatGetVals(nodeseldata->feat);
+   BMScopyMemoryArray(savedvals, featvals, SCIP_FEATNODESEL_SIZE);
+
+   for( first = 0; first < ncands && SCIPprofileStart() - start + nodeseldata->reranktime < maxtime; first += n )
+   {
+      n = MIN(ncands - first, SCIP_POLICY_MAXBATCH);
+
+      for( i = 0; i < n; i++ )
+      {
+         SCIP_Real* row = getFeatRow(nodeseldata, cands[first + i]);
+
+         BMScopyMemoryArray(featvals, row, SCIP_FEATNODESEL_SIZE);
+         SCIPupdateNodeselFeatBounds(scip, cands[first + i], nodeseldata->feat);
+         BMScopyMemoryArray(row, featvals, SCIP_FEATNODESEL_SIZE);
+         BMScopyMemoryArray(&batchvals[i * SCIP_FEATNODESEL_SIZE], featvals, SCIP_FEATNODESEL_SIZE);
+      }
+
+      SCIP_CALL( SCIPcalcNNNodeScoreBatch(&cands[first], batchvals, n, SCIP_FEATNODESEL_SIZE, nodeseldata->policy) );
+
+      for( i = 0; i < n; i++ )
+      {
+         SCIP_CALL( setOrderKey(scip, nodeseldata, cands[first + i]) );
+      }
+      nodeseldata->nrescored += n;
+   }
+
+   BMScopyMemoryArray(featvals, savedvals, SCIP_FEATNODESEL_SIZE);
+
+   SCIPfreeBufferArray(scip, &batchvals);
+   SCIPfreeBufferArray(scip, &cands);
+
+   if( first > 0 )
+   {
+      SCIP_CALL( resortLeaves(scip, nodesel) );
+      nodeseldata->nreranks++;
+   }
+
+   nodeseldata->reranktime += SCIPprofileStart() - start;
+   SCIPchrometraceSpan("rerank", start, SCIPprofileStart());
+
+   return SCIP_OKAY;
+}
+
+/** set the background scores of the given nodes that are among the replied nodes; numbers must be sorted */
+static
+SCIP_RETCODE applyAsyncScores(
+   SCIP*              scip,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE**        nodes,
+   int                nnodes,
+   SCIP_Longint*      numbers,
+   SCIP_Real*         scores,
+   int                nreplied,
+   int*               napplied
+   )
+{
+   int pos;
+   int i;
+
+   *napplied = 0;
+   for( i = 0; i < nnodes; i++ )
+   {
+      if( !SCIPsortedvecFindLong(numbers, SCIPnodeGetNumber(nodes[i]), nreplied, &pos) )
+         continue;
+
+      SCIPnodeSetScore(nodes[i], scores[pos]);
+      SCIP_CALL( setOrderKey(scip, nodeseldata, nodes[i]) );
+      (*napplied)++;
+   }
+
+   return SCIP_OKAY;
+}
+
+/** read the replies to background requests and apply their scores to the nodes that are still open
+ *
+ * The nodes of a request are the children of one select. By the next select they are usually the siblings of the new
+ * focus node, so the siblings are searched first; the leaves are only searched, and resorted, if some replied nodes
+ * were not among them. The node chosen at that select is usually the focus node now; its score is of no use any more
+ * and it is dropped before the search. Other nodes that were solved or pruned in the meantime are counted as stale. If
+ * wait is TRUE, the oldest reply is waited for.
+ */
+static
+SCIP_RETCODE collectAsyncScores(
+   SCIP*              scip,
+   SCIP_NODESEL*      nodesel,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_Bool          wait
+   )
+{
+   SCIP_POLICY* policy = nodeseldata->policy;
+   SCIP_Longint* numbers;
+   SCIP_Real* scores;
+   SCIP_NODE** nodes;
+   SCIP_NODE* focusnode;
+   int nnodes;
+   int nreplied;
+   int napplied;
+   int nleafapplied;
+   int nscores;
+   int seq;
+   int slot;
+
+   if( policy->nasyncreceived == policy->nasyncsent )
+      return SCIP_OKAY;
+
+   SCIP_CALL( SCIPallocBufferArray(scip, &numbers, (policy->nasyncsent - policy->nasyncreceived) * SCIP_POLICY_MAXBATCH) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &scores, (policy->nasyncsent - policy->nasyncreceived) * SCIP_POLICY_MAXBATCH) );
+
+   nreplied = 0;
+   while( policy->nasyncreceived < policy->nasyncsent )
+   {
+      slot = policy->nasyncreceived % nodeseldata->asyncmaxpending;
+      SCIP_CALL( SCIPreceiveNNNodeScores(&scores[nreplied], nodeseldata->asyncnnodes[slot], wait, policy, &seq,
+            &nscores) );
+      if( nscores < 0 )
+         break;
+      assert(seq % nodeseldata->asyncmaxpending == slot);
+
+      BMScopyMemoryArray(&numbers[nreplied], &nodeseldata->asyncnumbers[slot * SCIP_POLICY_MAXBATCH], nscores);
+      nreplied += nscores;
+      wait = FALSE;
+   }
+
+   /* the focus node is neither a sibling nor a leaf, so it would always send the search to the leaves */
+   focusnode = SCIPgetFocusNode(scip);
+   if( focusnode != NULL )
+   {
+      SCIP_Longint focusnumber = SCIPnodeGetNumber(focusnode);
+      int i;
+
+      for( i = 0; i < nreplied; i++ )
+      {
+         if( numbers[i] == focusnumber )
+         {
+            numbers[i] = numbers[nreplied - 1];
+            scores[i] = scores[nreplied - 1];
+            nreplied--;
+            break;
+         }
+      }
+   }
+
+   if( nreplied > 0 )
+   {
+      SCIPsortLongReal(numbers, scores, nreplied);
+
+      SCIP_CALL( SCIPgetSiblings(scip, &nodes, &nnodes) );
+      SCIP_CALL( applyAsyncScores(scip, nodeseldata, nodes, nnodes, numbers, scores, nreplied, &napplied) );
+      if( napplied < nreplied )
+      {
+         SCIP_CALL( SCIPgetLeaves(scip, &nodes, &nnodes) );
+         SCIP_CALL( applyAsyncScores(scip, nodeseldata, nodes, nnodes, numbers, scores, nreplied, &nleafapplied) );
+         if( nleafapplied > 0 )
+         {
+            SCIP_CALL( resortLeaves(scip, nodesel) );
+         }
+         napplied += nleafapplied;
+      }
+
+      nodeseldata->nasyncapplied += napplied;
+      nodeseldata->nasyncstale += nreplied - napplied;
+   }
+
+   SCIPfreeBufferArray(scip, &scores);
+   SCIPfreeBufferArray(scip, &numbers);
+
+   return SCIP_OKAY;
+}
+
+/** send the features of children to the model without waiting; their scores are applied at a later select */
+static
+SCIP_RETCODE requestAsyncScores(
+   SCIP*              scip,
+   SCIP_NODESEL*      nodesel,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE**        nodes,
+   SCIP_Real*         featvals,
+   int                nnodes
+   )
+{
+   SCIP_POLICY* policy = nodeseldata->policy;
+   int first;
+   int seq;
+   int slot;
+   int n;
+   int i;
+
+   for( first = 0; first < nnodes; first += n )
+   {
+      n = MIN(nnodes - first, SCIP_POLICY_MAXBATCH);
+
+      /* bound the requests in flight; if the server falls behind, this waits for it */
+      if( policy->nasyncsent - policy->nasyncreceived >= nodeseldata->asyncmaxpending )
+      {
+         SCIP_CALL( collectAsyncScores(scip, nodesel, nodeseldata, TRUE) );
+      }
+
+      SCIP_CALL( SCIPrequestNNNodeScores(&featvals[first * SCIP_FEATNODESEL_SIZE], n, SCIP_FEATNODESEL_SIZE, policy,
+            &seq) );
+
+      slot = seq % nodeseldata->asyncmaxpending;
+      nodeseldata->asyncnnodes[slot] = n;
+      for( i = 0; i < n; i++ )
+         nodeseldata->asyncnumbers[slot * SCIP_POLICY_MAXBATCH + i] = SCIPnodeGetNumber(nodes[first + i]);
+      nodeseldata->nasyncsent += n;
+   }
+
+   return SCIP_OKAY;
+}
+
+/** evict the lowest-scored leaves while the open nodes exceed the configured count or memory limit
+ *
+ * Evicted leaves are freed like leaves beyond the cutoff bound, so the solve is no longer exact; the smallest lower
+ * bound among them is kept for the statistics. Leaves within evictsafety (relative) of the global lower bound are
+ * never evicted. Over the open-node limit a round evicts down to evictratio of the limit. Over the memory limit a
+ * round evicts 1-evictratio of the leaves, and the next one only follows once the memory has grown by 1-evictratio of
+ * the limit since, so that a memory use that stays above the limit for other reasons does not empty the queue.
+ */
+static
+SCIP_RETCODE evictLeaves(
+   SCIP*              scip,
+   SCIP_NODESEL*      nodesel,
+   SCIP_NODESELDATA*  nodeseldata,
+   int                nopen
+   )
+{
+   SCIP_NODEPQ* leaves;
+   SCIP_NODE** nodes;
+   SCIP_NODE** cands;
+   SCIP_NODE** safe;
+   SCIP_Real* scores;
+   SCIP_Real lowerbound;
+   SCIP_Real safebound;
+   SCIP_Longint start;
+   SCIP_Longint memused;
+   SCIP_Longint memlimit;
+   SCIP_Bool overmem;
+   int nevict;
+   int nleaves;
+   int ncands;
+   int nsafe;
+   int i;
+
+   nevict = 0;
+   if( nodeseldata->evictmaxopen >= 0 && nopen > nodeseldata->evictmaxopen )
+      nevict = nopen - (int)(nodeseldata->evictratio * nodeseldata->evictmaxopen);
+   overmem = FALSE;
+   if( nodeseldata->evictmaxmem >= 0.0 )
+   {
+      memused = SCIPgetMemUsed(scip);
+      memlimit = (SCIP_Longint)(nodeseldata->evictmaxmem * 1024.0 * 1024.0);
+      if( memused <= memlimit )
+         nodeseldata->lastevictmem = 0;
+      else if( nodeseldata->lastevictmem == 0
+         || memused > nodeseldata->lastevictmem + (SCIP_Longint)((1.0 - nodeseldata->evictratio) * memlimit) )
+      {
+         nevict = MAX(nevict, (int)ceil((1.0 - nodeseldata->evictratio) * SCIPnodepqLen(scip->tree->leaves)));
+         overmem = TRUE;
+      }
+   }
+   if( nevict <= 0 )
+      return SCIP_OKAY;
+
+   start = SCIPprofileStart();
+
+   nodes = SCIPnodepqNodes(scip->tree->leaves);
+   nleaves = SCIPnodepqLen(scip->tree->leaves);
+
+   lowerbound = SCIPgetLowerbound(scip);
+   if( nodeseldata->evictsafety < 0.0 )
+      safebound = -SCIPinfinity(scip);
+   else
+      safebound = lowerbound + nodeseldata->evictsafety * MAX(REALABS(lowerbound), 1.0);
+
+   SCIP_CALL( SCIPallocBufferArray(scip, &cands, nleaves) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &safe, nleaves) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &scores, nleaves) );
+   ncands = 0;
+   nsafe = 0;
+   for( i = 0; i < nleaves; i++ )
+   {
+      if( SCIPisLE(scip, SCIPnodeGetLowerbound(nodes[i]), safebound) )
+      {
+         safe[nsafe++] = nodes[i];
+         continue;
+      }
+      cands[ncands] = nodes[i];
+      scores[ncands] = SCIPnodeGetScore(nodes[i]);
+      ncands++;
+   }
+   nevict = MIN(nevict, ncands);
+
+   if( nevict > 0 )
+   {
+      /* lowest scores first; the leaves that are kept go into a new queue, the evicted ones are freed after it */
+      SCIPsortRealPtr(scores, (void**)cands, ncands);
+
+      SCIP_CALL( SCIPnodepqCreate(&leaves, scip->set, nodesel) );
+      for( i = 0; i < nsafe; i++ )
+      {
+         SCIP_CALL( SCIPnodepqInsert(leaves, scip->set, safe[i]) );
+      }
+      for( i = nevict; i < ncands; i++ )
+      {
+         SCIP_CALL( SCIPnodepqInsert(leaves, scip->set, cands[i]) );
+      }
+      SCIPnodepqDestroy(&scip->tree->leaves);
+      scip->tree->leaves = leaves;
+
+      for( i = 0; i < nevict; i++ )
+      {
+         if( nodeseldata->evictedbound == SCIP_INVALID /*lint !e777*/
+            || SCIPnodeGetLowerbound(cands[i]) < nodeseldata->evictedbound )
+            nodeseldata->evictedbound = SCIPnodeGetLowerbound(cands[i]);
+         SCIP_CALL( SCIPnodeFree(&cands[i], scip->mem->probmem, scip->set, scip->stat, scip->eventqueue, scip->tree,
+               scip->lp) );
+      }
+
+      if( nodeseldata->nevictions == 0 )
+      {
+         SCIPverbMessage(scip, SCIP_VERBLEVEL_NORMAL, NULL,
+            "node selector <%s> evicts open nodes, the dual bound is only valid up to the evicted bound\n",
+            NODESEL_NAME);
+      }
+      nodeseldata->nevictions++;
+      nodeseldata->nevicted += nevict;
+   }
+
+   /* also when nothing could be evicted, so that an unevictable queue is not scanned again at every select */
+   if( overmem )
+      nodeseldata->lastevictmem = SCIPgetMemUsed(scip);
+
+   SCIPfreeBufferArray(scip, &scores);
+   SCIPfreeBufferArray(scip, &safe);
+   SCIPfreeBufferArray(scip, &cands);
+
+   SCIPchrometraceSpan("evict", start, SCIPprofileStart());
+
+   return SCIP_OKAY;
+}
+
+/** is leaf 1 worse than leaf 2 in the first stage of the two-stage selection (larger lower bound, then estimate)? */
+static
+SCIP_Bool topmWorse(
+   SCIP_NODE*         node1,
+   SCIP_NODE*         node2
+   )
+{
+   SCIP_Real lowerbound1 = SCIPnodeGetLowerbound(node1);
+   SCIP_Real lowerbound2 = SCIPnodeGetLowerbound(node2);
+
+   if( lowerbound1 != lowerbound2 ) /*lint !e777*/
+      return lowerbound1 > lowerbound2;
+
+   return SCIPnodeGetEstimate(node1) > SCIPnodeGetEstimate(node2);
+}
+
+/** offer a leaf to the heap of the best size leaves; the heap root is the worst of them */
+static
+void topmOffer(
+   SCIP_NODE**        heap,
+   int*               nheap,
+   int                size,
+   SCIP_NODE*         node
+   )
+{
+   int child;
+   int i;
+
+   if( *nheap < size )
+   {
+      for( i = (*nheap)++; i > 0 && topmWorse(node, heap[(i - 1) / 2]); i = (i - 1) / 2 )
+         heap[i] = heap[(i - 1) / 2];
+      heap[i] = node;
+      return;
+   }
+
+   if( !topmWorse(heap[0], node) )
+      return;
+
+   /* replace the root and sift down */
+   for( i = 0; (child = 2 * i + 1) < size; i = child )
+   {
+      if( child + 1 < size && topmWorse(heap[child + 1], heap[child]) )
+         child++;
+      if( !topmWorse(heap[child], node) )
+         break;
+      heap[i] = heap[child];
+   }
+   heap[i] = node;
+}
+
+/** two-stage selection: the children and the topm leaves with the smallest lower bound are ranked by the model
+ *
+ * The first stage keeps the leaves in a heap of size topm. It looks at the best-bound leaf given by
+ * SCIPgetBestboundNode() and at a window of at most topmscan leaves, which moves on through the leaf queue from one
+ * select to the next. With more leaves than topmscan, the other preselected leaves are the best of the window, not of
+ * the whole queue. A select thus costs O(topmscan log topm) comparisons and one batch of at most topm plus the number
+ * of children rows, however many leaves are open; with topmscan = -1 every leaf is looked at, and the comparisons
+ * grow with the queue.
+ *
+ * Leaves are ranked from their stored features with the bound features updated, as in rerankLeaves(). Their new
+ * scores only decide this selection and are not written to the nodes, since the leaf queue is ordered by score. The
+ * stored rows are left unchanged too, so they stay the rows the node scores came from. Leaves without stored features
+ * and the siblings compete with the score they have. The children get their scores and order keys here; children that
+ * were gated or sent to the model in the background are not candidates until a later select.
+ */
+static
+SCIP_RETCODE selectTopM(
+   SCIP*              scip,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE**        children,
+   SCIP_Real*         childvals,
+   int                nchildren,
+   SCIP_NODE**        selnode
+   )
+{
+   SCIP_Real savedvals[SCIP_FEATNODESEL_SIZE];
+   SCIP_NODE** leaves;
+   SCIP_NODE** siblings;
+   SCIP_NODE** heap;
+   SCIP_NODE* boundnode;
+   SCIP_NODE** nodes;
+   SCIP_Real* vals;
+   SCIP_Real* scores;
+   SCIP_Real* featvals;
+   SCIP_Real* row;
+   SCIP_Real bestscore;
+   SCIP_Longint start;
+   int nleaves;
+   int nsiblings;
+   int heapsize;
+   int nscan;
+   int first;
+   int nheap;
+   int nnodes;
+   int i;
+
+   SCIP_CALL( SCIPgetLeaves(scip, &leaves, &nleaves) );
+   SCIP_CALL( SCIPgetSiblings(scip, &siblings, &nsiblings) );
+
+   /* first stage: the best-bound leaf, then a window of the leaf queue */
+   nscan = nodeseldata->topmscan < 0 ? nleaves : MIN(nodeseldata->topmscan, nleaves);
+   first = nscan < nleaves ? nodeseldata->topmscanpos % nleaves : 0;
+   heapsize = MIN(nodeseldata->topm, nscan + 1);
+   SCIP_CALL( SCIPallocBufferArray(scip, &heap, MAX(heapsize, 1)) );
+   nheap = 0;
+   boundnode = SCIPgetBestboundNode(scip);
+   if( boundnode != NULL && SCIPnodeGetType(boundnode) == SCIP_NODETYPE_LEAF )
+      topmOffer(heap, &nheap, heapsize, boundnode);
+   else
+      boundnode = NULL;
+   for( i = 0; i < nscan; i++ )
+   {
+      SCIP_NODE* leaf = leaves[(first + i) % nleaves];
+
+      if( leaf != boundnode )
+         topmOffer(heap, &nheap, heapsize, leaf);
+   }
+   nodeseldata->topmscanpos = nleaves > 0 ? (first + nscan) % nleaves : 0;
+
+   /* second stage: the children, then the preselected leaves that have features, in one batch */
+   SCIP_CALL( SCIPallocBufferArray(scip, &nodes, nchildren + nheap) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &vals, (nchildren + nheap) * SCIP_FEATNODESEL_SIZE) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &scores, nchildren + nheap) );
+
+   if( nchildren > 0 )
+   {
+      BMScopyMemoryArray(nodes, children, nchildren);
+      BMScopyMemoryArray(vals, childvals, nchildren * SCIP_FEATNODESEL_SIZE);
+   }
+   nnodes = nchildren;
+
+   featvals = SCIPfeatGetVals(nodeseldata->feat);
+   BMScopyMemoryArray(savedvals, featvals, SCIP_FEATNODESEL_SIZE);
+   for( i = 0; i < nheap; i++ )
+   {
+      row = getFeatRow(nodeseldata, heap[i]);
+      if( row == NULL )
+         continue;
+
+      BMScopyMemoryArray(featvals, row, SCIP_FEATNODESEL_SIZE);
+      SCIPupdateNodeselFeatBounds(scip, heap[i], nodeseldata->feat);
+      BMScopyMemoryArray(&vals[nnodes * SCIP_FEATNODESEL_SIZE], featvals, SCIP_FEATNODESEL_SIZE);
+      nodes[nnodes++] = heap[i];
+   }
+   BMScopyMemoryArray(featvals, savedvals, SCIP_FEATNODESEL_SIZE);
+
+   start = SCIPprofileStart();
+   SCIP_CALL( SCIPcalcNNScores(vals, nnodes, SCIP_FEATNODESEL_SIZE, nodeseldata->policy, scores) );
+   SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_MODEL, start);
+   nodeseldata->ntopmscored += nnodes - nchildren;
+
+   for( i = 0; i < nchildren; i++ )
+   {
+      SCIPnodeSetScore(children[i], scores[i]);
+      SCIP_CALL( setOrderKey(scip, nodeseldata, children[i]) );
+   }
+
+   /* pick the best score; ties go to the children, then the siblings */
+   *selnode = NULL;
+   bestscore = 0.0;
+   for( i = 0; i < nnodes; i++ )
+   {
+      if( *selnode == NULL || scores[i] > bestscore )
+      {
+         *selnode = nodes[i];
+         bestscore = scores[i];
+      }
+   }
+   for( i = 0; i < nsiblings; i++ )
+   {
+      if( *selnode == NULL || SCIPnodeGetScore(siblings[i]) > bestscore )
+      {
+         *selnode = siblings[i];
+         bestscore = SCIPnodeGetScore(siblings[i]);
+      }
+   }
+   for( i = 0; i < nheap; i++ )
+   {
+      if( getFeatRow(nodeseldata, heap[i]) == NULL
+         && (*selnode == NULL || SCIPnodeGetScore(heap[i]) > bestscore) )
+      {
+         *selnode = heap[i];
+         bestscore = SCIPnodeGetScore(heap[i]);
+      }
+   }
+
+   if( *selnode != NULL && SCIPnodeGetType(*selnode) == SCIP_NODETYPE_LEAF )
+      nodeseldata->ntopmleaves++;
+
+   SCIPfreeBufferArray(scip, &scores);
+   SCIPfreeBufferArray(scip, &vals);
+   SCIPfreeBufferArray(scip, &nodes);
+   SCIPfreeBufferArray(scip, &heap);
+
+   return SCIP_OKAY;
+}
+
+/** record a child that has just been scored in the trace */
+static
+void traceChild(
+   SCIP*              scip,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE*         child
+   )
+{
+   SCIPtraceRecord(nodeseldata->trace, SCIP_TRACEEVT_NODE, SCIPnodeGetNumber(child), 0,
+      SCIPnodeGetLowerbound(child), SCIPnodeGetScore(child), (SCIP_Real)SCIPnodeGetDepth(child), 0.0);
+
+   if( SCIPtraceIsOn(nodeseldata->trace, SCIP_TRACELEVEL_NODE) )
+   {
+      SCIP_Real nodelowerbound = SCIPnodeGetLowerbound(child);
+      SCIP_Real primalbound = SCIPgetPrimalbound(scip);
+      SCIP_Real dualbound = SCIPgetDualbound(scip);
+      int idx = (int)SCIPnodeGetNumber(child);
+      SCIP_Real score = SCIPnodeGetScore(child);
+
+      SCIPtraceMessage("checking node %d pb %.3f db %.3f nlb %.3f score %f\n", idx, primalbound, dualbound, nodelowerbound, score);
+   }
+}
+
+/** surrogate score of a child the model need not see, or SCIP_INVALID if it should be scored by the model
+ *
+ * The surrogate is the child's relative bound feature, the position of its lower bound between the global lower and
+ * upper bound. A child beyond the band is dominated by the best open node; it is placed in a fixed tier below the
+ * range of the model's scores, ordered by relative bound among the gated children whatever the model scores later.
+ */
+static
+SCIP_Real calcGatedScore(
+   SCIP_NODESELDATA*  nodeseldata
+   )
+{
+   SCIP_Real relativebound;
+
+   if( !nodeseldata->gate )
+      return SCIP_INVALID;
+
+   relativebound = SCIPfeatGetVals(nodeseldata->feat)[SCIP_FEATNODESEL_RELATIVEBOUND];
+   if( relativebound <= nodeseldata->gateband )
+      return SCIP_INVALID;
+
+   return GATEDSCORE - MIN(relativebound, 1.0);
+}
+
+/** should the children of the focus node be scored by the model?
+ *
+ * Outside the configured window the children inherit the score of their parent. The comparator then prefers them
+ * over the other open nodes of that score by depth and orders them by lower bound, i.e., the search plunges into the
+ * subtree the model last chose. The children of the root are always scored, since the root has no score.
+ */
+static
+SCIP_Bool useModel(
+   SCIP*              scip,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE*         child,
+   int                nopen
+   )
+{
+   SCIP_NODE* parent;
+   SCIP_Longint nnodes;
+   int depth;
+
+   if( !nodeseldata->hybrid )
+      return TRUE;
+
+   parent = SCIPnodeGetParent(child);
+   if( parent == NULL || SCIPnodeGetDepth(parent) == 0 || SCIPnodeGetScore(parent) == 0 )
+      return TRUE;
+
+   nnodes = SCIPgetNNodes(scip);
+   if( nnodes < nodeseldata->hybridminnodes
+      || (nodeseldata->hybridmaxnodes >= 0 && nnodes > nodeseldata->hybridmaxnodes) )
+      return FALSE;
+
+   depth = SCIPnodeGetDepth(child);
+   if( depth < nodeseldata->hybridmindepth
+      || (nodeseldata->hybridmaxdepth >= 0 && depth > nodeseldata->hybridmaxdepth) )
+      return FALSE;
+
+   if( nodeseldata->hybridmaxopen >= 0 && nopen > nodeseldata->hybridmaxopen )
+      return FALSE;
+
+   return SCIPgetGap(scip) >= nodeseldata->hybridmingap;
+}
+
 /** node selection method of node selector */
 static
 SCIP_DECL_NODESELSELECT(nodeselSelectPolicy)
 {
    SCIP_NODESELDATA* nodeseldata;
    SCIP_NODE** children;
+   SCIP_NODE** asyncchildren;
+   SCIP_Real* asyncvals;
+   SCIP_NODE** topmchildren;
+   SCIP_Real* topmvals;
+   SCIP_Longint selectstart;
+   SCIP_Longint selectend;
+   SCIP_PERFSNAP selectsnap;
+   SCIP_PERFSNAP snap;
+   SCIP_Longint start;
+   SCIP_Bool traceselect;
+   SCIP_Bool usemodel;
+   SCIP_Real gatedscore;
+   SCIP_Bool async;
+   SCIP_Bool topm;
+   int nasync;
+   int ntopm;
    int nchildren;
    int nleaves;
    int nsiblings;
@@ -141,33 +1284,175 @@ SCIP_DECL_NODESELSELECT(nodeselSelectPolicy)
    nodeseldata = SCIPnodeselGetData(nodesel);
    assert(nodeseldata != NULL);
 
+   selectstart = SCIPprofileStart();
+   SCIPperfcntStart(&nodeseldata->perfcnt, &selectsnap);
+
+   if( nodeseldata->sampler != NULL )
+   {
+      SCIP_CALL( SCIPtreesamplerSelect(scip, nodeseldata->sampler) );
+   }
+
+   if( nodeseldata->async )
+   {
+      SCIP_CALL( collectAsyncScores(scip, nodesel, nodeseldata, FALSE) );
+   }
+
+   if( nodeseldata->rerank )
+   {
+      SCIP_CALL( rerankLeaves(scip, nodesel, nodeseldata) );
+   }
+
    /* collect leaves, children and siblings data */
    // SCIP_CALL( SCIPgetChildren(scip, &children, &nchildren) );
    SCIP_CALL( SCIPgetOpenNodesData(scip, NULL, &children, NULL, &nleaves, &nchildren, &nsiblings) );
 
+   /* all children share the parent, depth and search state */
+   usemodel = nchildren == 0 || useModel(scip, nodeseldata, children[0], nchildren + nsiblings + nleaves);
+
+   /* in the background, children inherit the score of their parent until the model's reply is applied; the children
+    * of the root are scored right away, since the root has no score
+    */
+   async = nodeseldata->async && usemodel && nchildren > 0 && SCIPnodeGetDepth(children[0]) > 1
+      && SCIPnodeGetScore(SCIPnodeGetParent(children[0])) != 0;
+   nasync = 0;
+   asyncchildren = NULL;
+   asyncvals = NULL;
+   if( async )
+   {
+      SCIP_CALL( SCIPallocBufferArray(scip, &asyncchildren, nchildren) );
+      SCIP_CALL( SCIPallocBufferArray(scip, &asyncvals, nchildren * SCIP_FEATNODESEL_SIZE) );
+   }
+
+   /* in the two-stage selection, the children are scored in one batch with the preselected leaves */
+   topm = nodeseldata->topm > 0 && usemodel;
+   ntopm = 0;
+   topmchildren = NULL;
+   topmvals = NULL;
+   if( topm )
+   {
+      SCIP_CALL( SCIPallocBufferArray(scip, &topmchildren, MAX(nchildren, 1)) );
+      SCIP_CALL( SCIPallocBufferArray(scip, &topmvals, MAX(nchildren, 1) * SCIP_FEATNODESEL_SIZE) );
+   }
+
    /* check newly created nodes */
    for( i = 0; i < nchildren; i++)
    {
-      /* compute score */
-      SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
-      SCIPcalcNNNodeScore(children[i], nodeseldata->feat, nodeseldata->policy);
-
-      if (TRUE)
+      if( usemodel )
       {
-         SCIP_Real nodelowerbound = SCIPnodeGetLowerbound(children[i]);
-         SCIP_Real primalbound = SCIPgetPrimalbound(scip);
-         SCIP_Real dualbound = SCIPgetDualbound(scip);
-         int idx = (int)SCIPnodeGetNumber(children[i]);
-         SCIP_Real score = SCIPnodeGetScore(children[i]);
+         /* compute score */
+         start = SCIPprofileStart();
+         SCIPperfcntStart(&nodeseldata->perfcnt, &snap);
+         SCIPcalcNodeselFeat(scip, children[i], nodeseldata->feat);
+         SCIPperfcntStop(&nodeseldata->perfcnt, SCIP_PERFREGION_FEAT, &snap);
+         SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_FEAT, start);
+         if( nodeseldata->rerank || nodeseldata->topm > 0 )
+         {
+            SCIP_CALL( storeFeatRow(scip, nodeseldata, children[i]) );
+         }
 
-         SCIPdebugMessage("checking node %d pb %.3f db %.3f nlb %.3f score %f\n", idx, primalbound, dualbound, nodelowerbound, score);
+         gatedscore = calcGatedScore(nodeseldata);
+         if( gatedscore != SCIP_INVALID ) /*lint !e777*/
+         {
+            SCIPnodeSetScore(children[i], gatedscore);
+            nodeseldata->ngated++;
+         }
+         else if( async )
+         {
+            BMScopyMemoryArray(&asyncvals[nasync * SCIP_FEATNODESEL_SIZE], SCIPfeatGetVals(nodeseldata->feat),
+               SCIP_FEATNODESEL_SIZE);
+            asyncchildren[nasync++] = children[i];
+            SCIPnodeSetScore(children[i], SCIPnodeGetScore(SCIPnodeGetParent(children[i])));
+            nodeseldata->nmodelcalls++;
+         }
+         else if( topm )
+         {
+            BMScopyMemoryArray(&topmvals[ntopm * SCIP_FEATNODESEL_SIZE], SCIPfeatGetVals(nodeseldata->feat),
+               SCIP_FEATNODESEL_SIZE);
+            topmchildren[ntopm++] = children[i];
+            nodeseldata->nmodelcalls++;
+
+            /* scored, keyed and traced with the leaves below */
+            continue;
+         }
+         else
+         {
+            start = SCIPprofileStart();
+            SCIPperfcntStart(&nodeseldata->perfcnt, &snap);
+            SCIPcalcNNNodeScore(children[i], nodeseldata->feat, nodeseldata->policy);
+            SCIPperfcntStop(&nodeseldata->perfcnt, SCIP_PERFREGION_MODEL, &snap);
+            SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_MODEL, start);
+            nodeseldata->nmodelcalls++;
+         }
+      }
+      else
+      {
+         SCIPnodeSetScore(children[i], SCIPnodeGetScore(SCIPnodeGetParent(children[i])));
+         nodeseldata->nfallbacks++;
       }
+      SCIP_CALL( setOrderKey(scip, nodeseldata, children[i]) );
+
+      traceChild(scip, nodeseldata, children[i]);
+   }
+
+   if( async )
+   {
+      start = SCIPprofileStart();
+      SCIP_CALL( requestAsyncScores(scip, nodesel, nodeseldata, asyncchildren, asyncvals, nasync) );
+      SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_MODEL, start);
+      SCIPfreeBufferArray(scip, &asyncvals);
+      SCIPfreeBufferArray(scip, &asyncchildren);
+   }
+
+   if( nodeseldata->evictmaxopen >= 0 || nodeseldata->evictmaxmem >= 0.0 )
+   {
+      SCIP_CALL( evictLeaves(scip, nodesel, nodeseldata, nchildren + nsiblings + nleaves) );
+
+      /* the open node count in the logs below is taken after the eviction */
+      nleaves = SCIPgetNLeaves(scip);
+   }
+
+   if( topm )
+   {
+      SCIP_CALL( selectTopM(scip, nodeseldata, topmchildren, topmvals, ntopm, selnode) );
+      for( i = 0; i < ntopm; i++ )
+         traceChild(scip, nodeseldata, topmchildren[i]);
+      SCIPfreeBufferArray(scip, &topmvals);
+      SCIPfreeBufferArray(scip, &topmchildren);
+   }
+   if( !topm || *selnode == NULL )
+      *selnode = SCIPgetBestNode(scip);
 
+   /* an empty tree after evictions does not prove optimality: interrupt, so that SCIP reports a limit instead */
+   if( *selnode == NULL && nodeseldata->nevictions > 0 )
+   {
+      SCIPwarningMessage(scip, "node selector <%s> evicted %"SCIP_LONGINT_FORMAT" open nodes, the solve is not exact; "
+         "evicted bound %.4e\n", NODESEL_NAME, nodeseldata->nevicted,
+         SCIPretransformObj(scip, nodeseldata->evictedbound));
+      SCIP_CALL( SCIPinterruptSolve(scip) );
    }
 
-   *selnode = SCIPgetBestNode(scip);
+   if( SCIPlivestatIsDue() )
+      SCIPlivestatPublishNodesel(NODESEL_NAME, &nodeseldata->policy->modelhist, -1);
+
+   start = SCIPprofileStart();
+
+   if( *selnode != NULL )
+   {
+      SCIPtraceRecord(nodeseldata->trace, SCIP_TRACEEVT_SELECT, SCIPnodeGetNumber(*selnode), nchildren + nsiblings + nleaves,
+         SCIPnodeGetLowerbound(*selnode), SCIPgetPrimalbound(scip), SCIPgetDualbound(scip), SCIPnodeGetScore(*selnode));
+   }
+
+   if( nodeseldata->evtlog != NULL )
+   {
+      SCIP_CALL( SCIPevtlogSelect(scip, nodeseldata->evtlog, *selnode, nchildren + nsiblings + nleaves,
+            FALSE) );
+   }
 
-   if (TRUE)
+   /* text log of the selection, written from trace level 1 unless there is an event log; the final solutions are
+    * always printed
+    */
+   traceselect = nodeseldata->evtlog == NULL && SCIPtraceIsOn(nodeseldata->trace, SCIP_TRACELEVEL_SELECT);
+   if( traceselect || *selnode == NULL )
    {
       int idx = -1;
       int depth = -1;
@@ -194,6 +1479,8 @@ SCIP_DECL_NODESELSELECT(nodeselSelectPolicy)
       if (*selnode != NULL)
       {
          idx = SCIPnodeGetNumber(*selnode);
+
+         /* without an event log, the branching path of a selection is only in the text log */
          SCIPprintNodeRootPath(scip, *selnode, NULL);
 
          depth = SCIPnodeGetDepth(*selnode);
@@ -201,31 +1488,34 @@ SCIP_DECL_NODESELSELECT(nodeselSelectPolicy)
          lowerbound = SCIPnodeGetLowerbound(*selnode);
       }
 
-      // SCIPdebugMessage("final selecting node number %d primalbound %.3f lowerbound %.3f dualbound %.3f score %f\n", idx, primalbound, lowerbound, dualbound, score);
-      SCIPdebugMessage("final selecting node number %d primalbound %.3f lowerbound %.3f dualbound %.3f time %.2f depth %d left %d bPB_time %.2f score %.3f nsols %d ", 
-                                                   idx, primalbound, lowerbound, dualbound, current_time, depth, left, bPB_time, score, nsols);
-
-      if ( *selnode != NULL)
+      if( traceselect )
       {
-         SCIP_SOL** sols_top5;
-         sols_top5 = SCIPgetSols(scip);
+         // SCIPdebugMessage("final selecting node number %d primalbound %.3f lowerbound %.3f dualbound %.3f score %f\n", idx, primalbound, lowerbound, dualbound, score);
+         SCIPtraceMessage("final selecting node number %d primalbound %.3f lowerbound %.3f dualbound %.3f time %.2f depth %d left %d bPB_time %.2f score %.3f nsols %d ", 
+                                                      idx, primalbound, lowerbound, dualbound, current_time, depth, left, bPB_time, score, nsols);
 
-         for (s = 0; s < 5 && s < nsols; ++s)
+         if ( *selnode != NULL)
          {
-            SCIP_SOL* sol;
-            SCIP_Real objvalue = -1.0;
-            sol = sols_top5[s];
+            SCIP_SOL** sols_top5;
+            sols_top5 = SCIPgetSols(scip);
 
-            if( SCIPsolIsOriginal(sol) )
-               objvalue = SCIPsolGetOrigObj(sol);
-            else
-               objvalue = SCIPprobExternObjval(scip->transprob, scip->origprob, scip->set, SCIPsolGetObj(sol, scip->set, scip->transprob, scip->origprob));
+            for (s = 0; s < 5 && s < nsols; ++s)
+            {
+               SCIP_SOL* sol;
+               SCIP_Real objvalue = -1.0;
+               sol = sols_top5[s];
+
+               if( SCIPsolIsOriginal(sol) )
+                  objvalue = SCIPsolGetOrigObj(sol);
+               else
+                  objvalue = SCIPprobExternObjval(scip->transprob, scip->origprob, scip->set, SCIPsolGetObj(sol, scip->set, scip->transprob, scip->origprob));
             
-            SCIPinfoMessage(scip, NULL, "obj%d %.3f ", s, objvalue);
+               SCIPinfoMessage(scip, NULL, "obj%d %.3f ", s, objvalue);
+            }
          }
+         SCIPinfoMessage(scip, NULL, "total_time %.2f", total_time);
+         SCIPinfoMessage(scip, NULL, " \n");
       }
-      SCIPinfoMessage(scip, NULL, "total_time %.2f", total_time);
-      SCIPinfoMessage(scip, NULL, " \n");
    
       if ( *selnode == NULL)
       {
@@ -243,15 +1533,23 @@ SCIP_DECL_NODESELSELECT(nodeselSelectPolicy)
       }
    }
 
-   if (FALSE)
-      SCIPdebugMessage("Selecting node number %lld\n", *selnode != NULL ? SCIPnodeGetNumber(*selnode) : -1l);
-      
+   SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_LOG, start);
+   selectend = SCIPprofileStart();
+   SCIPhistAdd(&nodeseldata->selecthist, selectend - selectstart);
+   SCIPchrometraceSpan("select", selectstart, selectend);
+   SCIPperfcntStop(&nodeseldata->perfcnt, SCIP_PERFREGION_CALLBACK, &selectsnap);
+
    return SCIP_OKAY;
 }
 
-/** node comparison method of policy node selector */
+/** compares two nodes by score, then by depth and lower bound */
 static
-SCIP_DECL_NODESELCOMP(nodeselCompPolicy)
+int compNodes(
+   SCIP*              scip,
+   SCIP_NODESEL*      nodesel,
+   SCIP_NODE*         node1,
+   SCIP_NODE*         node2
+   )
 {  /*lint --e{715}*/
    SCIP_Real score1;
    SCIP_Real score2;
@@ -364,6 +1662,66 @@ SCIP_DECL_NODESELCOMP(nodeselCompPolicy)
    }
 }
 
+/** compares two nodes by their order keys, then by lower bound; returns FALSE if a node has no key */
+static
+SCIP_Bool compOrderKeys(
+   SCIP*              scip,
+   SCIP_NODESELDATA*  nodeseldata,
+   SCIP_NODE*         node1,
+   SCIP_NODE*         node2,
+   int*               result
+   )
+{
+   SCIP_Longint number1 = SCIPnodeGetNumber(node1);
+   SCIP_Longint number2 = SCIPnodeGetNumber(node2);
+   uint64_t key1;
+   uint64_t key2;
+
+   if( number1 >= nodeseldata->orderkeyssize || number2 >= nodeseldata->orderkeyssize )
+      return FALSE;
+
+   key1 = nodeseldata->orderkeys[number1];
+   key2 = nodeseldata->orderkeys[number2];
+   if( key1 == 0 || key2 == 0 )
+      return FALSE;
+
+   if( key1 < key2 )
+      *result = -1;
+   else if( key1 > key2 )
+      *result = +1;
+   else if( SCIPisLT(scip, SCIPnodeGetLowerbound(node1), SCIPnodeGetLowerbound(node2)) )
+      *result = -1;
+   else if( SCIPisGT(scip, SCIPnodeGetLowerbound(node1), SCIPnodeGetLowerbound(node2)) )
+      *result = +1;
+   else
+      *result = 0;
+
+   return TRUE;
+}
+
+/** node comparison method of policy node selector */
+static
+SCIP_DECL_NODESELCOMP(nodeselCompPolicy)
+{  /*lint --e{715}*/
+   SCIP_NODESELDATA* nodeseldata;
+   SCIP_Longint start;
+   SCIP_Bool timed;
+   int result;
+
+   nodeseldata = SCIPnodeselGetData(nodesel);
+   assert(nodeseldata != NULL);
+
+   /* the clock reads cost more than a key compare, so only a sample of the calls is timed */
+   timed = SCIPprofileSampleComp(&nodeseldata->profile);
+   start = timed ? SCIPprofileStart() : 0;
+   if( !compOrderKeys(scip, nodeseldata, node1, node2, &result) )
+      result = compNodes(scip, nodesel, node1, node2);
+   if( timed )
+      SCIPprofileStop(&nodeseldata->profile, SCIP_PROFPHASE_COMP, start);
+
+   return result;
+}
+
 /*
  * node selector specific interface methods
  */
@@ -381,6 +1739,26 @@ SCIP_RETCODE SCIPincludeNodeselPolicy(
 
    nodesel = NULL;
    nodeseldata->polfname = NULL;
+   nodeseldata->evtfname = NULL;
+   nodeseldata->samplefname = NULL;
+   nodeseldata->sampler = NULL;
+   nodeseldata->evtlog = NULL;
+   nodeseldata->statsfname = NULL;
+   nodeseldata->policy = NULL;
+   nodeseldata->trace = NULL;
+   nodeseldata->tracefname = NULL;
+   nodeseldata->orderkeys = NULL;
+   nodeseldata->orderkeyssize = 0;
+   nodeseldata->nmodelcalls = 0;
+   nodeseldata->nfallbacks = 0;
+   nodeseldata->featrows = NULL;
+   nodeseldata->featrowssize = 0;
+   nodeseldata->ngated = 0;
+   nodeseldata->asyncnumbers = NULL;
+   nodeseldata->asyncnnodes = NULL;
+   SCIPprofileReset(&nodeseldata->profile);
+   SCIPhistReset(&nodeseldata->selecthist);
+   SCIPperfcntInit(&nodeseldata->perfcnt);
 
    /* use SCIPincludeNodeselBasic() plus setter functions if you want to set callbacks one-by-one and your code should
     * compile independent of new callbacks being added in future SCIP versions
@@ -401,6 +1779,126 @@ SCIP_RETCODE SCIPincludeNodeselPolicy(
          "nodeselection/"NODESEL_NAME"/polfname",
          "name of the policy model file",
          &nodeseldata->polfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/evtfname",
+         "name of the file to write the binary solve-event log (empty: text log only)",
+         &nodeseldata->evtfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/samplefname",
+         "name of the file to write open-node queue samples to (empty: no sampling)",
+         &nodeseldata->samplefname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/samplefreq",
+         "sample the open nodes every this many selections (0: never by count)",
+         &nodeseldata->samplefreq, FALSE, DEFAULT_SAMPLEFREQ, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/sampleinterval",
+         "sample the open nodes every this many seconds of wall clock time (0: never by time)",
+         &nodeseldata->sampleinterval, FALSE, DEFAULT_SAMPLEINTERVAL, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/statsfname",
+         "name of the file to append the per-phase timing statistics to (empty: none)",
+         &nodeseldata->statsfname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodeselection/"NODESEL_NAME"/perfcounters",
+         "count cycles, instructions, cache and branch misses around select, feature extraction and scoring?",
+         &nodeseldata->perfcounters, FALSE, DEFAULT_PERFCOUNTERS, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/tracelevel",
+         "trace level of the text log (0: final solutions only, 1: one line per selection, 2: also per node)",
+         &nodeseldata->tracelevel, FALSE, DEFAULT_TRACELEVEL, 0, 2, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/traceringsize",
+         "number of recent events kept in memory and dumped at exit or after an error (0: none)",
+         &nodeseldata->traceringsize, FALSE, DEFAULT_TRACERINGSIZE, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip,
+         "nodeselection/"NODESEL_NAME"/tracefname",
+         "name of the file to dump the recent events to at exit (empty: dumped only after an error)",
+         &nodeseldata->tracefname, FALSE, DEFAULT_FILENAME, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodeselection/"NODESEL_NAME"/hybrid",
+         "score children with the model only inside the window below, otherwise let them inherit their parent's score?",
+         &nodeseldata->hybrid, FALSE, DEFAULT_HYBRID, NULL, NULL) );
+   SCIP_CALL( SCIPaddLongintParam(scip,
+         "nodeselection/"NODESEL_NAME"/hybridminnodes",
+         "hybrid mode: consult the model from this node count on",
+         &nodeseldata->hybridminnodes, FALSE, DEFAULT_HYBRIDMINNODES, 0LL, SCIP_LONGINT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddLongintParam(scip,
+         "nodeselection/"NODESEL_NAME"/hybridmaxnodes",
+         "hybrid mode: consult the model up to this node count (-1: no limit)",
+         &nodeseldata->hybridmaxnodes, FALSE, DEFAULT_HYBRIDMAXNODES, -1LL, SCIP_LONGINT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/hybridmindepth",
+         "hybrid mode: consult the model for children at this depth or deeper",
+         &nodeseldata->hybridmindepth, FALSE, DEFAULT_HYBRIDMINDEPTH, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/hybridmaxdepth",
+         "hybrid mode: consult the model for children up to this depth (-1: no limit)",
+         &nodeseldata->hybridmaxdepth, FALSE, DEFAULT_HYBRIDMAXDEPTH, -1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/hybridmingap",
+         "hybrid mode: consult the model while the relative gap is at least this large",
+         &nodeseldata->hybridmingap, FALSE, DEFAULT_HYBRIDMINGAP, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/hybridmaxopen",
+         "hybrid mode: consult the model while at most this many nodes are open (-1: no limit)",
+         &nodeseldata->hybridmaxopen, FALSE, DEFAULT_HYBRIDMAXOPEN, -1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodeselection/"NODESEL_NAME"/gate",
+         "call the model only for children whose relative bound is within gateband, score the others below it?",
+         &nodeseldata->gate, FALSE, DEFAULT_GATE, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/gateband",
+         "gate: largest relative bound (0: at the global lower bound, 1: at the upper bound) scored by the model",
+         &nodeseldata->gateband, FALSE, DEFAULT_GATEBAND, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodeselection/"NODESEL_NAME"/rerank",
+         "rescore the leaves in batched model calls after a new incumbent changed their bound-dependent features?",
+         &nodeseldata->rerank, FALSE, DEFAULT_RERANK, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/rerankk",
+         "rerank: rescore only this many leaves with the smallest lower bound (0: all)",
+         &nodeseldata->rerankk, FALSE, DEFAULT_RERANKK, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddLongintParam(scip,
+         "nodeselection/"NODESEL_NAME"/rerankmaxnodes",
+         "rerank: total number of leaf rescorings in the solve (-1: no limit)",
+         &nodeseldata->rerankmaxnodes, FALSE, DEFAULT_RERANKMAXNODES, -1LL, SCIP_LONGINT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/rerankmaxtime",
+         "rerank: total seconds spent rescoring leaves in the solve (-1: no limit)",
+         &nodeseldata->rerankmaxtime, FALSE, DEFAULT_RERANKMAXTIME, -1.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip,
+         "nodeselection/"NODESEL_NAME"/async",
+         "send the children's features to the model without waiting and apply the scores at a later select?",
+         &nodeseldata->async, FALSE, DEFAULT_ASYNC, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/asyncmaxpending",
+         "async: number of requests in flight before the oldest reply is waited for",
+         &nodeseldata->asyncmaxpending, FALSE, DEFAULT_ASYNCMAXPENDING, 1, INT_MAX / SCIP_POLICY_MAXBATCH, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/evictmaxopen",
+         "evict the lowest-scored leaves while more nodes than this are open (-1: no limit)",
+         &nodeseldata->evictmaxopen, FALSE, DEFAULT_EVICTMAXOPEN, -1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/evictmaxmem",
+         "evict the lowest-scored leaves while SCIP uses more than this many MB (-1: no limit)",
+         &nodeseldata->evictmaxmem, FALSE, DEFAULT_EVICTMAXMEM, -1.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/evictratio",
+         "evict: evict down to this fraction of the open-node limit, or this fraction of the leaves over the memory limit",
+         &nodeseldata->evictratio, FALSE, DEFAULT_EVICTRATIO, 0.0, 1.0, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,
+         "nodeselection/"NODESEL_NAME"/evictsafety",
+         "evict: keep leaves whose lower bound is within this relative distance of the dual bound (-1: off)",
+         &nodeseldata->evictsafety, FALSE, DEFAULT_EVICTSAFETY, -1.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/topm",
+         "rank the children and this many leaves with the smallest lower bound in one model batch per select (0: off)",
+         &nodeseldata->topm, FALSE, DEFAULT_TOPM, 0, MAXTOPM, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,
+         "nodeselection/"NODESEL_NAME"/topmscan",
+         "topm: preselect from the best-bound leaf and a moving window of this many leaves per select (-1: all)",
+         &nodeseldata->topmscan, FALSE, DEFAULT_TOPMSCAN, -1, INT_MAX, NULL, NULL) );
 
    return SCIP_OKAY;
 }
@@ -0,0 +1,116 @@
+/**@file   opttable.c
+ * @brief  methods for the dense lookup of the optimal solution
+ *
+ * SCIPgetSolVal() on the original optimal solution transforms every queried variable back to the original space;
+ * the table does this once per active variable and run, so labelling a node costs one array read per bound change.
+ * Binary variables, which most branchings are on, are also kept as a bitset so that their values stay in a few cache
+ * lines. A restart renumbers the variables and can change how many binaries there are, so both are refilled then.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <stdint.h>
+#include "scip/def.h"
+#include "opttable.h"
+
+/** create an empty table for the given optimal solution */
+SCIP_RETCODE SCIPopttableCreate(
+   SCIP*              scip,
+   SCIP_OPTTABLE**    table,
+   SCIP_SOL*          sol
+   )
+{
+   assert(scip != NULL);
+   assert(table != NULL);
+   assert(sol != NULL);
+
+   SCIP_CALL( SCIPallocBlockMemory(scip, table) );
+   (*table)->sol = sol;
+   (*table)->vals = NULL;
+   (*table)->binbits = NULL;
+   (*table)->nvars = 0;
+   (*table)->nbinvars = 0;
+   (*table)->nrun = -1;
+
+   return SCIP_OKAY;
+}
+
+/** free the table */
+void SCIPopttableFree(
+   SCIP*              scip,
+   SCIP_OPTTABLE**    table
+   )
+{
+   assert(scip != NULL);
+   assert(table != NULL);
+   assert(*table != NULL);
+
+   BMSfreeMemoryArrayNull(&(*table)->vals);
+   BMSfreeMemoryArrayNull(&(*table)->binbits);
+   SCIPfreeBlockMemory(scip, table);
+}
+
+/** fill the table if this has not been done in the current run */
+SCIP_RETCODE SCIPopttableUpdate(
+   SCIP*              scip,
+   SCIP_OPTTABLE*     table
+   )
+{
+   SCIP_VAR** vars;
+   int nvars;
+   int nbinvars;
+   int i;
+
+   assert(scip != NULL);
+   assert(table != NULL);
+
+   if( table->vals != NULL && table->nrun == SCIPgetNRuns(scip) )
+      return SCIP_OKAY;
+
+   assert(SCIPgetStage(scip) == SCIP_STAGE_SOLVING);
+
+   /* after a restart the problem indices belong to the new presolved problem */
+   BMSfreeMemoryArrayNull(&table->vals);
+   BMSfreeMemoryArrayNull(&table->binbits);
+
+   vars = SCIPgetVars(scip);
+   nvars = SCIPgetNVars(scip);
+   nbinvars = SCIPgetNBinVars(scip);
+
+   SCIP_ALLOC( BMSallocMemoryArray(&table->vals, MAX(nvars, 1)) );
+   SCIP_ALLOC( BMSallocMemoryArray(&table->binbits, nbinvars / 64 + 1) );
+   BMSclearMemoryArray(table->binbits, nbinvars / 64 + 1);
+   for( i = 0; i < nvars; i++ )
+   {
+      assert(SCIPvarGetProbindex(vars[i]) == i);
+      table->vals[i] = SCIPgetSolVal(scip, table->sol, vars[i]);
+      if( i < nbinvars && table->vals[i] > 0.5 )
+         table->binbits[i >> 6] |= (uint64_t)1 << (i & 63);
+   }
+   table->nvars = nvars;
+   table->nbinvars = nbinvars;
+   table->nrun = SCIPgetNRuns(scip);
+
+   return SCIP_OKAY;
+}
+
+/** optimal value of a variable */
+SCIP_Real SCIPopttableGetVal(
+   SCIP*              scip,
+   SCIP_OPTTABLE*     table,
+   SCIP_VAR*          var
+   )
+{
+   int idx;
+
+   assert(table != NULL);
+   assert(var != NULL);
+
+   idx = SCIPvarGetProbindex(var);
+   if( idx >= 0 && idx < table->nbinvars )
+      return SCIPopttableGetBinVal(table, idx);
+   if( idx >= 0 && idx < table->nvars )
+      return table->vals[idx];
+
+   return SCIPgetSolVal(scip, table->sol, var);
+}
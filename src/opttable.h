@@ -0,0 +1,58 @@
+/**@file   opttable.h
+ * @brief  internal methods for the dense lookup of the optimal solution
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_OPTTABLE_H__
+#define __SCIP_OPTTABLE_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_opttable.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** create an empty table for the given optimal solution */
+extern
+SCIP_RETCODE SCIPopttableCreate(
+   SCIP*              scip,
+   SCIP_OPTTABLE**    table,
+   SCIP_SOL*          sol                 /**< optimal solution, must outlive the table */
+   );
+
+/** free the table */
+extern
+void SCIPopttableFree(
+   SCIP*              scip,
+   SCIP_OPTTABLE**    table
+   );
+
+/** fill the table if this has not been done in the current run; call in the solving stage before SCIPopttableGetVal() */
+extern
+SCIP_RETCODE SCIPopttableUpdate(
+   SCIP*              scip,
+   SCIP_OPTTABLE*     table
+   );
+
+/** optimal value of a binary variable given by its problem index, which must be smaller than table->nbinvars; only
+ *  valid after SCIPopttableUpdate() in the current run
+ */
+#define SCIPopttableGetBinVal(table, idx) \
+   ((((table)->binbits[(idx) >> 6] >> ((idx) & 63)) & 1) != 0 ? 1.0 : 0.0)
+
+/** optimal value of a variable */
+extern
+SCIP_Real SCIPopttableGetVal(
+   SCIP*              scip,
+   SCIP_OPTTABLE*     table,
+   SCIP_VAR*          var
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,333 @@
+/**@file   perfcnt.c
+ * @brief  methods for hardware performance counters around node selector and pruner hot paths
+ *
+ * The events are opened with perf_event_open(2) as one group for the solving thread (user space only), so a region
+ * costs two read(2) calls of the group. Off Linux, or when compiled with -DNO_PERFEVENT, the counters are never
+ * available.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <string.h>
+#include "scip/def.h"
+#include "perfcnt.h"
+
+#if defined(__linux__) && !defined(NO_PERFEVENT)
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define PERFCNT_SUPPORTED
+#endif
+
+static const char* eventnames[SCIP_PERFEVENT_N] = {
+   "cycles",
+   "instructions",
+   "cachemisses",
+   "branchmisses"
+};
+
+static const char* regionnames[SCIP_PERFREGION_N] = {
+   "callback",
+   "feature",
+   "model"
+};
+
+#ifdef PERFCNT_SUPPORTED
+static const unsigned long long eventconfigs[SCIP_PERFEVENT_N] = {
+   PERF_COUNT_HW_CPU_CYCLES,
+   PERF_COUNT_HW_INSTRUCTIONS,
+   PERF_COUNT_HW_CACHE_MISSES,
+   PERF_COUNT_HW_BRANCH_MISSES
+};
+
+/** layout of a group read with PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING */
+struct GroupRead
+{
+   unsigned long long nr;
+   unsigned long long timeenabled;
+   unsigned long long timerunning;
+   unsigned long long values[SCIP_PERFEVENT_N];
+};
+
+/** open one event of the group; returns -1 and sets errno on failure */
+static
+int openEvent(
+   SCIP_PERFEVENT     event,
+   int                groupfd
+   )
+{
+   struct perf_event_attr attr;
+
+   memset(&attr, 0, sizeof(attr));
+   attr.size = sizeof(attr);
+   attr.type = PERF_TYPE_HARDWARE;
+   attr.config = eventconfigs[event];
+   attr.disabled = (groupfd == -1);
+   attr.exclude_kernel = 1;
+   attr.exclude_hv = 1;
+   attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+   return (int)syscall(__NR_perf_event_open, &attr, 0, -1, groupfd, 0);
+}
+
+/** read the whole group; returns FALSE if the read failed */
+static
+SCIP_Bool readGroup(
+   SCIP_PERFCNT*      perfcnt,
+   struct GroupRead*  buf
+   )
+{
+   ssize_t size;
+   int e;
+
+   /* the group leader is the first event that opened */
+   for( e = 0; perfcnt->fds[e] == -1; e++ )
+      assert(e < SCIP_PERFEVENT_N - 1);
+
+   size = read(perfcnt->fds[e], buf, sizeof(*buf));
+   if( size < (ssize_t)(3 + perfcnt->nopen) * (ssize_t)sizeof(unsigned long long) )
+      return FALSE;
+
+   if( buf->timerunning < buf->timeenabled )
+      perfcnt->multiplexed = TRUE;
+
+   return TRUE;
+}
+#endif
+
+/** mark the counters as closed and reset the totals */
+void SCIPperfcntInit(
+   SCIP_PERFCNT*      perfcnt
+   )
+{
+   int e;
+
+   assert(perfcnt != NULL);
+
+   BMSclearMemory(perfcnt);
+   for( e = 0; e < SCIP_PERFEVENT_N; e++ )
+   {
+      perfcnt->fds[e] = -1;
+      perfcnt->slot[e] = -1;
+   }
+}
+
+/** open the counter group for the calling thread and reset the totals */
+SCIP_RETCODE SCIPperfcntOpen(
+   SCIP*              scip,
+   SCIP_PERFCNT*      perfcnt
+   )
+{
+#ifdef PERFCNT_SUPPORTED
+   int leader;
+   int err;
+   int e;
+#endif
+
+   assert(scip != NULL);
+   assert(perfcnt != NULL);
+
+   SCIPperfcntClose(perfcnt);
+   SCIPperfcntInit(perfcnt);
+
+#ifdef PERFCNT_SUPPORTED
+   /* the first event that opens becomes the group leader; events the PMU does not provide are left out */
+   leader = -1;
+   err = 0;
+   for( e = 0; e < SCIP_PERFEVENT_N; e++ )
+   {
+      perfcnt->fds[e] = openEvent((SCIP_PERFEVENT)e, leader);
+      if( perfcnt->fds[e] == -1 )
+      {
+         if( err == 0 )
+            err = errno;
+         continue;
+      }
+      if( leader == -1 )
+         leader = perfcnt->fds[e];
+      perfcnt->slot[e] = perfcnt->nopen++;
+   }
+
+   if( leader == -1 )
+   {
+      SCIPverbMessage(scip, SCIP_VERBLEVEL_NORMAL, NULL, "hardware performance counters not available (%s), "
+         "see kernel.perf_event_paranoid\n", strerror(err));
+      return SCIP_OKAY;
+   }
+
+   for( e = 0; e < SCIP_PERFEVENT_N; e++ )
+   {
+      if( perfcnt->slot[e] == -1 )
+         SCIPverbMessage(scip, SCIP_VERBLEVEL_NORMAL, NULL, "hardware event <%s> not available\n", eventnames[e]);
+   }
+
+   (void)ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+   (void)ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+   SCIPverbMessage(scip, SCIP_VERBLEVEL_NORMAL, NULL, "hardware performance counters not supported on this platform\n");
+#endif
+
+   return SCIP_OKAY;
+}
+
+/** close the counter group; the totals are kept for printing */
+void SCIPperfcntClose(
+   SCIP_PERFCNT*      perfcnt
+   )
+{
+   int e;
+
+   assert(perfcnt != NULL);
+
+   for( e = SCIP_PERFEVENT_N - 1; e >= 0; e-- )
+   {
+#ifdef PERFCNT_SUPPORTED
+      if( perfcnt->fds[e] != -1 )
+         (void)close(perfcnt->fds[e]);
+#endif
+      perfcnt->fds[e] = -1;
+   }
+   perfcnt->nopen = 0;
+}
+
+/** read the counters at the start of a region */
+void SCIPperfcntStart(
+   SCIP_PERFCNT*      perfcnt,
+   SCIP_PERFSNAP*     snap
+   )
+{
+#ifdef PERFCNT_SUPPORTED
+   struct GroupRead buf;
+   int e;
+#endif
+
+   assert(perfcnt != NULL);
+   assert(snap != NULL);
+
+   if( !SCIPperfcntIsOn(perfcnt) )
+      return;
+
+#ifdef PERFCNT_SUPPORTED
+   if( !readGroup(perfcnt, &buf) )
+   {
+      SCIPperfcntClose(perfcnt);
+      return;
+   }
+   for( e = 0; e < SCIP_PERFEVENT_N; e++ )
+      snap->vals[e] = perfcnt->slot[e] >= 0 ? (SCIP_Longint)buf.values[perfcnt->slot[e]] : 0;
+#endif
+}
+
+/** add the counts since snap to a region */
+void SCIPperfcntStop(
+   SCIP_PERFCNT*      perfcnt,
+   SCIP_PERFREGION    region,
+   SCIP_PERFSNAP*     snap
+   )
+{
+#ifdef PERFCNT_SUPPORTED
+   struct GroupRead buf;
+   int e;
+#endif
+
+   assert(perfcnt != NULL);
+   assert(region >= 0 && region < SCIP_PERFREGION_N);
+   assert(snap != NULL);
+
+   if( !SCIPperfcntIsOn(perfcnt) )
+      return;
+
+#ifdef PERFCNT_SUPPORTED
+   if( !readGroup(perfcnt, &buf) )
+   {
+      SCIPperfcntClose(perfcnt);
+      return;
+   }
+   perfcnt->count[region]++;
+   for( e = 0; e < SCIP_PERFEVENT_N; e++ )
+   {
+      if( perfcnt->slot[e] >= 0 )
+         perfcnt->totals[region][e] += (SCIP_Longint)buf.values[perfcnt->slot[e]] - snap->vals[e];
+   }
+#endif
+}
+
+/** print the counter totals as part of a statistics block */
+void SCIPperfcntPrint(
+   SCIP*              scip,
+   SCIP_PERFCNT*      perfcnt,
+   FILE*              file
+   )
+{
+   SCIP_Longint* tot;
+   SCIP_Real kinstr;
+   int r;
+
+   assert(scip != NULL);
+   assert(perfcnt != NULL);
+
+   for( r = 0; r < SCIP_PERFREGION_N && perfcnt->count[r] == 0; r++ )
+      ;
+   if( r == SCIP_PERFREGION_N )
+      return;
+
+   SCIPinfoMessage(scip, file, "  perf region      :      count  cycles/op   instr/op        IPC llcmiss/ki  brmiss/ki\n");
+   for( r = 0; r < SCIP_PERFREGION_N; r++ )
+   {
+      if( perfcnt->count[r] == 0 )
+         continue;
+      tot = perfcnt->totals[r];
+      kinstr = (SCIP_Real)tot[SCIP_PERFEVENT_INSTRUCTIONS] / 1e3;
+      SCIPinfoMessage(scip, file, "    %-14s : %10"SCIP_LONGINT_FORMAT" %10.0f %10.0f %10.2f %10.2f %10.2f\n",
+         regionnames[r], perfcnt->count[r],
+         (SCIP_Real)tot[SCIP_PERFEVENT_CYCLES] / perfcnt->count[r],
+         (SCIP_Real)tot[SCIP_PERFEVENT_INSTRUCTIONS] / perfcnt->count[r],
+         tot[SCIP_PERFEVENT_CYCLES] > 0 ? (SCIP_Real)tot[SCIP_PERFEVENT_INSTRUCTIONS] / tot[SCIP_PERFEVENT_CYCLES] : 0.0,
+         kinstr > 0.0 ? tot[SCIP_PERFEVENT_CACHEMISSES] / kinstr : 0.0,
+         kinstr > 0.0 ? tot[SCIP_PERFEVENT_BRANCHMISSES] / kinstr : 0.0);
+   }
+   if( perfcnt->multiplexed )
+      SCIPinfoMessage(scip, file, "    (counters were multiplexed with other perf users, counts are partial)\n");
+}
+
+/** append the counter totals to a machine-readable stats file */
+SCIP_RETCODE SCIPperfcntWrite(
+   SCIP*              scip,
+   SCIP_PERFCNT*      perfcnt,
+   const char*        fname,
+   const char*        component
+   )
+{
+   FILE* file;
+   int r;
+   int e;
+
+   assert(scip != NULL);
+   assert(perfcnt != NULL);
+   assert(fname != NULL);
+   assert(component != NULL);
+
+   file = fopen(fname, "a");
+   if( file == NULL )
+   {
+      SCIPerrorMessage("cannot open stats file <%s> for writing\n", fname);
+      SCIPprintSysError(fname);
+      return SCIP_NOFILE;
+   }
+
+   for( r = 0; r < SCIP_PERFREGION_N; r++ )
+   {
+      if( perfcnt->count[r] == 0 )
+         continue;
+      fprintf(file, "%s perf %s count %"SCIP_LONGINT_FORMAT, component, regionnames[r], perfcnt->count[r]);
+      for( e = 0; e < SCIP_PERFEVENT_N; e++ )
+         fprintf(file, " %s %"SCIP_LONGINT_FORMAT, eventnames[e], perfcnt->slot[e] >= 0 ? perfcnt->totals[r][e] : -1LL);
+      fprintf(file, "\n");
+   }
+
+   fclose(file);
+
+   return SCIP_OKAY;
+}
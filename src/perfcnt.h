@@ -0,0 +1,84 @@
+/**@file   perfcnt.h
+ * @brief  internal methods for hardware performance counters around node selector and pruner hot paths
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_PERFCNT_H__
+#define __SCIP_PERFCNT_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_perfcnt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** is the counter group open */
+#define SCIPperfcntIsOn(perfcnt) ((perfcnt)->nopen > 0)
+
+/** mark the counters as closed and reset the totals; call once before SCIPperfcntOpen() */
+extern
+void SCIPperfcntInit(
+   SCIP_PERFCNT*      perfcnt
+   );
+
+/** open the counter group for the calling thread and reset the totals
+ *
+ *  If perf events are not permitted (kernel.perf_event_paranoid, containers, no PMU in a virtual machine) a
+ *  warning is printed and the counters stay off; SCIPperfcntStart() and SCIPperfcntStop() are then no-ops.
+ */
+extern
+SCIP_RETCODE SCIPperfcntOpen(
+   SCIP*              scip,
+   SCIP_PERFCNT*      perfcnt
+   );
+
+/** close the counter group; the totals are kept for printing */
+extern
+void SCIPperfcntClose(
+   SCIP_PERFCNT*      perfcnt
+   );
+
+/** read the counters at the start of a region */
+extern
+void SCIPperfcntStart(
+   SCIP_PERFCNT*      perfcnt,
+   SCIP_PERFSNAP*     snap
+   );
+
+/** add the counts since snap to a region */
+extern
+void SCIPperfcntStop(
+   SCIP_PERFCNT*      perfcnt,
+   SCIP_PERFREGION    region,
+   SCIP_PERFSNAP*     snap                /**< values filled by SCIPperfcntStart() */
+   );
+
+/** print the counter totals as part of a statistics block; prints nothing if no region was counted */
+extern
+void SCIPperfcntPrint(
+   SCIP*              scip,
+   SCIP_PERFCNT*      perfcnt,
+   FILE*              file
+   );
+
+/** append the counter totals to a machine-readable stats file
+ *
+ *  One line per region: "<component> perf <region> count <n> cycles <n> instructions <n> cachemisses <n>
+ *  branchmisses <n>", with -1 for events that could not be opened.
+ */
+extern
+SCIP_RETCODE SCIPperfcntWrite(
+   SCIP*              scip,
+   SCIP_PERFCNT*      perfcnt,
+   const char*        fname,
+   const char*        component           /**< e.g. "nodesel.policy" */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,5 +1,3 @@
-#define SCIP_DEBUG
-
 /**@file   policy.c
  * @brief  methods for policy
  * @author He He 
@@ -11,8 +9,18 @@
 #include "feat.h"
 #include "struct_feat.h"
 #include "policy.h"
+#include "profile.h"
+#include "hist.h"
+#include "memacct.h"
+#include "perfcnt.h"
+
+#include <unistd.h>
 
 #define HEADERSIZE_LIBSVM       6 
+#define DRAINWAIT               1000000  /**< microseconds to wait for the replies still in flight on free */
+#define DRAINPOLL               1000     /**< microseconds between two polls for them */
+
+void delete_server(struct model_server* p_s);
 
 SCIP_RETCODE SCIPpolicyCreate(
    SCIP*              scip,
@@ -25,6 +33,11 @@ SCIP_RETCODE SCIPpolicyCreate(
    SCIP_CALL( SCIPallocBlockMemory(scip, policy) );
    (*policy)->weights = NULL;
    (*policy)->size = 0;
+   (*policy)->server = NULL;
+   (*policy)->prune = FALSE;
+   SCIPhistReset(&(*policy)->modelhist);
+   (*policy)->nasyncsent = 0;
+   (*policy)->nasyncreceived = 0;
 
    return SCIP_OKAY;
 }
@@ -40,8 +53,40 @@ SCIP_RETCODE SCIPpolicyFree(
 
    if ((*policy)->weights != NULL)
    {
+      SCIPmemacctFree(SCIP_MEMCOMP_POLICY, (size_t)(*policy)->size * sizeof(SCIP_Real));
       BMSfreeMemoryArray(&(*policy)->weights);
    }
+
+   /* read the replies still in flight, they would otherwise be taken for replies of the next run; the wait is bounded,
+    * since a server that died would never send them
+    */
+   if ((*policy)->nasyncreceived < (*policy)->nasyncsent)
+   {
+      int waited = 0;
+
+      while ((*policy)->nasyncreceived < (*policy)->nasyncsent && waited < DRAINWAIT)
+      {
+         SCIP_Real score;
+         int seq;
+         int nscores;
+
+         SCIP_CALL( SCIPreceiveNNNodeScores(&score, 0, FALSE, *policy, &seq, &nscores) );
+         if (nscores < 0)
+         {
+            usleep(DRAINPOLL);
+            waited += DRAINPOLL;
+         }
+      }
+
+      if ((*policy)->nasyncreceived < (*policy)->nasyncsent)
+      {
+         SCIPwarningMessage(scip, "%d model replies did not arrive within %.1f seconds and were not read\n",
+            (*policy)->nasyncsent - (*policy)->nasyncreceived, DRAINWAIT / 1e6);
+      }
+   }
+
+   if ((*policy)->server != NULL)
+      delete_server((*policy)->server);
    
    SCIPfreeBlockMemory(scip, policy);
 
@@ -80,6 +125,7 @@ SCIP_RETCODE SCIPreadLIBSVMPolicy(
    }
 
    SCIP_CALL( SCIPallocMemoryArray(scip, &(*policy)->weights, (*policy)->size) );
+   SCIPmemacctAlloc(SCIP_MEMCOMP_POLICY, (size_t)(*policy)->size * sizeof(SCIP_Real));
 
    /* have to reopen to read weights */
    file = fopen(fname, "r");
@@ -125,6 +171,7 @@ void SCIPcalcNodeScore(
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
@@ -188,6 +235,16 @@ SCIP_RETCODE SCIPreadNNPolicy(
    char* substr = "searchPolicy";
    char* str = strstr(fname, substr);
    int i = 0, numPolicy = 0;
+
+   /* pruning policies are served from the same directory as killPolicy.<n>.bin */
+   (*policy)->prune = FALSE;
+   if (str == NULL && (str = strstr(fname, "killPolicy")) != NULL)
+      (*policy)->prune = TRUE;
+   if (str == NULL)
+   {
+      SCIPerrorMessage("policy file <%s> is neither a searchPolicy nor a killPolicy\n", fname);
+      return SCIP_NOFILE;
+   }
    while (*(str+i) != '\0')
    {
       if (str[i] >= '0' && str[i] <= '9')
@@ -211,6 +268,7 @@ typedef struct model_server {
 model_server_t create_server() {
 
 	model_server_t p_s = (model_server_t) malloc(sizeof(struct model_server));
+	SCIPmemacctAlloc(SCIP_MEMCOMP_MODEL, sizeof(struct model_server));
 
 	if ( -1 == (p_s->receive_id = msgget((key_t)4321, IPC_CREAT | 0666)))
 	{
@@ -228,18 +286,20 @@ model_server_t create_server() {
 }
 
 void delete_server(model_server_t p_s) {
+	SCIPmemacctFree(SCIP_MEMCOMP_MODEL, sizeof(struct model_server));
 	free(p_s);
 }
 
-void send(double *data, unsigned data_len, int send_server_id) {
+void send_typed(double *data, unsigned data_len, long type, int send_server_id) {
 
 	void *databuf = malloc(data_len * sizeof(double) + sizeof(long));
+	SCIPmemacctAlloc(SCIP_MEMCOMP_MODEL, data_len * sizeof(double) + sizeof(long));
 
 	// for (int i = 0; i < data_len * sizeof(double) + sizeof(long); i++) {
 	// 	((unsigned char *)databuf)[i] = (unsigned char)i;
 	// }
 
-	((long *)databuf) [0] = TYPE_ARRAY;
+	((long *)databuf) [0] = type;
 
 	memcpy(databuf+sizeof(long), data, data_len * sizeof(double));
 
@@ -251,22 +311,53 @@ void send(double *data, unsigned data_len, int send_server_id) {
 		exit(1);
 	}
 
+	SCIPmemacctFree(SCIP_MEMCOMP_MODEL, data_len * sizeof(double) + sizeof(long));
 	free(databuf);
 }
 
-void receive(double *data, unsigned data_len, int receive_server_id) {
+void send(double *data, unsigned data_len, int send_server_id) {
+
+	send_typed(data, data_len, TYPE_ARRAY, send_server_id);
+}
 
+// 只读type类型的消息，返回读到的double个数；flags含IPC_NOWAIT且没有消息时返回-1
+int receive_typed(double *data, unsigned data_len, long type, int flags, int receive_server_id) {
+
+	ssize_t nbytes;
 	void *databuf = malloc(data_len * sizeof(double) + sizeof(long));
-	((long *)databuf) [0] = TYPE_ARRAY;
+	SCIPmemacctAlloc(SCIP_MEMCOMP_MODEL, data_len * sizeof(double) + sizeof(long));
+	((long *)databuf) [0] = type;
 
-	if ( -1 == msgrcv(receive_server_id, databuf, sizeof(double)*data_len, 0, 0))
+	if ( -1 == (nbytes = msgrcv(receive_server_id, databuf, sizeof(double)*data_len, type, flags)))
 	{
+		if ((flags & IPC_NOWAIT) && errno == ENOMSG)
+		{
+			SCIPmemacctFree(SCIP_MEMCOMP_MODEL, data_len * sizeof(double) + sizeof(long));
+			free(databuf);
+			return -1;
+		}
 		perror("msgrcv() failed");
 		exit(1);
 	}
 
-	memcpy(data, databuf+sizeof(long), data_len * sizeof(double));
+	memcpy(data, databuf+sizeof(long), (size_t)nbytes);
+	SCIPmemacctFree(SCIP_MEMCOMP_MODEL, data_len * sizeof(double) + sizeof(long));
 	free(databuf);
+
+	return (int)(nbytes / sizeof(double));
+}
+
+// 同步调用只读TYPE_ARRAY的回复，不会取走异步请求的回复
+void receive(double *data, unsigned data_len, int receive_server_id) {
+
+	(void) receive_typed(data, data_len, TYPE_ARRAY, 0, receive_server_id);
+}
+
+void call_model_typed(double *data, unsigned data_len, long type, double *out, unsigned out_len, model_server_t p_s) {
+
+	send_typed(data, data_len, type, p_s->send_id);
+
+	receive(out, out_len, p_s->receive_id);
 }
 
 void call_model(double *data, unsigned data_len, double *out, unsigned out_len, model_server_t p_s) {
@@ -288,8 +379,11 @@ void SCIPcalcNNNodeScore(
    int FEATURE_SIZE = 20;
 	double input[FEATURE_SIZE + 1];
 	double output[2] = {DBL_MAX};
-   model_server_t server = create_server();
    SCIP_Real* featvals = SCIPfeatGetVals(feat);
+   SCIP_Longint start;
+
+   if (policy->server == NULL)
+      policy->server = create_server();
 
    for (int i = 0; i < SCIPfeatGetSize(feat); i ++)
    {
@@ -300,7 +394,9 @@ void SCIPcalcNNNodeScore(
    while (1)
    {
       // 过一段时间更新模型参
-		call_model(input, FEATURE_SIZE + 1, output, 2, server);
+      start = SCIPprofileStart();
+		call_model(input, FEATURE_SIZE + 1, output, 2, policy->server);
+      SCIPhistAdd(&policy->modelhist, SCIPprofileStart() - start);
       
       if (output[0] != DBL_MAX)
       {
@@ -311,6 +407,308 @@ void SCIPcalcNNNodeScore(
    }
 }
 
+/** calculate the NN policy scores of several feature rows
+ *
+ * A batch is sent as its feature rows followed by the policy number, and answered with a status value followed by one
+ * score per row; a batch of one node selection row is the message of SCIPcalcNNNodeScore(). Rows of a pruning policy
+ * are sent with their own message type, since they are shorter.
+ */
+SCIP_RETCODE SCIPcalcNNScores(
+   SCIP_Real*         featvals,
+   int                nnodes,
+   int                featsize,
+   SCIP_POLICY*       policy,
+   SCIP_Real*         scores
+   )
+{
+   double* input;
+   double* output;
+   SCIP_Longint start;
+   int first;
+   int n;
+   int i;
+
+   assert(featvals != NULL || nnodes == 0);
+   assert(scores != NULL || nnodes == 0);
+
+   if( nnodes == 0 )
+      return SCIP_OKAY;
+
+   if (policy->server == NULL)
+      policy->server = create_server();
+
+   SCIP_ALLOC( BMSallocMemoryArray(&input, SCIP_POLICY_MAXBATCH * featsize + 1) );
+   SCIP_ALLOC( BMSallocMemoryArray(&output, SCIP_POLICY_MAXBATCH + 1) );
+   SCIPmemacctAlloc(SCIP_MEMCOMP_MODEL, (size_t)(SCIP_POLICY_MAXBATCH * featsize + SCIP_POLICY_MAXBATCH + 2) * sizeof(double));
+
+   for( first = 0; first < nnodes; first += n )
+   {
+      n = MIN(nnodes - first, SCIP_POLICY_MAXBATCH);
+
+      memcpy(input, &featvals[first * featsize], (size_t)(n * featsize) * sizeof(double));
+      input[n * featsize] = (double) (policy->numPolicy);
+
+      do
+      {
+         output[0] = DBL_MAX;
+         start = SCIPprofileStart();
+         call_model_typed(input, (unsigned)(n * featsize + 1), policy->prune ? TYPE_PRUNEARRAY : TYPE_ARRAY, output,
+            (unsigned)(n + 1), policy->server);
+         SCIPhistAdd(&policy->modelhist, SCIPprofileStart() - start);
+      }
+      while (output[0] == DBL_MAX);
+
+      for( i = 0; i < n; i++ )
+         scores[first + i] = output[i + 1];
+   }
+
+   SCIPmemacctFree(SCIP_MEMCOMP_MODEL, (size_t)(SCIP_POLICY_MAXBATCH * featsize + SCIP_POLICY_MAXBATCH + 2) * sizeof(double));
+   BMSfreeMemoryArray(&output);
+   BMSfreeMemoryArray(&input);
+
+   return SCIP_OKAY;
+}
+
+/** calculate the scores of several nodes with the NN policy and set them as the node scores */
+SCIP_RETCODE SCIPcalcNNNodeScoreBatch(
+   SCIP_NODE**        nodes,
+   SCIP_Real*         featvals,
+   int                nnodes,
+   int                featsize,
+   SCIP_POLICY*       policy
+   )
+{
+   SCIP_Real* scores;
+   int i;
+
+   assert(nodes != NULL || nnodes == 0);
+
+   if( nnodes == 0 )
+      return SCIP_OKAY;
+
+   SCIP_ALLOC( BMSallocMemoryArray(&scores, nnodes) );
+   SCIPmemacctAlloc(SCIP_MEMCOMP_MODEL, (size_t)nnodes * sizeof(SCIP_Real));
+
+   SCIP_CALL( SCIPcalcNNScores(featvals, nnodes, featsize, policy, scores) );
+   for( i = 0; i < nnodes; i++ )
+      SCIPnodeSetScore(nodes[i], scores[i]);
+
+   SCIPmemacctFree(SCIP_MEMCOMP_MODEL, (size_t)nnodes * sizeof(SCIP_Real));
+   BMSfreeMemoryArray(&scores);
+
+   return SCIP_OKAY;
+}
+
+/** allocate the buffers of a prune batch */
+SCIP_RETCODE SCIPpruneBatchInit(
+   SCIP*              scip,
+   SCIP_PRUNEBATCH*   batch
+   )
+{
+   batch->nbatch = 0;
+   batch->nbatches = 0;
+   SCIP_CALL( SCIPallocMemoryArray(scip, &batch->numbers, SCIP_POLICY_MAXBATCH) );
+   SCIP_CALL( SCIPallocMemoryArray(scip, &batch->scores, SCIP_POLICY_MAXBATCH) );
+   SCIP_CALL( SCIPallocMemoryArray(scip, &batch->vals, SCIP_POLICY_MAXBATCH * SCIP_FEATNODEPRU_SIZE) );
+
+   return SCIP_OKAY;
+}
+
+/** free the buffers of a prune batch */
+void SCIPpruneBatchExit(
+   SCIP*              scip,
+   SCIP_PRUNEBATCH*   batch
+   )
+{
+   SCIPfreeMemoryArrayNull(scip, &batch->vals);
+   SCIPfreeMemoryArrayNull(scip, &batch->scores);
+   SCIPfreeMemoryArrayNull(scip, &batch->numbers);
+}
+
+/** may the node be pruned by a pruning policy?
+ *
+ * Nodes whose lower bound is within safetyeps (relative) of the global lower bound are always kept; pruning them would
+ * raise the dual bound and can cut off every optimal solution.
+ */
+SCIP_Bool SCIPpolicyIsPrunable(
+   SCIP*              scip,
+   SCIP_NODE*         node,
+   SCIP_Real          safetyeps
+   )
+{
+   SCIP_Real lowerbound;
+
+   if( safetyeps < 0.0 )
+      return TRUE;
+
+   lowerbound = SCIPgetLowerbound(scip);
+   if( SCIPisInfinity(scip, -lowerbound) )
+      return FALSE;
+
+   return SCIPisGT(scip, SCIPnodeGetLowerbound(node), lowerbound + safetyeps * MAX(REALABS(lowerbound), 1.0));
+}
+
+/** pruning score of a node
+ *
+ * A node that is not in the last batch is scored in one model call together with the prunable open siblings and
+ * children, which are examined in the same pass; they are answered from the batch later. Their features are those at
+ * the time of the batch. The features of the node itself are computed last, so they are left in the feature buffer.
+ */
+SCIP_RETCODE SCIPpolicyGetPruneScore(
+   SCIP*              scip,
+   SCIP_POLICY*       policy,
+   SCIP_FEAT*         feat,
+   SCIP_PRUNEBATCH*   batch,
+   SCIP_Real          safetyeps,
+   SCIP_PROFILE*      profile,
+   SCIP_PERFCNT*      perfcnt,
+   SCIP_NODE*         node,
+   SCIP_Real*         score
+   )
+{
+   SCIP_NODE* cands[SCIP_POLICY_MAXBATCH];
+   SCIP_NODE** siblings;
+   SCIP_NODE** children;
+   SCIP_Longint number = SCIPnodeGetNumber(node);
+   SCIP_Longint start;
+   SCIP_PERFSNAP snap;
+   int nsiblings;
+   int nchildren;
+   int ncands;
+   int i;
+
+   for( i = 0; i < batch->nbatch; i++ )
+   {
+      if( batch->numbers[i] == number )
+      {
+         *score = batch->scores[i];
+         return SCIP_OKAY;
+      }
+   }
+
+   SCIP_CALL( SCIPgetSiblings(scip, &siblings, &nsiblings) );
+   SCIP_CALL( SCIPgetChildren(scip, &children, &nchildren) );
+
+   cands[0] = node;
+   ncands = 1;
+   for( i = 0; i < nsiblings && ncands < SCIP_POLICY_MAXBATCH; i++ )
+   {
+      if( siblings[i] != node && SCIPpolicyIsPrunable(scip, siblings[i], safetyeps) )
+         cands[ncands++] = siblings[i];
+   }
+   for( i = 0; i < nchildren && ncands < SCIP_POLICY_MAXBATCH; i++ )
+   {
+      if( children[i] != node && SCIPpolicyIsPrunable(scip, children[i], safetyeps) )
+         cands[ncands++] = children[i];
+   }
+
+   start = SCIPprofileStart();
+   SCIPperfcntStart(perfcnt, &snap);
+   for( i = ncands - 1; i >= 0; i-- )
+   {
+      SCIPcalcNodepruFeat(scip, cands[i], feat);
+      BMScopyMemoryArray(&batch->vals[i * SCIP_FEATNODEPRU_SIZE], SCIPfeatGetVals(feat), SCIP_FEATNODEPRU_SIZE);
+      batch->numbers[i] = SCIPnodeGetNumber(cands[i]);
+   }
+   SCIPperfcntStop(perfcnt, SCIP_PERFREGION_FEAT, &snap);
+   SCIPprofileStop(profile, SCIP_PROFPHASE_FEAT, start);
+
+   start = SCIPprofileStart();
+   SCIPperfcntStart(perfcnt, &snap);
+   SCIP_CALL( SCIPcalcNNScores(batch->vals, ncands, SCIP_FEATNODEPRU_SIZE, policy, batch->scores) );
+   SCIPperfcntStop(perfcnt, SCIP_PERFREGION_MODEL, &snap);
+   SCIPprofileStop(profile, SCIP_PROFPHASE_MODEL, start);
+
+   batch->nbatch = ncands;
+   batch->nbatches++;
+   *score = batch->scores[0];
+
+   return SCIP_OKAY;
+}
+
+/** send the feature rows of several nodes to the NN policy without waiting for their scores
+ *
+ * The request is the feature rows followed by a sequence number and the policy number. It has its own message type,
+ * so synchronous calls never read its reply; the reply is the sequence number followed by one score per node. The
+ * server answers in order, so replies arrive in the order of the requests.
+ */
+SCIP_RETCODE SCIPrequestNNNodeScores(
+   SCIP_Real*         featvals,
+   int                nnodes,
+   int                featsize,
+   SCIP_POLICY*       policy,
+   int*               seq
+   )
+{
+   double* input;
+
+   assert(featvals != NULL);
+   assert(nnodes > 0 && nnodes <= SCIP_POLICY_MAXBATCH);
+   assert(seq != NULL);
+
+   if (policy->server == NULL)
+      policy->server = create_server();
+
+   SCIP_ALLOC( BMSallocMemoryArray(&input, nnodes * featsize + 2) );
+   SCIPmemacctAlloc(SCIP_MEMCOMP_MODEL, (size_t)(nnodes * featsize + 2) * sizeof(double));
+
+   memcpy(input, featvals, (size_t)(nnodes * featsize) * sizeof(double));
+   input[nnodes * featsize] = (double) (policy->nasyncsent);
+   input[nnodes * featsize + 1] = (double) (policy->numPolicy);
+
+   send_typed(input, (unsigned)(nnodes * featsize + 2), TYPE_ASYNCARRAY, policy->server->send_id);
+   *seq = policy->nasyncsent++;
+
+   SCIPmemacctFree(SCIP_MEMCOMP_MODEL, (size_t)(nnodes * featsize + 2) * sizeof(double));
+   BMSfreeMemoryArray(&input);
+
+   return SCIP_OKAY;
+}
+
+/** read the reply to the oldest request of SCIPrequestNNNodeScores() that has not been read yet
+ *
+ * Scores beyond maxscores are dropped. If wait is FALSE and the reply has not arrived, nscores is set to -1.
+ */
+SCIP_RETCODE SCIPreceiveNNNodeScores(
+   SCIP_Real*         scores,
+   int                maxscores,
+   SCIP_Bool          wait,
+   SCIP_POLICY*       policy,
+   int*               seq,
+   int*               nscores
+   )
+{
+   double* output;
+   int len;
+
+   assert(scores != NULL || maxscores == 0);
+   assert(policy->nasyncreceived < policy->nasyncsent);
+   assert(policy->server != NULL);
+   assert(seq != NULL);
+   assert(nscores != NULL);
+
+   SCIP_ALLOC( BMSallocMemoryArray(&output, SCIP_POLICY_MAXBATCH + 1) );
+   SCIPmemacctAlloc(SCIP_MEMCOMP_MODEL, (size_t)(SCIP_POLICY_MAXBATCH + 1) * sizeof(double));
+
+   len = receive_typed(output, SCIP_POLICY_MAXBATCH + 1, TYPE_ASYNCARRAY, wait ? 0 : IPC_NOWAIT,
+      policy->server->receive_id);
+   if (len < 1)
+      *nscores = -1;
+   else
+   {
+      *seq = (int) output[0];
+      *nscores = MIN(len - 1, maxscores);
+      if (*nscores > 0)
+         memcpy(scores, &output[1], (size_t)(*nscores) * sizeof(double));
+      policy->nasyncreceived++;
+   }
+
+   SCIPmemacctFree(SCIP_MEMCOMP_MODEL, (size_t)(SCIP_POLICY_MAXBATCH + 1) * sizeof(double));
+   BMSfreeMemoryArray(&output);
+
+   return SCIP_OKAY;
+}
+
 // NN functions
 void SCIPcalcNNNodeScoreConcat(
    SCIP_NODE*         node,
@@ -326,10 +724,13 @@ void SCIPcalcNNNodeScoreConcat(
    int length = 3 * FEATURE_SIZE;
 	double input[length + 1];
 	double output[2] = {DBL_MAX};
-   model_server_t server = create_server();
    SCIP_Real* featvals = SCIPfeatGetVals(feat);
    SCIP_Real* left_featvals = SCIPfeatGetVals(left_feat);
    SCIP_Real* right_featvals = SCIPfeatGetVals(right_feat);
+   SCIP_Longint start;
+
+   if (policy->server == NULL)
+      policy->server = create_server();
 
    for (int i = 0; i < FEATURE_SIZE; i ++)
    {
@@ -351,7 +752,9 @@ void SCIPcalcNNNodeScoreConcat(
    while (1)
    {
       // 过一段时间更新模型参�?
-		call_model(input, length + 1, output, 2, server);
+      start = SCIPprofileStart();
+		call_model(input, length + 1, output, 2, policy->server);
+      SCIPhistAdd(&policy->modelhist, SCIPprofileStart() - start);
       
       if (output[0] != DBL_MAX)
       {
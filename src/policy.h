@@ -11,6 +11,9 @@
 #include "scip/def.h"
 #include "scip/scip.h"
 #include "struct_policy.h"
+#include "type_feat.h"
+#include "struct_profile.h"
+#include "struct_perfcnt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +53,90 @@ void SCIPcalcNNNodeScore(
    SCIP_POLICY*       policy
    );
 
+/** maximum number of nodes scored in one round trip; keeps a message below the default message queue size (16 KB) */
+#define SCIP_POLICY_MAXBATCH    64
+
+/** calculate the NN policy scores of several feature rows, SCIP_POLICY_MAXBATCH rows per round trip; row i is
+ *  featvals[i * featsize], ..., featvals[(i + 1) * featsize - 1] and its score is written to scores[i]
+ */
+SCIP_RETCODE SCIPcalcNNScores(
+   SCIP_Real*         featvals,
+   int                nnodes,
+   int                featsize,
+   SCIP_POLICY*       policy,
+   SCIP_Real*         scores
+   );
+
+/** calculate the scores of several nodes with the NN policy and set them as the node scores, SCIP_POLICY_MAXBATCH
+ *  nodes per round trip; the feature values of nodes[i] are featvals[i * featsize], ..., featvals[(i + 1) * featsize - 1]
+ */
+SCIP_RETCODE SCIPcalcNNNodeScoreBatch(
+   SCIP_NODE**        nodes,
+   SCIP_Real*         featvals,
+   int                nnodes,
+   int                featsize,
+   SCIP_POLICY*       policy
+   );
+
+/** allocate the buffers of a prune batch, which holds SCIP_POLICY_MAXBATCH nodes */
+SCIP_RETCODE SCIPpruneBatchInit(
+   SCIP*              scip,
+   SCIP_PRUNEBATCH*   batch
+   );
+
+/** free the buffers of a prune batch */
+void SCIPpruneBatchExit(
+   SCIP*              scip,
+   SCIP_PRUNEBATCH*   batch
+   );
+
+/** may the node be pruned by a pruning policy? Nodes whose lower bound is within safetyeps (relative) of the global
+ *  lower bound are kept (safetyeps < 0: no node is kept)
+ */
+SCIP_Bool SCIPpolicyIsPrunable(
+   SCIP*              scip,
+   SCIP_NODE*         node,
+   SCIP_Real          safetyeps
+   );
+
+/** pruning score of a node, scored in one batch with the prunable siblings and children if it is not in the last
+ *  batch; the features of the node are left in feat
+ */
+SCIP_RETCODE SCIPpolicyGetPruneScore(
+   SCIP*              scip,
+   SCIP_POLICY*       policy,
+   SCIP_FEAT*         feat,
+   SCIP_PRUNEBATCH*   batch,
+   SCIP_Real          safetyeps,
+   SCIP_PROFILE*      profile,
+   SCIP_PERFCNT*      perfcnt,
+   SCIP_NODE*         node,
+   SCIP_Real*         score
+   );
+
+/** send the feature rows of at most SCIP_POLICY_MAXBATCH nodes to the NN policy without waiting for the scores; seq
+ *  is set to the sequence number of the request, numbered from 0 per policy
+ */
+SCIP_RETCODE SCIPrequestNNNodeScores(
+   SCIP_Real*         featvals,
+   int                nnodes,
+   int                featsize,
+   SCIP_POLICY*       policy,
+   int*               seq
+   );
+
+/** read the reply to the oldest unread request of SCIPrequestNNNodeScores(); replies are read in the order of the
+ *  requests. If wait is FALSE and the reply has not arrived yet, nscores is set to -1.
+ */
+SCIP_RETCODE SCIPreceiveNNNodeScores(
+   SCIP_Real*         scores,
+   int                maxscores,
+   SCIP_Bool          wait,
+   SCIP_POLICY*       policy,
+   int*               seq,
+   int*               nscores
+   );
+
 /** calculate score of a node given its feature and the NN policy weight vector */
 void SCIPcalcNNNodeScoreConcat(
    SCIP_NODE*         node,
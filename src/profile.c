@@ -0,0 +1,155 @@
+/**@file   profile.c
+ * @brief  methods for per-phase timing of node selectors and pruners
+ *
+ * Each timed section costs two reads of the monotonic clock (vDSO, no system call on Linux).
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <time.h>
+#include "scip/def.h"
+#include "profile.h"
+#include "chrometrace.h"
+
+#define NSEC_PER_SEC    1000000000LL
+
+static const char* phasenames[SCIP_PROFPHASE_N] = {
+   "feature",
+   "model",
+   "trjwrite",
+   "log",
+   "comp"
+};
+
+/** reset all phase statistics */
+void SCIPprofileReset(
+   SCIP_PROFILE*      profile
+   )
+{
+   assert(profile != NULL);
+
+   BMSclearMemory(profile);
+}
+
+/** current time of the monotonic clock in nanoseconds */
+SCIP_Longint SCIPprofileStart(
+   void
+   )
+{
+   struct timespec ts;
+
+   (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (SCIP_Longint)ts.tv_sec * NSEC_PER_SEC + (SCIP_Longint)ts.tv_nsec;
+}
+
+/** should this comparator call be timed? */
+SCIP_Bool SCIPprofileSampleComp(
+   SCIP_PROFILE*      profile
+   )
+{
+   assert(profile != NULL);
+
+   return profile->ncompcalls++ % SCIP_PROFILE_COMPSAMPLE == 0;
+}
+
+/** add the time since start to a phase, and a span to the Chrome trace if one is open */
+void SCIPprofileStop(
+   SCIP_PROFILE*      profile,
+   SCIP_PROFPHASE     phase,
+   SCIP_Longint       start
+   )
+{
+   SCIP_PROFSTAT* stat;
+   SCIP_Longint end;
+   SCIP_Longint elapsed;
+
+   assert(profile != NULL);
+   assert(phase >= 0 && phase < SCIP_PROFPHASE_N);
+
+   end = SCIPprofileStart();
+   elapsed = end - start;
+
+   /* comparator calls are far too frequent and short to be drawn as spans */
+   if( phase != SCIP_PROFPHASE_COMP )
+      SCIPchrometraceSpan(phasenames[phase], start, end);
+
+   stat = &profile->stats[phase];
+
+   /* a timed comparator call is a sample of SCIP_PROFILE_COMPSAMPLE calls */
+   if( phase == SCIP_PROFPHASE_COMP )
+   {
+      stat->count += SCIP_PROFILE_COMPSAMPLE;
+      stat->total += elapsed * SCIP_PROFILE_COMPSAMPLE;
+   }
+   else
+   {
+      stat->count++;
+      stat->total += elapsed;
+   }
+   if( elapsed > stat->max )
+      stat->max = elapsed;
+}
+
+/** print the phase statistics as part of a statistics block */
+void SCIPprofilePrint(
+   SCIP*              scip,
+   SCIP_PROFILE*      profile,
+   FILE*              file
+   )
+{
+   SCIP_PROFSTAT* stat;
+   int p;
+
+   assert(scip != NULL);
+   assert(profile != NULL);
+
+   SCIPinfoMessage(scip, file, "  phase            :      count   total(s)   mean(us)    max(us)\n");
+   for( p = 0; p < SCIP_PROFPHASE_N; p++ )
+   {
+      stat = &profile->stats[p];
+      if( stat->count == 0 )
+         continue;
+      SCIPinfoMessage(scip, file, "    %-14s : %10"SCIP_LONGINT_FORMAT" %10.3f %10.2f %10.2f\n", phasenames[p], stat->count,
+         (SCIP_Real)stat->total / NSEC_PER_SEC, (SCIP_Real)stat->total / stat->count / 1e3, (SCIP_Real)stat->max / 1e3);
+   }
+}
+
+/** append the phase statistics to a machine-readable stats file */
+SCIP_RETCODE SCIPprofileWrite(
+   SCIP*              scip,
+   SCIP_PROFILE*      profile,
+   const char*        fname,
+   const char*        component
+   )
+{
+   SCIP_PROFSTAT* stat;
+   FILE* file;
+   int p;
+
+   assert(scip != NULL);
+   assert(profile != NULL);
+   assert(fname != NULL);
+   assert(component != NULL);
+
+   file = fopen(fname, "a");
+   if( file == NULL )
+   {
+      SCIPerrorMessage("cannot open stats file <%s> for writing\n", fname);
+      SCIPprintSysError(fname);
+      return SCIP_NOFILE;
+   }
+
+   for( p = 0; p < SCIP_PROFPHASE_N; p++ )
+   {
+      stat = &profile->stats[p];
+      fprintf(file, "%s %s count %"SCIP_LONGINT_FORMAT" total %.9f mean %.9f max %.9f\n", component, phasenames[p],
+         stat->count, (SCIP_Real)stat->total / NSEC_PER_SEC,
+         stat->count > 0 ? (SCIP_Real)stat->total / stat->count / NSEC_PER_SEC : 0.0,
+         (SCIP_Real)stat->max / NSEC_PER_SEC);
+   }
+
+   fclose(file);
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,70 @@
+/**@file   profile.h
+ * @brief  internal methods for per-phase timing of node selectors and pruners
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_PROFILE_H__
+#define __SCIP_PROFILE_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** reset all phase statistics */
+extern
+void SCIPprofileReset(
+   SCIP_PROFILE*      profile
+   );
+
+/** current time of the monotonic clock in nanoseconds; pass it to SCIPprofileStop() */
+extern
+SCIP_Longint SCIPprofileStart(
+   void
+   );
+
+/** add the time since start to a phase */
+extern
+void SCIPprofileStop(
+   SCIP_PROFILE*      profile,
+   SCIP_PROFPHASE     phase,
+   SCIP_Longint       start               /**< value returned by SCIPprofileStart() */
+   );
+
+/** should this comparator call be timed? Every SCIP_PROFILE_COMPSAMPLE-th call is, so that the comparator is not
+ *  dominated by the clock reads around it
+ */
+extern
+SCIP_Bool SCIPprofileSampleComp(
+   SCIP_PROFILE*      profile
+   );
+
+/** print the phase statistics as part of a statistics block */
+extern
+void SCIPprofilePrint(
+   SCIP*              scip,
+   SCIP_PROFILE*      profile,
+   FILE*              file
+   );
+
+/** append the phase statistics to a machine-readable stats file
+ *
+ *  One line per phase: "<component> <phase> count <n> total <s> mean <s> max <s>".
+ */
+extern
+SCIP_RETCODE SCIPprofileWrite(
+   SCIP*              scip,
+   SCIP_PROFILE*      profile,
+   const char*        fname,
+   const char*        component           /**< e.g. "nodesel.policy" */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
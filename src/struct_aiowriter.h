@@ -0,0 +1,77 @@
+/**@file   struct_aiowriter.h
+ * @brief  data structures for asynchronous file writers
+ *
+ *  This file defines the buffered writer used for trajectory files and the solver log. Text is formatted into a set
+ *  of fixed buffers; a full buffer is handed to the kernel while the next one is being filled.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_AIOWRITER_H__
+#define __SCIP_STRUCT_AIOWRITER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "scip/def.h"
+
+/** submission and completion rings of an io_uring instance, mapped from the kernel */
+struct SCIP_AioRing
+{
+   int            fd;                 /**< io_uring file descriptor (-1: not set up) */
+   void*          sqptr;              /**< mapping of the submission ring */
+   size_t         sqsize;
+   void*          cqptr;              /**< mapping of the completion ring (may equal sqptr) */
+   size_t         cqsize;
+   void*          sqes;               /**< mapping of the submission queue entries */
+   size_t         sqessize;
+   unsigned*      sqhead;
+   unsigned*      sqtail;
+   unsigned*      sqmask;
+   unsigned*      sqarray;
+   unsigned*      cqhead;
+   unsigned*      cqtail;
+   unsigned*      cqmask;
+   void*          cqes;
+};
+typedef struct SCIP_AioRing SCIP_AIORING;
+
+/** asynchronous writer
+ *
+ * With io_uring, the buffers are registered with the kernel and written with fixed-buffer writes at explicit file
+ * offsets; submissions are batched into one system call. Without io_uring (unsupported kernel, seccomp, or a
+ * non-seekable output such as a pipe), full buffers are written synchronously with pwrite (or write).
+ */
+struct SCIP_AioWriter
+{
+   int            fd;                 /**< output file descriptor */
+   SCIP_Bool      ownsfd;             /**< close fd when the writer is freed? */
+   SCIP_Bool      seekable;           /**< can fd be written at explicit offsets? */
+   int64_t        offset;             /**< file offset of the next buffer */
+   char*          mem;                /**< memory of all buffers */
+   int*           fill;               /**< number of bytes in each buffer */
+   int64_t*       bufoffset;          /**< file offset each submitted buffer is written at */
+   SCIP_Bool*     inflight;           /**< is the buffer owned by the kernel? */
+   int            nbuffers;
+   int            buffersize;
+   int            cur;                /**< buffer being filled */
+   int            nqueued;            /**< submissions queued in the ring but not yet entered */
+   int            ninflight;          /**< buffers submitted but not yet completed */
+   int            batchsize;          /**< number of queued submissions entered with one system call */
+   SCIP_Bool      useuring;           /**< is io_uring in use? */
+   SCIP_AIORING   ring;
+   SCIP_Bool      error;              /**< did a write fail? (reported on flush) */
+   SCIP_Longint   nbytes;             /**< number of bytes written */
+   SCIP_Longint   nwrites;            /**< number of buffers written */
+   SCIP_Longint   nsyscalls;          /**< number of system calls spent on writing */
+};
+typedef struct SCIP_AioWriter SCIP_AIOWRITER;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
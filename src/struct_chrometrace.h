@@ -0,0 +1,52 @@
+/**@file   struct_chrometrace.h
+ * @brief  data structures for the Chrome trace-event export of the solve timeline
+ *
+ *  This file defines the event buffer that is written in the Chrome/Perfetto JSON trace-event format.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_CHROMETRACE_H__
+#define __SCIP_STRUCT_CHROMETRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include "scip/def.h"
+
+/** one recorded event; names must be string literals, they are only formatted at flush time */
+struct SCIP_CtEvent
+{
+   const char*    name;               /**< span or counter track name */
+   const char*    argname[2];         /**< counter series names (NULL: unused) */
+   SCIP_Real      val[2];             /**< counter values */
+   SCIP_Longint   ts;                 /**< start time in nanoseconds since the trace was opened */
+   SCIP_Longint   dur;                /**< duration in nanoseconds (-1: counter) */
+};
+typedef struct SCIP_CtEvent SCIP_CTEVENT;
+
+/** timeline export
+ *
+ * Events go into a fixed-size buffer; the buffer is formatted and written when it is full and when the trace is
+ * closed, so memory stays bounded however long the solve runs.
+ */
+struct SCIP_ChromeTrace
+{
+   FILE*          file;
+   SCIP_CTEVENT*  events;
+   int            nevents;
+   int            size;               /**< capacity of the event buffer */
+   SCIP_Longint   origin;             /**< monotonic clock time when the trace was opened */
+   SCIP_Longint   nwritten;           /**< number of events written */
+   SCIP_Real      lplast;             /**< LP time at the last LP solved event */
+};
+typedef struct SCIP_ChromeTrace SCIP_CHROMETRACE;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
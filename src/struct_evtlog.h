@@ -0,0 +1,39 @@
+/**@file   struct_evtlog.h
+ * @brief  data structures for solve-event logs
+ *
+ *  This file defines the binary event log written by node selectors on every node selection.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_EVTLOG_H__
+#define __SCIP_STRUCT_EVTLOG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "scip/def.h"
+#include "struct_aiowriter.h"
+
+/** binary solve-event log
+ *
+ * The log replaces printing the root path of every selected node: each selection record only holds the branching
+ * bound change that created the node and the number of its parent, so paths are rebuilt offline.
+ */
+struct SCIP_EvtLog
+{
+   SCIP_AIOWRITER* writer;
+   SCIP_Bool*     varwritten;         /**< has the name of the variable been written? (indexed by probindex) */
+   int            varwrittensize;
+   SCIP_Longint   nbestsolsfound;     /**< number of improving solutions already logged */
+   SCIP_Longint   nrecords;           /**< number of records written */
+};
+typedef struct SCIP_EvtLog SCIP_EVTLOG;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
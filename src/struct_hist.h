@@ -0,0 +1,40 @@
+/**@file   struct_hist.h
+ * @brief  data structures for latency histograms
+ *
+ *  This file defines the log-bucketed latency histogram kept by the policy and the node selectors.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_HIST_H__
+#define __SCIP_STRUCT_HIST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "scip/def.h"
+
+/* values below 2^SCIP_HIST_SUBBITS are counted exactly; above, every power of two is split into 2^SCIP_HIST_SUBBITS
+ * equal buckets, which bounds the relative error by 2^-SCIP_HIST_SUBBITS (HDR histogram with 1 significant digit) */
+#define SCIP_HIST_SUBBITS       4
+#define SCIP_HIST_NSUB          (1 << SCIP_HIST_SUBBITS)
+#define SCIP_HIST_NMAGNITUDES   40        /**< values up to 2^(SCIP_HIST_NMAGNITUDES+SCIP_HIST_SUBBITS) ns (~4.9 h) */
+#define SCIP_HIST_NBUCKETS      ((SCIP_HIST_NMAGNITUDES + 1) * SCIP_HIST_NSUB)
+
+/** latency histogram, values in nanoseconds */
+struct SCIP_Hist
+{
+   SCIP_Longint   buckets[SCIP_HIST_NBUCKETS];
+   SCIP_Longint   count;
+   SCIP_Longint   sum;
+   SCIP_Longint   max;
+};
+typedef struct SCIP_Hist SCIP_HIST;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
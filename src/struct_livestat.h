@@ -0,0 +1,56 @@
+/**@file   struct_livestat.h
+ * @brief  data structures for live solve metrics in shared memory
+ *
+ *  This file defines the page a solver process publishes its progress in; scripts/09_monitor.py reads the same
+ *  layout, so fields are only ever appended (and LIVESTAT_VERSION raised).
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_LIVESTAT_H__
+#define __SCIP_STRUCT_LIVESTAT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "scip/def.h"
+
+#define SCIP_LIVESTAT_NAMELEN   128
+
+/** live metrics of one solve, native byte order, all fields 8-byte aligned
+ *
+ * The page has a single writer and is read without locks: the writer makes seq odd before and even after an update,
+ * a reader retries until it sees the same even seq before and after copying the page.
+ */
+struct SCIP_LiveStatPage
+{
+   char           magic[4];           /**< "LIVE" */
+   uint32_t       version;
+   uint64_t       seq;                /**< update sequence number, odd while an update is in progress */
+   int64_t        pid;
+   int64_t        finished;           /**< 1 once the solve has ended */
+   double         starttime;          /**< wall clock time of the start in seconds since the epoch */
+   double         updatetime;         /**< wall clock time of the last update in seconds since the epoch */
+   double         solvingtime;        /**< SCIP solving time */
+   int64_t        nnodes;             /**< nodes processed */
+   int64_t        nopen;              /**< open nodes */
+   double         primalbound;
+   double         dualbound;
+   double         gap;
+   int64_t        nmodelcalls;        /**< scoring server round trips */
+   int64_t        modelns;            /**< total round trip time in nanoseconds */
+   int64_t        modelmaxns;         /**< longest round trip in nanoseconds */
+   int64_t        trjbytes;           /**< trajectory bytes written (-1: no trajectory) */
+   char           nodesel[32];        /**< name of the node selector */
+   char           name[SCIP_LIVESTAT_NAMELEN]; /**< problem name */
+};
+typedef struct SCIP_LiveStatPage SCIP_LIVESTATPAGE;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
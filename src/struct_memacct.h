@@ -0,0 +1,57 @@
+/**@file   struct_memacct.h
+ * @brief  data structures for per-component memory accounting of the plugins
+ *
+ *  This file defines the accounted components and their counters.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_MEMACCT_H__
+#define __SCIP_STRUCT_MEMACCT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "scip/def.h"
+
+/** accounted components */
+enum SCIP_MemComp
+{
+   SCIP_MEMCOMP_FEAT     = 0,            /**< feature vectors */
+   SCIP_MEMCOMP_MODEL    = 1,            /**< scoring server connection and model input/output buffers */
+   SCIP_MEMCOMP_POLICY   = 2,            /**< policy weights */
+   SCIP_MEMCOMP_TRJ      = 3,            /**< trajectory sink: current group, sampled groups and writer buffers */
+   SCIP_MEMCOMP_NODEDATA = 4             /**< per-node side data: trajectory row hashes indexed by node number */
+};
+typedef enum SCIP_MemComp SCIP_MEMCOMP;
+
+#define SCIP_MEMCOMP_N     5
+
+/** counters of one component */
+struct SCIP_MemStat
+{
+   SCIP_Longint   current;            /**< bytes currently allocated */
+   SCIP_Longint   peak;               /**< maximal value of current */
+   SCIP_Longint   nallocs;            /**< number of allocations (a reallocation counts as one) */
+   SCIP_Longint   nfrees;             /**< number of frees */
+   SCIP_Longint   nshed;              /**< number of times the component dropped work because of the soft cap */
+};
+typedef struct SCIP_MemStat SCIP_MEMSTAT;
+
+/** memory accounting of the plugins of one process */
+struct SCIP_MemAcct
+{
+   SCIP_MEMSTAT   stats[SCIP_MEMCOMP_N];
+   SCIP_Longint   current;            /**< bytes currently allocated by all components */
+   SCIP_Longint   peak;               /**< maximal value of current */
+   SCIP_Longint   softcap;            /**< bytes above which components shed load (0: no cap) */
+};
+typedef struct SCIP_MemAcct SCIP_MEMACCT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+/**@file   struct_opttable.h
+ * @brief  data structures for the dense lookup of the optimal solution
+ *
+ *  This file defines the table of optimal values used to label nodes.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_OPTTABLE_H__
+#define __SCIP_STRUCT_OPTTABLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "scip/def.h"
+#include "scip/type_sol.h"
+
+/** optimal values of the active problem variables, indexed by SCIPvarGetProbindex()
+ *
+ * The table is filled on first use in the solving stage of each run, when presolving has fixed the problem variables
+ * and their indices; a restart presolves again and renumbers them, so the table is refilled in the next run.
+ * Variables outside of it are looked up in the solution.
+ */
+struct SCIP_OptTable
+{
+   SCIP_SOL*      sol;                /**< optimal solution (not owned) */
+   SCIP_Real*     vals;               /**< optimal values, NULL until the table is filled */
+   uint64_t*      binbits;            /**< optimal values of the binary variables of the current run, one bit each */
+   int            nvars;              /**< number of entries in vals */
+   int            nbinvars;           /**< number of bits in binbits; binaries come first in the problem */
+   int            nrun;               /**< run in which the table was filled */
+};
+typedef struct SCIP_OptTable SCIP_OPTTABLE;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
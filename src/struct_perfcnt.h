@@ -0,0 +1,65 @@
+/**@file   struct_perfcnt.h
+ * @brief  data structures for hardware performance counters around node selector and pruner hot paths
+ *
+ *  This file defines the counted events and the regions they are aggregated over.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_PERFCNT_H__
+#define __SCIP_STRUCT_PERFCNT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "scip/def.h"
+
+/** counted hardware events, opened as one group so that all of them count over the same interval */
+enum SCIP_PerfEvent
+{
+   SCIP_PERFEVENT_CYCLES       = 0,      /**< cpu cycles */
+   SCIP_PERFEVENT_INSTRUCTIONS = 1,      /**< retired instructions */
+   SCIP_PERFEVENT_CACHEMISSES  = 2,      /**< last level cache misses */
+   SCIP_PERFEVENT_BRANCHMISSES = 3       /**< mispredicted branches */
+};
+typedef enum SCIP_PerfEvent SCIP_PERFEVENT;
+
+#define SCIP_PERFEVENT_N   4
+
+/** counted regions */
+enum SCIP_PerfRegion
+{
+   SCIP_PERFREGION_CALLBACK = 0,         /**< whole select or prune callback */
+   SCIP_PERFREGION_FEAT     = 1,         /**< feature extraction */
+   SCIP_PERFREGION_MODEL    = 2          /**< scoring (model call) */
+};
+typedef enum SCIP_PerfRegion SCIP_PERFREGION;
+
+#define SCIP_PERFREGION_N  3
+
+/** counter values at the start of a region */
+struct SCIP_PerfSnap
+{
+   SCIP_Longint   vals[SCIP_PERFEVENT_N];
+};
+typedef struct SCIP_PerfSnap SCIP_PERFSNAP;
+
+/** hardware performance counters, aggregated per region over one solve */
+struct SCIP_PerfCnt
+{
+   int            fds[SCIP_PERFEVENT_N];  /**< event file descriptors, fds[0] is the group leader; -1 if not available */
+   int            slot[SCIP_PERFEVENT_N]; /**< position of each event in a group read; -1 if not available */
+   int            nopen;                  /**< number of events in the group */
+   SCIP_Bool      multiplexed;            /**< was the group ever descheduled by the kernel (counts are then partial) */
+   SCIP_Longint   count[SCIP_PERFREGION_N];                   /**< number of times each region was entered */
+   SCIP_Longint   totals[SCIP_PERFREGION_N][SCIP_PERFEVENT_N]; /**< summed event counts per region */
+};
+typedef struct SCIP_PerfCnt SCIP_PERFCNT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,6 +16,7 @@ extern "C" {
 #endif
 
 #include "scip/def.h"
+#include "struct_hist.h"
 
 /** policy for node selector and pruner */
 struct SCIP_Policy
@@ -23,9 +24,25 @@ struct SCIP_Policy
    SCIP_Real*     weights;
    int            size;
    int            numPolicy;
+   SCIP_Bool      prune;              /**< pruning policy (killPolicy.<n>.bin) rather than search policy? */
+   struct model_server* server;       /**< message queues of the scoring server, opened on the first model call */
+   SCIP_HIST      modelhist;          /**< latency of model round trips */
+   int            nasyncsent;         /**< number of asynchronous requests sent */
+   int            nasyncreceived;     /**< number of replies to asynchronous requests read */
 };
 typedef struct SCIP_Policy SCIP_POLICY;
 
+/** pruning scores of the last batch of open nodes scored together by a pruning policy */
+struct SCIP_PruneBatch
+{
+   SCIP_Longint*  numbers;            /**< numbers of the nodes of the last batch */
+   SCIP_Real*     scores;             /**< scores of the nodes of the last batch */
+   SCIP_Real*     vals;               /**< feature rows of the last batch */
+   int            nbatch;             /**< number of nodes in the last batch */
+   int            nbatches;           /**< number of batched model calls */
+};
+typedef struct SCIP_PruneBatch SCIP_PRUNEBATCH;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,56 @@
+/**@file   struct_profile.h
+ * @brief  data structures for per-phase timing of node selectors and pruners
+ *
+ *  This file defines the phases timed inside the node selector and pruner callbacks.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_PROFILE_H__
+#define __SCIP_STRUCT_PROFILE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "scip/def.h"
+
+/** timed phases */
+enum SCIP_ProfPhase
+{
+   SCIP_PROFPHASE_FEAT     = 0,          /**< feature extraction */
+   SCIP_PROFPHASE_MODEL    = 1,          /**< model call (message queue round trip to the scoring server) */
+   SCIP_PROFPHASE_TRJWRITE = 2,          /**< trajectory writing */
+   SCIP_PROFPHASE_LOG      = 3,          /**< text and event logging */
+   SCIP_PROFPHASE_COMP     = 4           /**< comparator calls from SCIP's node queue */
+};
+typedef enum SCIP_ProfPhase SCIP_PROFPHASE;
+
+#define SCIP_PROFPHASE_N   5
+
+/** one comparator call in this many is timed; its time and count stand for all of them */
+#define SCIP_PROFILE_COMPSAMPLE 1024
+
+/** statistics of one phase, times in nanoseconds */
+struct SCIP_ProfStat
+{
+   SCIP_Longint   count;
+   SCIP_Longint   total;
+   SCIP_Longint   max;
+};
+typedef struct SCIP_ProfStat SCIP_PROFSTAT;
+
+/** per-phase timing, measured with the monotonic clock */
+struct SCIP_Profile
+{
+   SCIP_PROFSTAT  stats[SCIP_PROFPHASE_N];
+   SCIP_Longint   ncompcalls;         /**< comparator calls, timed or not */
+};
+typedef struct SCIP_Profile SCIP_PROFILE;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
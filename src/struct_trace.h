@@ -0,0 +1,64 @@
+/**@file   struct_trace.h
+ * @brief  data structures for runtime tracing of node selectors
+ *
+ *  This file defines the trace levels and the ring buffer of recent events kept by the node selectors.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_TRACE_H__
+#define __SCIP_STRUCT_TRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "scip/def.h"
+
+/** trace levels of the text log */
+enum SCIP_TraceLevel
+{
+   SCIP_TRACELEVEL_NONE    = 0,          /**< only the final solutions */
+   SCIP_TRACELEVEL_SELECT  = 1,          /**< one line per node selection */
+   SCIP_TRACELEVEL_NODE    = 2           /**< also one line per scored or checked node */
+};
+typedef enum SCIP_TraceLevel SCIP_TRACELEVEL;
+
+/** types of ring buffer events */
+enum SCIP_TraceEvtType
+{
+   SCIP_TRACEEVT_SELECT    = 0,          /**< node selected: ival open nodes, vals lowerbound, primalbound, dualbound, score */
+   SCIP_TRACEEVT_NODE      = 1           /**< child scored: ival optimal?, vals lowerbound, score, depth */
+};
+typedef enum SCIP_TraceEvtType SCIP_TRACEEVTTYPE;
+
+/** ring buffer event */
+struct SCIP_TraceEvent
+{
+   SCIP_Longint   time;               /**< nanoseconds since the trace was created */
+   SCIP_Longint   node;               /**< node number, -1 for none */
+   SCIP_Real      vals[4];
+   int            ival;
+   int            type;
+};
+typedef struct SCIP_TraceEvent SCIP_TRACEEVENT;
+
+/** runtime trace of a node selector */
+struct SCIP_Trace
+{
+   SCIP_TRACEEVENT* ring;             /**< ring buffer of recent events, NULL if disabled */
+   int            ringsize;
+   SCIP_Longint   nevents;            /**< number of events recorded */
+   SCIP_Longint   start;              /**< monotonic time of creation in nanoseconds */
+   int            level;              /**< trace level of the text log */
+   char           name[64];           /**< name of the traced plugin */
+   struct SCIP_Trace* next;           /**< next live trace, dumped together on errors */
+};
+typedef struct SCIP_Trace SCIP_TRACE;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
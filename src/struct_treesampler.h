@@ -0,0 +1,42 @@
+/**@file   struct_treesampler.h
+ * @brief  data structures for sampling the shape of the open-node queue
+ *
+ *  This file defines the sampler that node selectors call on every node selection.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_TREESAMPLER_H__
+#define __SCIP_STRUCT_TREESAMPLER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "scip/def.h"
+#include "struct_aiowriter.h"
+
+#define SCIP_TREESAMPLER_NDEPTHBINS   16   /**< number of bins of the open-node depth histogram */
+
+/** open-node queue sampler
+ *
+ * A sample walks all open nodes, so it is only taken every freq selections or every interval seconds.
+ */
+struct SCIP_TreeSampler
+{
+   SCIP_AIOWRITER* writer;
+   int            freq;               /**< sample every freq selections (0: never by count) */
+   SCIP_Real      interval;           /**< sample every interval seconds of wall clock time (0: never by time) */
+   int            binwidth;           /**< depth range of one histogram bin; the last bin takes all deeper nodes */
+   SCIP_Longint   nselects;           /**< number of selections seen */
+   SCIP_Longint   lastsample;         /**< monotonic clock time of the last sample in nanoseconds */
+   SCIP_Longint   nsamples;           /**< number of samples written */
+};
+typedef struct SCIP_TreeSampler SCIP_TREESAMPLER;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
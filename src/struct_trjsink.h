@@ -0,0 +1,86 @@
+/**@file   struct_trjsink.h
+ * @brief  data structures for trajectory sinks
+ *
+ *  This file defines the trajectory sink used by node selectors to write ranking groups.
+ *
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_STRUCT_TRJSINK_H__
+#define __SCIP_STRUCT_TRJSINK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include "scip/def.h"
+#include "struct_aiowriter.h"
+
+/** a buffered group kept by the sampler */
+struct SCIP_TrjGroup
+{
+   int*           nodes;              /**< node numbers */
+   SCIP_Real*     rows;               /**< rows of features, label, weight, depth bucket and boundtype */
+   SCIP_Real*     globalvals;         /**< group-wide feature values */
+   int            nnodes;
+   int            groupidx;
+};
+typedef struct SCIP_TrjGroup SCIP_TRJGROUP;
+
+/** reservoir of buffered groups */
+struct SCIP_TrjReservoir
+{
+   SCIP_TRJGROUP** groups;
+   int            ngroups;
+   int            groupssize;
+   int            maxgroups;          /**< budget (0: keep all, written as they end instead of buffered) */
+   SCIP_Longint   nseen;              /**< number of groups offered to the reservoir */
+};
+typedef struct SCIP_TrjReservoir SCIP_TRJRESERVOIR;
+
+/** trajectory sink for priority-queue groups
+ *
+ * In dedup mode, each node's local feature row is written once when it first appears or changes ("n" lines);
+ * a group ("g" line) only holds the group-wide feature values and the numbers of the nodes in the queue.
+ *
+ * If a group budget is set, groups are sampled at write time: groups containing an optimal node and pure-negative
+ * groups go to separate reservoirs, pure-negative groups are additionally thinned at a fixed rate, and the kept
+ * groups are written in group order when the sink is closed.
+ */
+struct SCIP_TrjSink
+{
+   FILE*          file;               /**< output file (NULL if the asynchronous writer is used) */
+   SCIP_AIOWRITER* writer;            /**< asynchronous writer, or NULL */
+   uint64_t*      rowhashes;          /**< hash of the last written row, indexed by node number (0: not written) */
+   int            rowhashessize;
+   int*           groupnodes;         /**< numbers of the nodes in the current group */
+   SCIP_Real*     grouprows;          /**< rows of the nodes in the current group (features and example metadata) */
+   int            ngroupnodes;
+   int            groupnodessize;
+   SCIP_Bool      grouphasopt;        /**< does the current group contain an optimal node? */
+   SCIP_Real*     globalvals;         /**< group-wide feature values of the current group */
+   SCIP_Bool*     isglobal;           /**< is the feature shared by all nodes of a group? */
+   int            size;               /**< feature size */
+   int            groupidx;           /**< index of the current group */
+   SCIP_Bool      dedup;              /**< write node-deduplicated groups instead of one row per node and group */
+   SCIP_Bool      sampling;           /**< are the groups of a class with a budget buffered until the sink is closed? */
+   SCIP_Real      negrate;            /**< rate at which pure-negative groups are kept */
+   unsigned int   randseed;
+   SCIP_TRJRESERVOIR pos;             /**< groups containing an optimal node */
+   SCIP_TRJRESERVOIR neg;             /**< pure-negative groups */
+   SCIP_Longint   ngroups;            /**< number of groups offered to the sink */
+   SCIP_Longint   nwrittengroups;     /**< number of groups written */
+   SCIP_Longint   nrows;              /**< number of node rows written */
+   SCIP_Longint   nrefs;              /**< number of node references in written groups */
+   SCIP_Longint   nbytes;             /**< number of bytes printed to the file (the asynchronous writer counts its own) */
+};
+typedef struct SCIP_TrjSink SCIP_TRJSINK;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
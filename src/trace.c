@@ -0,0 +1,184 @@
+/**@file   trace.c
+ * @brief  methods for runtime tracing of node selectors
+ *
+ * Every node selection is recorded into a fixed-size ring buffer (a few stores, no formatting); the buffer is only
+ * formatted when it is dumped at exit or after an error.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <string.h>
+#include "scip/def.h"
+#include "profile.h"
+#include "trace.h"
+
+/** live traces, dumped together by SCIPtraceDumpAll() */
+static SCIP_TRACE* livetraces = NULL;
+
+/** create a trace and register it for SCIPtraceDumpAll() */
+SCIP_RETCODE SCIPtraceCreate(
+   SCIP*              scip,
+   SCIP_TRACE**       trace,
+   const char*        name,
+   int                level,
+   int                ringsize
+   )
+{
+   assert(scip != NULL);
+   assert(trace != NULL);
+   assert(name != NULL);
+   assert(ringsize >= 0);
+
+   SCIP_CALL( SCIPallocBlockMemory(scip, trace) );
+   (*trace)->ring = NULL;
+   (*trace)->ringsize = ringsize;
+   (*trace)->nevents = 0;
+   (*trace)->start = SCIPprofileStart();
+   (*trace)->level = level;
+   (void) SCIPsnprintf((*trace)->name, (int)sizeof((*trace)->name), "%s", name);
+
+   if( ringsize > 0 )
+   {
+      SCIP_ALLOC( BMSallocMemoryArray(&(*trace)->ring, ringsize) );
+   }
+
+   (*trace)->next = livetraces;
+   livetraces = *trace;
+
+   return SCIP_OKAY;
+}
+
+/** unregister and free a trace */
+SCIP_RETCODE SCIPtraceFree(
+   SCIP*              scip,
+   SCIP_TRACE**       trace
+   )
+{
+   SCIP_TRACE** prev;
+
+   assert(scip != NULL);
+   assert(trace != NULL);
+   assert(*trace != NULL);
+
+   for( prev = &livetraces; *prev != NULL; prev = &(*prev)->next )
+   {
+      if( *prev == *trace )
+      {
+         *prev = (*trace)->next;
+         break;
+      }
+   }
+
+   BMSfreeMemoryArrayNull(&(*trace)->ring);
+   SCIPfreeBlockMemory(scip, trace);
+
+   return SCIP_OKAY;
+}
+
+/** record an event in the ring buffer */
+void SCIPtraceRecordEvent(
+   SCIP_TRACE*        trace,
+   SCIP_TRACEEVTTYPE  type,
+   SCIP_Longint       node,
+   int                ival,
+   SCIP_Real          v0,
+   SCIP_Real          v1,
+   SCIP_Real          v2,
+   SCIP_Real          v3
+   )
+{
+   SCIP_TRACEEVENT* evt;
+
+   assert(trace != NULL);
+   assert(trace->ring != NULL);
+
+   evt = &trace->ring[trace->nevents % trace->ringsize];
+   evt->time = SCIPprofileStart() - trace->start;
+   evt->node = node;
+   evt->vals[0] = v0;
+   evt->vals[1] = v1;
+   evt->vals[2] = v2;
+   evt->vals[3] = v3;
+   evt->ival = ival;
+   evt->type = (int)type;
+
+   trace->nevents++;
+}
+
+/** print the events in the ring buffer, oldest first */
+void SCIPtraceDump(
+   SCIP_TRACE*        trace,
+   FILE*              file
+   )
+{
+   SCIP_TRACEEVENT* evt;
+   SCIP_Longint first;
+   SCIP_Longint e;
+
+   assert(trace != NULL);
+
+   if( file == NULL )
+      file = stdout;
+
+   if( trace->ring == NULL )
+      return;
+
+   first = MAX(0, trace->nevents - trace->ringsize);
+   fprintf(file, "trace %s: events %"SCIP_LONGINT_FORMAT"-%"SCIP_LONGINT_FORMAT" of %"SCIP_LONGINT_FORMAT"\n",
+      trace->name, first, trace->nevents - 1, trace->nevents);
+
+   for( e = first; e < trace->nevents; e++ )
+   {
+      evt = &trace->ring[e % trace->ringsize];
+      switch( evt->type )
+      {
+      case SCIP_TRACEEVT_SELECT:
+         fprintf(file, "%12.6f select node %"SCIP_LONGINT_FORMAT" lowerbound %.3f primalbound %.3f dualbound %.3f score %.3f left %d\n",
+            evt->time / 1e9, evt->node, evt->vals[0], evt->vals[1], evt->vals[2], evt->vals[3], evt->ival);
+         break;
+      case SCIP_TRACEEVT_NODE:
+         fprintf(file, "%12.6f node %"SCIP_LONGINT_FORMAT" lowerbound %.3f score %.3f depth %d opt %d\n",
+            evt->time / 1e9, evt->node, evt->vals[0], evt->vals[1], (int)evt->vals[2], evt->ival);
+         break;
+      default:
+         fprintf(file, "%12.6f event %d\n", evt->time / 1e9, evt->type);
+         break;
+      }
+   }
+}
+
+/** write the ring buffer to a file, overwriting it */
+SCIP_RETCODE SCIPtraceDumpFile(
+   SCIP_TRACE*        trace,
+   const char*        fname
+   )
+{
+   FILE* file;
+
+   assert(trace != NULL);
+   assert(fname != NULL);
+
+   file = fopen(fname, "w");
+   if( file == NULL )
+   {
+      SCIPerrorMessage("cannot open trace file <%s> for writing\n", fname);
+      SCIPprintSysError(fname);
+      return SCIP_NOFILE;
+   }
+
+   SCIPtraceDump(trace, file);
+   fclose(file);
+
+   return SCIP_OKAY;
+}
+
+/** print the ring buffers of all live traces */
+void SCIPtraceDumpAll(
+   FILE*              file
+   )
+{
+   SCIP_TRACE* trace;
+
+   for( trace = livetraces; trace != NULL; trace = trace->next )
+      SCIPtraceDump(trace, file);
+}
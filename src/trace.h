@@ -0,0 +1,89 @@
+/**@file   trace.h
+ * @brief  internal methods for runtime tracing of node selectors
+ *
+ * Text trace points are guarded by SCIPtraceIsOn(), a single compare against the runtime trace level; compiling with
+ * -DSCIP_NOTRACE removes them together with the ring buffer records.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_TRACE_H__
+#define __SCIP_TRACE_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SCIP_NOTRACE
+#define SCIPtraceIsOn(trace, lvl)         FALSE
+#define SCIPtraceRecord(trace, type, node, ival, v0, v1, v2, v3)  do { } while( FALSE )
+#else
+/** should trace points of the given level be written to the text log? */
+#define SCIPtraceIsOn(trace, lvl)         ((trace) != NULL && (trace)->level >= (lvl))
+/** record an event in the ring buffer */
+#define SCIPtraceRecord(trace, type, node, ival, v0, v1, v2, v3)  do { if( (trace) != NULL && (trace)->ring != NULL ) \
+         SCIPtraceRecordEvent(trace, type, node, ival, v0, v1, v2, v3); } while( FALSE )
+#endif
+
+/** prints a trace line to stdout, prefixed like SCIPdebugMessage() so that the log parsers keep working */
+#define SCIPtraceMessage                  printf("[%s:%d] debug: ", __FILE__, __LINE__), printf
+
+/** create a trace and register it for SCIPtraceDumpAll() */
+extern
+SCIP_RETCODE SCIPtraceCreate(
+   SCIP*              scip,
+   SCIP_TRACE**       trace,
+   const char*        name,               /**< name of the traced plugin */
+   int                level,              /**< trace level of the text log */
+   int                ringsize            /**< number of recent events kept (0: no ring buffer) */
+   );
+
+/** unregister and free a trace */
+extern
+SCIP_RETCODE SCIPtraceFree(
+   SCIP*              scip,
+   SCIP_TRACE**       trace
+   );
+
+/** record an event in the ring buffer; use the SCIPtraceRecord() macro */
+extern
+void SCIPtraceRecordEvent(
+   SCIP_TRACE*        trace,
+   SCIP_TRACEEVTTYPE  type,
+   SCIP_Longint       node,
+   int                ival,
+   SCIP_Real          v0,
+   SCIP_Real          v1,
+   SCIP_Real          v2,
+   SCIP_Real          v3
+   );
+
+/** print the events in the ring buffer, oldest first */
+extern
+void SCIPtraceDump(
+   SCIP_TRACE*        trace,
+   FILE*              file
+   );
+
+/** write the ring buffer to a file, overwriting it */
+extern
+SCIP_RETCODE SCIPtraceDumpFile(
+   SCIP_TRACE*        trace,
+   const char*        fname
+   );
+
+/** print the ring buffers of all live traces; called on errors */
+extern
+void SCIPtraceDumpAll(
+   FILE*              file
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
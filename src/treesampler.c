@@ -0,0 +1,223 @@
+/**@file   treesampler.c
+ * @brief  methods for sampling the shape of the open-node queue
+ *
+ * Binary format (little-endian, no padding), read by scripts/treesampler.py:
+ *
+ *   "TSMP" version(u32) nbins(u32) binwidth(u32)                     file header
+ *   'T' time(f64) nselects(i64) nnodes(i64) nleaves(i32) nchildren(i32) nsiblings(i32) plungedepth(i32)
+ *       maxdepth(i32) minlb(f64) meanlb(f64) maxlb(f64) primalbound(f64) dualbound(f64) memused(i64)
+ *       depthhist[nbins](i32)                                         sample of the open nodes
+ *
+ * time is the solving time; maxdepth and the lower-bound statistics are taken over all open nodes (0 if there are
+ * none). Bin i of the depth histogram counts open nodes with depth in [i * binwidth, (i+1) * binwidth), the last
+ * bin also counts all deeper nodes. memused is the memory used by SCIP as a whole, which is dominated by the tree
+ * in long runs; SCIP does not account the tree separately.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <stdint.h>
+#include <string.h>
+#include "scip/def.h"
+#include "aiowriter.h"
+#include "profile.h"
+#include "treesampler.h"
+
+#define TREESAMPLER_MAGIC      "TSMP"
+#define TREESAMPLER_VERSION    1
+
+#define TREESAMPLER_SAMPLE     'T'
+
+#define TREESAMPLER_MAXRECORD  (128 + 4 * SCIP_TREESAMPLER_NDEPTHBINS)  /**< upper bound on the size of a sample */
+
+/** append a value to a record buffer */
+#define putValue(buf, pos, type, val)  do { type putval_ = (val); memcpy(&(buf)[pos], &putval_, sizeof(type)); \
+      (pos) += (int)sizeof(type); } while( FALSE )
+
+/** open-node statistics of one sample */
+struct OpenStats
+{
+   int                depthhist[SCIP_TREESAMPLER_NDEPTHBINS];
+   int                maxdepth;
+   SCIP_Real          minlb;
+   SCIP_Real          sumlb;
+   SCIP_Real          maxlb;
+   int                nnodes;
+};
+
+/** add the open nodes of one queue to the statistics */
+static
+void addNodes(
+   SCIP_TREESAMPLER*  sampler,
+   struct OpenStats*  stats,
+   SCIP_NODE**        nodes,
+   int                nnodes
+   )
+{
+   SCIP_Real lb;
+   int depth;
+   int bin;
+   int i;
+
+   for( i = 0; i < nnodes; i++ )
+   {
+      depth = SCIPnodeGetDepth(nodes[i]);
+      bin = MIN(depth / sampler->binwidth, SCIP_TREESAMPLER_NDEPTHBINS - 1);
+      stats->depthhist[bin]++;
+      stats->maxdepth = MAX(stats->maxdepth, depth);
+
+      lb = SCIPnodeGetLowerbound(nodes[i]);
+      stats->minlb = MIN(stats->minlb, lb);
+      stats->maxlb = MAX(stats->maxlb, lb);
+      stats->sumlb += lb;
+   }
+   stats->nnodes += nnodes;
+}
+
+/** write a sample of the open nodes */
+static
+SCIP_RETCODE writeSample(
+   SCIP*              scip,
+   SCIP_TREESAMPLER*  sampler
+   )
+{
+   char buf[TREESAMPLER_MAXRECORD];
+   struct OpenStats stats;
+   SCIP_NODE** leaves;
+   SCIP_NODE** children;
+   SCIP_NODE** siblings;
+   int nleaves;
+   int nchildren;
+   int nsiblings;
+   int pos = 0;
+   int b;
+
+   SCIP_CALL( SCIPgetOpenNodesData(scip, &leaves, &children, &siblings, &nleaves, &nchildren, &nsiblings) );
+
+   BMSclearMemory(&stats);
+   stats.minlb = SCIPinfinity(scip);
+   stats.maxlb = -SCIPinfinity(scip);
+   addNodes(sampler, &stats, leaves, nleaves);
+   addNodes(sampler, &stats, children, nchildren);
+   addNodes(sampler, &stats, siblings, nsiblings);
+   if( stats.nnodes == 0 )
+   {
+      stats.minlb = 0.0;
+      stats.maxlb = 0.0;
+   }
+
+   buf[pos++] = TREESAMPLER_SAMPLE;
+   putValue(buf, pos, double, SCIPgetSolvingTime(scip));
+   putValue(buf, pos, int64_t, sampler->nselects);
+   putValue(buf, pos, int64_t, SCIPgetNNodes(scip));
+   putValue(buf, pos, int32_t, nleaves);
+   putValue(buf, pos, int32_t, nchildren);
+   putValue(buf, pos, int32_t, nsiblings);
+   putValue(buf, pos, int32_t, SCIPgetPlungeDepth(scip));
+   putValue(buf, pos, int32_t, stats.maxdepth);
+   putValue(buf, pos, double, stats.minlb);
+   putValue(buf, pos, double, stats.nnodes > 0 ? stats.sumlb / stats.nnodes : 0.0);
+   putValue(buf, pos, double, stats.maxlb);
+   putValue(buf, pos, double, SCIPgetPrimalbound(scip));
+   putValue(buf, pos, double, SCIPgetDualbound(scip));
+   putValue(buf, pos, int64_t, SCIPgetMemUsed(scip));
+   for( b = 0; b < SCIP_TREESAMPLER_NDEPTHBINS; b++ )
+      putValue(buf, pos, int32_t, stats.depthhist[b]);
+   assert(pos <= TREESAMPLER_MAXRECORD);
+   SCIPaiowriterWrite(sampler->writer, buf, pos);
+
+   sampler->nsamples++;
+
+   return SCIP_OKAY;
+}
+
+/** open a sampler, overwriting the given file */
+SCIP_RETCODE SCIPtreesamplerCreate(
+   SCIP*              scip,
+   SCIP_TREESAMPLER** sampler,
+   const char*        fname,
+   int                freq,
+   SCIP_Real          interval
+   )
+{
+   char buf[16];
+   int maxdepth;
+   int pos = 0;
+
+   assert(scip != NULL);
+   assert(sampler != NULL);
+   assert(fname != NULL);
+   assert(freq >= 0);
+   assert(interval >= 0.0);
+
+   /* spread the depths a pure branching tree can reach over the bins */
+   maxdepth = SCIPgetNBinVars(scip) + SCIPgetNIntVars(scip);
+
+   SCIP_CALL( SCIPallocBlockMemory(scip, sampler) );
+   (*sampler)->freq = freq;
+   (*sampler)->interval = interval;
+   (*sampler)->binwidth = MAX(1, (maxdepth + SCIP_TREESAMPLER_NDEPTHBINS - 1) / SCIP_TREESAMPLER_NDEPTHBINS);
+   (*sampler)->nselects = 0;
+   (*sampler)->lastsample = SCIPprofileStart();
+   (*sampler)->nsamples = 0;
+
+   SCIP_CALL( SCIPaiowriterCreate(&(*sampler)->writer, fname, FALSE, TRUE) );
+
+   memcpy(buf, TREESAMPLER_MAGIC, 4);
+   pos = 4;
+   putValue(buf, pos, uint32_t, TREESAMPLER_VERSION);
+   putValue(buf, pos, uint32_t, SCIP_TREESAMPLER_NDEPTHBINS);
+   putValue(buf, pos, uint32_t, (uint32_t)(*sampler)->binwidth);
+   SCIPaiowriterWrite((*sampler)->writer, buf, pos);
+
+   return SCIP_OKAY;
+}
+
+/** write the remaining samples and close the sampler */
+SCIP_RETCODE SCIPtreesamplerFree(
+   SCIP*              scip,
+   SCIP_TREESAMPLER** sampler
+   )
+{
+   assert(scip != NULL);
+   assert(sampler != NULL);
+   assert(*sampler != NULL);
+
+   SCIPdebugMessage("tree sampler: %"SCIP_LONGINT_FORMAT" samples of %"SCIP_LONGINT_FORMAT" selections\n",
+      (*sampler)->nsamples, (*sampler)->nselects);
+
+   SCIP_CALL( SCIPaiowriterFree(&(*sampler)->writer) );
+   SCIPfreeBlockMemory(scip, sampler);
+
+   return SCIP_OKAY;
+}
+
+/** count a node selection and write a sample of the open nodes if one is due */
+SCIP_RETCODE SCIPtreesamplerSelect(
+   SCIP*              scip,
+   SCIP_TREESAMPLER*  sampler
+   )
+{
+   SCIP_Longint now;
+   SCIP_Bool due;
+
+   assert(scip != NULL);
+   assert(sampler != NULL);
+
+   sampler->nselects++;
+
+   due = (sampler->freq > 0 && sampler->nselects % sampler->freq == 0);
+   now = 0;
+   if( sampler->interval > 0.0 )
+   {
+      now = SCIPprofileStart();
+      due = due || (now - sampler->lastsample >= (SCIP_Longint)(sampler->interval * 1e9));
+   }
+   if( !due )
+      return SCIP_OKAY;
+
+   SCIP_CALL( writeSample(scip, sampler) );
+   sampler->lastsample = (now != 0 ? now : SCIPprofileStart());
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,46 @@
+/**@file   treesampler.h
+ * @brief  internal methods for sampling the shape of the open-node queue
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_TREESAMPLER_H__
+#define __SCIP_TREESAMPLER_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "struct_treesampler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** open a sampler, overwriting the given file */
+extern
+SCIP_RETCODE SCIPtreesamplerCreate(
+   SCIP*              scip,
+   SCIP_TREESAMPLER** sampler,
+   const char*        fname,
+   int                freq,               /**< sample every freq selections (0: never by count) */
+   SCIP_Real          interval            /**< sample every interval seconds (0: never by time) */
+   );
+
+/** write the remaining samples and close the sampler */
+extern
+SCIP_RETCODE SCIPtreesamplerFree(
+   SCIP*              scip,
+   SCIP_TREESAMPLER** sampler
+   );
+
+/** count a node selection and write a sample of the open nodes if one is due; call before selecting the node */
+extern
+SCIP_RETCODE SCIPtreesamplerSelect(
+   SCIP*              scip,
+   SCIP_TREESAMPLER*  sampler
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,629 @@
+/**@file   trjsink.c
+ * @brief  methods for trajectory sinks
+ *
+ * Dedup format (one record per line):
+ *
+ *   h <size> <global feature indices>            header, written when the sink is opened
+ *   n <node idx> <label> <weight> <depth bucket> <boundtype> <local feature values>
+ *                                                node row, written when the node appears or its row changes
+ *   g <group idx> <global feature values> | <node idx> ...
+ *
+ * Local feature values are the non-global features in index order. Without dedup, each node of a group is written
+ * as one example record "<label> w:<weight> d:<depth bucket> b:<boundtype> 1:<node idx> 2:<group idx> 3:<feature> ...".
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <stdarg.h>
+#include <string.h>
+#include "scip/def.h"
+#include "scip/pub_misc.h"
+#include "feat.h"
+#include "struct_feat.h"
+#include "aiowriter.h"
+#include "trjsink.h"
+#include "memacct.h"
+#include "profile.h"
+#include "chrometrace.h"
+
+#define FNV_OFFSET      14695981039346656037ULL
+#define FNV_PRIME       1099511628211ULL
+
+/* each buffered row holds the features followed by label, weight, depth bucket and boundtype */
+#define ROW_LABEL       0
+#define ROW_WEIGHT      1
+#define ROW_DEPTHBUCKET 2
+#define ROW_BOUNDTYPE   3
+#define ROW_NMETA       4
+#define rowSize(sink)   ((sink)->size + ROW_NMETA)
+
+/* bytes held by a buffered group of n nodes */
+#define groupBytes(sink, n) (sizeof(SCIP_TRJGROUP) + (size_t)(n) * (sizeof(int) + rowSize(sink) * sizeof(SCIP_Real)) \
+      + (size_t)(sink)->size * sizeof(SCIP_Real))
+
+/** features which only depend on the global solving state and are identical for all nodes of a group */
+static const int nodeselglobalfeats[] = {
+   SCIP_FEATNODESEL_GLOBALUPPERBOUND,
+   SCIP_FEATNODESEL_GAP,
+   SCIP_FEATNODESEL_GAPINF,
+   SCIP_FEATNODESEL_GLOBALUPPERBOUNDINF,
+   SCIP_FEATNODESEL_PLUNGEDEPTH
+};
+
+/** print to the sink's file or asynchronous writer */
+static
+void sinkPrintf(
+   SCIP_TRJSINK*      sink,
+   const char*        formatstr,
+   ...
+   )
+{
+   va_list ap;
+   int n;
+
+   va_start(ap, formatstr);
+   if( sink->writer != NULL )
+      SCIPaiowriterVPrintf(sink->writer, formatstr, ap);
+   else
+   {
+      n = vfprintf(sink->file, formatstr, ap);
+      if( n > 0 )
+         sink->nbytes += n;
+   }
+   va_end(ap);
+}
+
+/** hash the local part of a row */
+static
+uint64_t hashRow(
+   SCIP_TRJSINK*      sink,
+   SCIP_Real*         vals
+   )
+{
+   const unsigned char* bytes;
+   uint64_t hash = FNV_OFFSET;
+   int i;
+   int b;
+
+   for( i = 0; i < rowSize(sink); i++ )
+   {
+      if( i < sink->size && sink->isglobal[i] )
+         continue;
+      bytes = (const unsigned char*)&vals[i];
+      for( b = 0; b < (int)sizeof(SCIP_Real); b++ )
+      {
+         hash ^= bytes[b];
+         hash *= FNV_PRIME;
+      }
+   }
+
+   /* 0 marks rows that have not been written */
+   return hash == 0 ? 1 : hash;
+}
+
+/** ensure the row hash array can be indexed by nodeidx */
+static
+SCIP_RETCODE ensureRowhashesSize(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   int                nodeidx
+   )
+{
+   if( nodeidx >= sink->rowhashessize )
+   {
+      int newsize = SCIPcalcMemGrowSize(scip, nodeidx + 1);
+
+      SCIP_ALLOC( BMSreallocMemoryArray(&sink->rowhashes, newsize) );
+      SCIPmemacctRealloc(SCIP_MEMCOMP_NODEDATA, (size_t)sink->rowhashessize * sizeof(uint64_t),
+         (size_t)newsize * sizeof(uint64_t));
+      BMSclearMemoryArray(&sink->rowhashes[sink->rowhashessize], newsize - sink->rowhashessize);
+      sink->rowhashessize = newsize;
+   }
+
+   return SCIP_OKAY;
+}
+
+/** write one group in the sink's format */
+static
+SCIP_RETCODE writeGroup(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   int                groupidx,
+   int*               nodes,
+   SCIP_Real*         rows,
+   SCIP_Real*         globalvals,
+   int                nnodes
+   )
+{
+   SCIP_Real* row;
+   SCIP_Real* meta;
+   uint64_t hash;
+   int i;
+   int j;
+
+   sink->nwrittengroups++;
+   sink->nrefs += nnodes;
+
+   if( !sink->dedup )
+   {
+      /* one example per node and group: 1:node idx 2:group idx 3..:features */
+      for( i = 0; i < nnodes; i++ )
+      {
+         row = &rows[i * rowSize(sink)];
+         meta = &row[sink->size];
+         sinkPrintf(sink, "%d w:%f d:%d b:%d ", (int)meta[ROW_LABEL], meta[ROW_WEIGHT],
+            (int)meta[ROW_DEPTHBUCKET], (int)meta[ROW_BOUNDTYPE]);
+         sinkPrintf(sink, "%d:%d %d:%d ", 1, nodes[i], 2, groupidx);
+         for( j = 0; j < sink->size; j++ )
+            sinkPrintf(sink, "%d:%f ", j + 3, row[j]);
+         sinkPrintf(sink, "\n");
+      }
+      sink->nrows += nnodes;
+
+      return SCIP_OKAY;
+   }
+
+   /* write the node rows that are new or have changed since they were last written */
+   for( i = 0; i < nnodes; i++ )
+   {
+      row = &rows[i * rowSize(sink)];
+      meta = &row[sink->size];
+
+      /* over the soft cap the hash table is not grown; rows of nodes beyond it are written every time */
+      if( nodes[i] >= sink->rowhashessize && SCIPmemacctIsOverCap() )
+         SCIPmemacctShed(SCIP_MEMCOMP_NODEDATA);
+      else
+      {
+         SCIP_CALL( ensureRowhashesSize(scip, sink, nodes[i]) );
+         hash = hashRow(sink, row);
+         if( sink->rowhashes[nodes[i]] == hash )
+            continue;
+
+         sink->rowhashes[nodes[i]] = hash;
+      }
+      sink->nrows++;
+
+      sinkPrintf(sink, "n %d %d %f %d %d", nodes[i], (int)meta[ROW_LABEL], meta[ROW_WEIGHT],
+         (int)meta[ROW_DEPTHBUCKET], (int)meta[ROW_BOUNDTYPE]);
+      for( j = 0; j < sink->size; j++ )
+      {
+         if( !sink->isglobal[j] )
+            sinkPrintf(sink, " %f", row[j]);
+      }
+      sinkPrintf(sink, "\n");
+   }
+
+   sinkPrintf(sink, "g %d", groupidx);
+   for( j = 0; j < sink->size; j++ )
+   {
+      if( sink->isglobal[j] )
+         sinkPrintf(sink, " %f", globalvals[j]);
+   }
+   sinkPrintf(sink, " |");
+   for( i = 0; i < nnodes; i++ )
+      sinkPrintf(sink, " %d", nodes[i]);
+   sinkPrintf(sink, "\n");
+
+   return SCIP_OKAY;
+}
+
+/** copy the current group into a buffered group */
+static
+SCIP_RETCODE groupCreate(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   SCIP_TRJGROUP**    group
+   )
+{
+   int n = sink->ngroupnodes;
+
+   SCIP_CALL( SCIPallocBlockMemory(scip, group) );
+   SCIP_ALLOC( BMSduplicateMemoryArray(&(*group)->nodes, sink->groupnodes, n) );
+   SCIP_ALLOC( BMSduplicateMemoryArray(&(*group)->rows, sink->grouprows, n * rowSize(sink)) );
+   SCIP_ALLOC( BMSduplicateMemoryArray(&(*group)->globalvals, sink->globalvals, sink->size) );
+   (*group)->nnodes = n;
+   (*group)->groupidx = sink->groupidx;
+   SCIPmemacctAlloc(SCIP_MEMCOMP_TRJ, groupBytes(sink, n));
+
+   return SCIP_OKAY;
+}
+
+/** free a buffered group */
+static
+void groupFree(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   SCIP_TRJGROUP**    group
+   )
+{
+   SCIPmemacctFree(SCIP_MEMCOMP_TRJ, groupBytes(sink, (*group)->nnodes));
+   BMSfreeMemoryArray(&(*group)->nodes);
+   BMSfreeMemoryArray(&(*group)->rows);
+   BMSfreeMemoryArray(&(*group)->globalvals);
+   SCIPfreeBlockMemory(scip, group);
+}
+
+/** offer the current group to a reservoir with a budget (algorithm R) */
+static
+SCIP_RETCODE reservoirOffer(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   SCIP_TRJRESERVOIR* reservoir
+   )
+{
+   int slot;
+
+   assert(reservoir->maxgroups > 0);
+   assert(reservoir->groupssize == reservoir->maxgroups);
+
+   reservoir->nseen++;
+
+   if( reservoir->ngroups < reservoir->maxgroups )
+   {
+      /* over the soft cap the reservoir does not grow; groups with an optimal node are written right away instead of
+       * being dropped, even if that writes more of them than the budget
+       */
+      if( SCIPmemacctIsOverCap() )
+      {
+         if( reservoir == &sink->pos )
+         {
+            SCIP_CALL( writeGroup(scip, sink, sink->groupidx, sink->groupnodes, sink->grouprows, sink->globalvals,
+                  sink->ngroupnodes) );
+         }
+         else
+            SCIPmemacctShed(SCIP_MEMCOMP_TRJ);
+         return SCIP_OKAY;
+      }
+
+      SCIP_CALL( groupCreate(scip, sink, &reservoir->groups[reservoir->ngroups]) );
+      reservoir->ngroups++;
+
+      return SCIP_OKAY;
+   }
+
+   /* replace a random slot with probability maxgroups / nseen */
+   slot = (int)(SCIPgetRandomReal(0.0, 1.0, &sink->randseed) * (SCIP_Real)reservoir->nseen);
+   if( slot < reservoir->maxgroups )
+   {
+      groupFree(scip, sink, &reservoir->groups[slot]);
+      SCIP_CALL( groupCreate(scip, sink, &reservoir->groups[slot]) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** compare buffered groups by group index */
+static
+SCIP_DECL_SORTPTRCOMP(groupComp)
+{
+   return ((SCIP_TRJGROUP*)elem1)->groupidx - ((SCIP_TRJGROUP*)elem2)->groupidx;
+}
+
+/** write all buffered groups in group order */
+static
+SCIP_RETCODE flushReservoirs(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink
+   )
+{
+   SCIP_TRJGROUP** groups;
+   int ngroups;
+   int i;
+
+   ngroups = sink->pos.ngroups + sink->neg.ngroups;
+   if( ngroups == 0 )
+      return SCIP_OKAY;
+
+   SCIP_CALL( SCIPallocBufferArray(scip, &groups, ngroups) );
+   for( i = 0; i < sink->pos.ngroups; i++ )
+      groups[i] = sink->pos.groups[i];
+   for( i = 0; i < sink->neg.ngroups; i++ )
+      groups[sink->pos.ngroups + i] = sink->neg.groups[i];
+
+   SCIPsortPtr((void**)groups, groupComp, ngroups);
+
+   for( i = 0; i < ngroups; i++ )
+   {
+      SCIP_CALL( writeGroup(scip, sink, groups[i]->groupidx, groups[i]->nodes, groups[i]->rows, groups[i]->globalvals,
+            groups[i]->nnodes) );
+      groupFree(scip, sink, &groups[i]);
+   }
+   sink->pos.ngroups = 0;
+   sink->neg.ngroups = 0;
+
+   SCIPfreeBufferArray(scip, &groups);
+
+   return SCIP_OKAY;
+}
+
+/** open a trajectory sink appending to the given file */
+SCIP_RETCODE SCIPtrjsinkCreate(
+   SCIP*              scip,
+   SCIP_TRJSINK**     sink,
+   const char*        fname,
+   int                size,
+   SCIP_Bool          dedup,
+   SCIP_Bool          useaio
+   )
+{
+   SCIP_RETCODE retcode;
+   int i;
+
+   assert(scip != NULL);
+   assert(sink != NULL);
+   assert(fname != NULL);
+
+   SCIP_CALL( SCIPallocBlockMemory(scip, sink) );
+
+   (*sink)->file = NULL;
+   (*sink)->writer = NULL;
+   if( useaio )
+   {
+      retcode = SCIPaiowriterCreate(&(*sink)->writer, fname, TRUE, TRUE);
+      if( retcode != SCIP_OKAY )
+      {
+         SCIPfreeBlockMemory(scip, sink);
+         return retcode;
+      }
+   }
+   else if( ((*sink)->file = fopen(fname, "a")) == NULL )
+   {
+      SCIPerrorMessage("cannot open trajectory file <%s> for writing\n", fname);
+      SCIPprintSysError(fname);
+      SCIPfreeBlockMemory(scip, sink);
+      return SCIP_NOFILE;
+   }
+
+   (*sink)->size = size;
+   (*sink)->dedup = dedup;
+   (*sink)->groupidx = -1;
+   (*sink)->rowhashes = NULL;
+   (*sink)->rowhashessize = 0;
+   (*sink)->groupnodes = NULL;
+   (*sink)->grouprows = NULL;
+   (*sink)->ngroupnodes = 0;
+   (*sink)->groupnodessize = 0;
+   (*sink)->grouphasopt = FALSE;
+   (*sink)->sampling = FALSE;
+   (*sink)->negrate = 1.0;
+   (*sink)->randseed = 0;
+   BMSclearMemory(&(*sink)->pos);
+   BMSclearMemory(&(*sink)->neg);
+   (*sink)->ngroups = 0;
+   (*sink)->nwrittengroups = 0;
+   (*sink)->nrows = 0;
+   (*sink)->nrefs = 0;
+   (*sink)->nbytes = 0;
+
+   SCIP_ALLOC( BMSallocMemoryArray(&(*sink)->globalvals, size) );
+   SCIP_ALLOC( BMSallocMemoryArray(&(*sink)->isglobal, size) );
+   SCIPmemacctAlloc(SCIP_MEMCOMP_TRJ, sizeof(SCIP_TRJSINK) + (size_t)size * (sizeof(SCIP_Real) + sizeof(SCIP_Bool)));
+   if( (*sink)->writer != NULL )
+      SCIPmemacctAlloc(SCIP_MEMCOMP_TRJ, (size_t)(*sink)->writer->nbuffers * (size_t)(*sink)->writer->buffersize);
+   for( i = 0; i < size; i++ )
+   {
+      (*sink)->globalvals[i] = 0.0;
+      (*sink)->isglobal[i] = FALSE;
+   }
+
+   /* only the node selection features have a known group-wide part */
+   if( size == SCIP_FEATNODESEL_SIZE )
+   {
+      for( i = 0; i < (int)(sizeof(nodeselglobalfeats) / sizeof(nodeselglobalfeats[0])); i++ )
+         (*sink)->isglobal[nodeselglobalfeats[i]] = TRUE;
+   }
+
+   if( dedup )
+   {
+      sinkPrintf(*sink, "h %d", size);
+      for( i = 0; i < size; i++ )
+      {
+         if( (*sink)->isglobal[i] )
+            sinkPrintf(*sink, " %d", i);
+      }
+      sinkPrintf(*sink, "\n");
+   }
+
+   return SCIP_OKAY;
+}
+
+/** set the group sampling of the sink; groups of a class with a budget are buffered and written on close */
+SCIP_RETCODE SCIPtrjsinkSetSampling(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   int                maxposgroups,
+   int                maxneggroups,
+   SCIP_Real          negrate,
+   unsigned int       randseed
+   )
+{
+   assert(scip != NULL);
+   assert(sink != NULL);
+   assert(sink->ngroups == 0);
+   assert(maxposgroups >= 0 && maxneggroups >= 0);
+   assert(negrate >= 0.0 && negrate <= 1.0);
+
+   sink->sampling = (maxposgroups > 0 || maxneggroups > 0);
+   sink->negrate = negrate;
+   sink->randseed = randseed;
+   sink->pos.maxgroups = maxposgroups;
+   sink->neg.maxgroups = maxneggroups;
+
+   if( maxposgroups > 0 )
+   {
+      SCIP_ALLOC( BMSallocMemoryArray(&sink->pos.groups, maxposgroups) );
+      SCIPmemacctAlloc(SCIP_MEMCOMP_TRJ, (size_t)maxposgroups * sizeof(SCIP_TRJGROUP*));
+      sink->pos.groupssize = maxposgroups;
+   }
+   if( maxneggroups > 0 )
+   {
+      SCIP_ALLOC( BMSallocMemoryArray(&sink->neg.groups, maxneggroups) );
+      SCIPmemacctAlloc(SCIP_MEMCOMP_TRJ, (size_t)maxneggroups * sizeof(SCIP_TRJGROUP*));
+      sink->neg.groupssize = maxneggroups;
+   }
+
+   return SCIP_OKAY;
+}
+
+/** close the trajectory sink */
+SCIP_RETCODE SCIPtrjsinkFree(
+   SCIP*              scip,
+   SCIP_TRJSINK**     sink
+   )
+{
+   SCIP_Longint start;
+
+   assert(scip != NULL);
+   assert(sink != NULL);
+   assert(*sink != NULL);
+
+   start = SCIPprofileStart();
+
+   SCIP_CALL( flushReservoirs(scip, *sink) );
+
+   SCIPdebugMessage("trajectory sink: %"SCIP_LONGINT_FORMAT" of %"SCIP_LONGINT_FORMAT" groups written, "
+      "%"SCIP_LONGINT_FORMAT" node rows for %"SCIP_LONGINT_FORMAT" node references\n",
+      (*sink)->nwrittengroups, (*sink)->ngroups, (*sink)->nrows, (*sink)->nrefs);
+
+   if( (*sink)->writer != NULL )
+   {
+      SCIPmemacctFree(SCIP_MEMCOMP_TRJ, (size_t)(*sink)->writer->nbuffers * (size_t)(*sink)->writer->buffersize);
+      SCIP_CALL( SCIPaiowriterFree(&(*sink)->writer) );
+   }
+   else
+      fclose((*sink)->file);
+
+   /* the span covers the sampled groups and draining the asynchronous writer */
+   SCIPchrometraceSpan("trjflush", start, SCIPprofileStart());
+
+   SCIPmemacctFree(SCIP_MEMCOMP_TRJ, (size_t)((*sink)->pos.groupssize + (*sink)->neg.groupssize) * sizeof(SCIP_TRJGROUP*)
+      + (size_t)(*sink)->groupnodessize * (sizeof(int) + rowSize(*sink) * sizeof(SCIP_Real))
+      + sizeof(SCIP_TRJSINK) + (size_t)(*sink)->size * (sizeof(SCIP_Real) + sizeof(SCIP_Bool)));
+   if( (*sink)->rowhashes != NULL )
+      SCIPmemacctFree(SCIP_MEMCOMP_NODEDATA, (size_t)(*sink)->rowhashessize * sizeof(uint64_t));
+   BMSfreeMemoryArrayNull(&(*sink)->pos.groups);
+   BMSfreeMemoryArrayNull(&(*sink)->neg.groups);
+   BMSfreeMemoryArrayNull(&(*sink)->rowhashes);
+   BMSfreeMemoryArrayNull(&(*sink)->groupnodes);
+   BMSfreeMemoryArrayNull(&(*sink)->grouprows);
+   BMSfreeMemoryArray(&(*sink)->globalvals);
+   BMSfreeMemoryArray(&(*sink)->isglobal);
+   SCIPfreeBlockMemory(scip, sink);
+
+   return SCIP_OKAY;
+}
+
+/** start a new group (one priority queue snapshot) */
+void SCIPtrjsinkBeginGroup(
+   SCIP_TRJSINK*      sink,
+   int                groupidx
+   )
+{
+   assert(sink != NULL);
+
+   sink->groupidx = groupidx;
+   sink->ngroupnodes = 0;
+   sink->grouphasopt = FALSE;
+}
+
+/** add a node and its features to the current group */
+SCIP_RETCODE SCIPtrjsinkAddNode(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   SCIP_FEAT*         feat,
+   int                nodeidx,
+   SCIP_Bool          isopt
+   )
+{
+   SCIP_Real* row;
+   int i;
+
+   assert(scip != NULL);
+   assert(sink != NULL);
+   assert(feat != NULL);
+   assert(feat->size == sink->size);
+   assert(nodeidx >= 0);
+
+   /* group-wide values are taken from the first node of the group */
+   if( sink->ngroupnodes == 0 )
+   {
+      for( i = 0; i < sink->size; i++ )
+         sink->globalvals[i] = feat->vals[i];
+   }
+
+   if( sink->ngroupnodes >= sink->groupnodessize )
+   {
+      int newsize = SCIPcalcMemGrowSize(scip, sink->ngroupnodes + 1);
+
+      SCIP_ALLOC( BMSreallocMemoryArray(&sink->groupnodes, newsize) );
+      SCIP_ALLOC( BMSreallocMemoryArray(&sink->grouprows, newsize * rowSize(sink)) );
+      SCIPmemacctRealloc(SCIP_MEMCOMP_TRJ, (size_t)sink->groupnodessize * (sizeof(int) + rowSize(sink) * sizeof(SCIP_Real)),
+         (size_t)newsize * (sizeof(int) + rowSize(sink) * sizeof(SCIP_Real)));
+      sink->groupnodessize = newsize;
+   }
+
+   row = &sink->grouprows[sink->ngroupnodes * rowSize(sink)];
+   BMScopyMemoryArray(row, feat->vals, sink->size);
+   row[sink->size + ROW_LABEL] = isopt ? 1.0 : 0.0;
+   row[sink->size + ROW_WEIGHT] = SCIPfeatGetWeight(feat);
+   row[sink->size + ROW_DEPTHBUCKET] = SCIPfeatGetDepthBucket(feat);
+   row[sink->size + ROW_BOUNDTYPE] = (SCIP_Real)feat->boundtype;
+   sink->groupnodes[sink->ngroupnodes] = nodeidx;
+   sink->ngroupnodes++;
+   sink->grouphasopt = sink->grouphasopt || isopt;
+
+   return SCIP_OKAY;
+}
+
+/** finish the current group: write it directly or offer it to the sampler */
+SCIP_RETCODE SCIPtrjsinkEndGroup(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink
+   )
+{
+   SCIP_TRJRESERVOIR* reservoir;
+
+   assert(scip != NULL);
+   assert(sink != NULL);
+
+   if( sink->ngroupnodes == 0 )
+      return SCIP_OKAY;
+
+   sink->ngroups++;
+
+   /* pure-negative groups are thinned at a fixed rate, groups with an optimal node are always offered */
+   if( !sink->grouphasopt && sink->negrate < 1.0 && SCIPgetRandomReal(0.0, 1.0, &sink->randseed) >= sink->negrate )
+   {
+      sink->ngroupnodes = 0;
+      return SCIP_OKAY;
+   }
+
+   /* a class without a budget keeps all its groups, so they are written right away instead of buffered */
+   reservoir = sink->grouphasopt ? &sink->pos : &sink->neg;
+   if( sink->sampling && reservoir->maxgroups > 0 )
+   {
+      SCIP_CALL( reservoirOffer(scip, sink, reservoir) );
+   }
+   else
+   {
+      SCIP_Longint start = SCIPprofileStart();
+
+      SCIP_CALL( writeGroup(scip, sink, sink->groupidx, sink->groupnodes, sink->grouprows, sink->globalvals,
+            sink->ngroupnodes) );
+      SCIPchrometraceSpan("trjwrite", start, SCIPprofileStart());
+   }
+
+   sink->ngroupnodes = 0;
+
+   return SCIP_OKAY;
+}
+
+/** number of trajectory bytes written so far (for the asynchronous writer: handed to the kernel) */
+SCIP_Longint SCIPtrjsinkGetNBytes(
+   SCIP_TRJSINK*      sink
+   )
+{
+   assert(sink != NULL);
+
+   return sink->writer != NULL ? sink->writer->nbytes : sink->nbytes;
+}
@@ -0,0 +1,88 @@
+/**@file   trjsink.h
+ * @brief  internal methods for trajectory sinks
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_TRJSINK_H__
+#define __SCIP_TRJSINK_H__
+
+#include "scip/def.h"
+#include "scip/scip.h"
+#include "feat.h"
+#include "struct_trjsink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** open a trajectory sink appending to the given file */
+extern
+SCIP_RETCODE SCIPtrjsinkCreate(
+   SCIP*              scip,
+   SCIP_TRJSINK**     sink,
+   const char*        fname,
+   int                size,               /**< feature size */
+   SCIP_Bool          dedup,              /**< write node-deduplicated groups? */
+   SCIP_Bool          useaio              /**< write through an asynchronous writer (io_uring on Linux)? */
+   );
+
+/** set the group sampling of the sink
+ *
+ *  Groups containing an optimal node and pure-negative groups are sampled into separate reservoirs of the given
+ *  budgets (0: keep all); pure-negative groups are first kept only at rate negrate. The groups of a class with a
+ *  budget are buffered and written in group order when the sink is closed; the groups of a class without one are
+ *  written as they end, so the two classes are not in one group order in the file.
+ */
+extern
+SCIP_RETCODE SCIPtrjsinkSetSampling(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   int                maxposgroups,       /**< budget for groups containing an optimal node (0: no limit) */
+   int                maxneggroups,       /**< budget for pure-negative groups (0: no limit) */
+   SCIP_Real          negrate,            /**< rate at which pure-negative groups are kept */
+   unsigned int       randseed
+   );
+
+/** close the trajectory sink, writing buffered groups */
+extern
+SCIP_RETCODE SCIPtrjsinkFree(
+   SCIP*              scip,
+   SCIP_TRJSINK**     sink
+   );
+
+/** start a new group (one priority queue snapshot) */
+extern
+void SCIPtrjsinkBeginGroup(
+   SCIP_TRJSINK*      sink,
+   int                groupidx
+   );
+
+/** add a node and its features to the current group */
+extern
+SCIP_RETCODE SCIPtrjsinkAddNode(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink,
+   SCIP_FEAT*         feat,
+   int                nodeidx,
+   SCIP_Bool          isopt               /**< is the node on the path to the optimal solution? */
+   );
+
+/** finish the current group: write it directly or offer it to the sampler */
+extern
+SCIP_RETCODE SCIPtrjsinkEndGroup(
+   SCIP*              scip,
+   SCIP_TRJSINK*      sink
+   );
+
+/** number of trajectory bytes written so far (for the asynchronous writer: handed to the kernel) */
+extern
+SCIP_Longint SCIPtrjsinkGetNBytes(
+   SCIP_TRJSINK*      sink
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,3 +4,5 @@ int TYPE_TWODOUBLES = 2;
 int TYPE_ARRAY = 3;
 int TYPE_DOUBLEANDARRAY = 4;
 int TYPE_ONEDOUBLE = 5;
+int TYPE_ASYNCARRAY = 6;
+int TYPE_PRUNEARRAY = 7;